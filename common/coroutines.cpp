@@ -24,6 +24,7 @@
 #include "common/debug.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "common/memorypool.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 
@@ -71,6 +72,62 @@ static void displayCoroStats() {
 } // End of anonymous namespace
 #endif
 
+namespace {
+
+enum {
+	/** Chunk size of the smallest context pool */
+	CORO_POOL_MIN_CHUNK = 32,
+	/** Number of context pools, each doubling the chunk size of the previous one */
+	CORO_POOL_COUNT = 5
+};
+
+/**
+ * Memory pools for coroutine contexts. Like the scheduler itself, these
+ * are created on first use and live until the program exits.
+ */
+static MemoryPool *s_contextPools[CORO_POOL_COUNT];
+
+/**
+ * Return the index of the pool serving allocations of the given size,
+ * or -1 if the size is too large to be pooled.
+ */
+static int contextPoolIndex(size_t size) {
+	size_t chunkSize = CORO_POOL_MIN_CHUNK;
+	for (int i = 0; i < CORO_POOL_COUNT; ++i, chunkSize *= 2) {
+		if (size <= chunkSize)
+			return i;
+	}
+
+	return -1;
+}
+
+} // End of anonymous namespace
+
+void *CoroBaseContext::operator new(size_t size) {
+	int idx = contextPoolIndex(size);
+	if (idx < 0)
+		return ::operator new(size);
+
+	if (!s_contextPools[idx])
+		s_contextPools[idx] = new MemoryPool(CORO_POOL_MIN_CHUNK << idx);
+
+	return s_contextPools[idx]->allocChunk();
+}
+
+void CoroBaseContext::operator delete(void *ptr, size_t size) {
+	if (!ptr)
+		return;
+
+	int idx = contextPoolIndex(size);
+	if (idx < 0) {
+		::operator delete(ptr);
+		return;
+	}
+
+	assert(s_contextPools[idx]);
+	s_contextPools[idx]->freeChunk(ptr);
+}
+
 CoroBaseContext::CoroBaseContext(const char *func)
 	: _line(0), _sleep(0), _subctx(nullptr) {
 #ifdef COROUTINE_DEBUG
@@ -133,6 +190,7 @@ CoroutineScheduler::~CoroutineScheduler() {
 	Common::List<EVENT *>::iterator i;
 	for (i = _events.begin(); i != _events.end(); ++i)
 		delete *i;
+	_eventMap.clear();
 }
 
 void CoroutineScheduler::reset() {
@@ -165,6 +223,7 @@ void CoroutineScheduler::reset() {
 
 	// no active processes
 	pCurrent = active->pNext = nullptr;
+	_pidCount.clear();
 
 	// place first process on free list
 	pFreeProcesses = processList;
@@ -347,7 +406,7 @@ void CoroutineScheduler::waitForSingleObject(CORO_PARAM, int pid, uint32 duratio
 
 	CORO_BEGIN_CONTEXT;
 		uint32 endTime;
-		PROCESS *pProcess;
+		bool processActive;
 		EVENT *pEvent;
 	CORO_END_CONTEXT(_ctx);
 
@@ -364,12 +423,12 @@ void CoroutineScheduler::waitForSingleObject(CORO_PARAM, int pid, uint32 duratio
 	// Outer loop for doing checks until expiry
 	while (g_system->getMillis() <= _ctx->endTime) {
 		// Check to see if a process or event with the given Id exists
-		_ctx->pProcess = getProcess(pid);
-		_ctx->pEvent = !_ctx->pProcess ? getEvent(pid) : nullptr;
+		_ctx->processActive = isProcessActive(pid);
+		_ctx->pEvent = !_ctx->processActive ? getEvent(pid) : nullptr;
 
 		// If there's no active process or event, presume it's a process that's finished,
 		// so the waiting can immediately exit
-		if ((_ctx->pProcess == nullptr) && (_ctx->pEvent == nullptr)) {
+		if (!_ctx->processActive && (_ctx->pEvent == nullptr)) {
 			if (expired)
 				*expired = false;
 			break;
@@ -407,7 +466,7 @@ void CoroutineScheduler::waitForMultipleObjects(CORO_PARAM, int nCount, uint32 *
 		bool signalled;
 		bool pidSignalled;
 		int i;
-		PROCESS *pProcess;
+		bool processActive;
 		EVENT *pEvent;
 	CORO_END_CONTEXT(_ctx);
 
@@ -427,11 +486,11 @@ void CoroutineScheduler::waitForMultipleObjects(CORO_PARAM, int nCount, uint32 *
 		_ctx->signalled = bWaitAll;
 
 		for (_ctx->i = 0; _ctx->i < nCount; ++_ctx->i) {
-			_ctx->pProcess = getProcess(pidList[_ctx->i]);
-			_ctx->pEvent = !_ctx->pProcess ? getEvent(pidList[_ctx->i]) : nullptr;
+			_ctx->processActive = isProcessActive(pidList[_ctx->i]);
+			_ctx->pEvent = !_ctx->processActive ? getEvent(pidList[_ctx->i]) : nullptr;
 
 			// Determine the signalled state
-			_ctx->pidSignalled = (_ctx->pProcess) || !_ctx->pEvent ? false : _ctx->pEvent->signalled;
+			_ctx->pidSignalled = _ctx->processActive || !_ctx->pEvent ? false : _ctx->pEvent->signalled;
 
 			if (bWaitAll && !_ctx->pidSignalled)
 				_ctx->signalled = false;
@@ -538,6 +597,7 @@ PROCESS *CoroutineScheduler::createProcess(uint32 pid, CORO_ADDR coroAddr, const
 
 	// set new process id
 	pProc->pid = pid;
+	_pidCount[pid]++;
 
 	// set new process specific info
 	if (sizeParam) {
@@ -573,6 +633,8 @@ void CoroutineScheduler::killProcess(PROCESS *pKillProc) {
 	assert(numProcs >= 0);
 #endif
 
+	releasePid(pKillProc->pid);
+
 	// Free process' resources
 	if (pRCfunction != nullptr)
 		(pRCfunction)(pKillProc);
@@ -613,6 +675,10 @@ int CoroutineScheduler::killMatchingProcess(uint32 pidKill, int pidMask) {
 	int numKilled = 0;
 	PROCESS *pProc, *pPrev; // process list pointers
 
+	// Without a mask, there is nothing to kill unless the process ID is in use
+	if (pidMask == -1 && !isProcessActive(pidKill))
+		return 0;
+
 	for (pProc = active->pNext, pPrev = active; pProc != nullptr; pPrev = pProc, pProc = pProc->pNext) {
 		if ((pProc->pid & (uint32)pidMask) == pidKill) {
 			// found a matching process
@@ -621,6 +687,7 @@ int CoroutineScheduler::killMatchingProcess(uint32 pidKill, int pidMask) {
 			if (pProc != pCurrent) {
 				// kill this process
 				numKilled++;
+				releasePid(pProc->pid);
 
 				// Free the process' resources
 				if (pRCfunction != nullptr)
@@ -663,6 +730,9 @@ void CoroutineScheduler::setResourceCallback(VFPTRPP pFunc) {
 }
 
 PROCESS *CoroutineScheduler::getProcess(uint32 pid) {
+	if (!isProcessActive(pid))
+		return nullptr;
+
 	PROCESS *pProc = active->pNext;
 	while ((pProc != nullptr) && (pProc->pid != pid))
 		pProc = pProc->pNext;
@@ -671,14 +741,20 @@ PROCESS *CoroutineScheduler::getProcess(uint32 pid) {
 }
 
 EVENT *CoroutineScheduler::getEvent(uint32 pid) {
-	Common::List<EVENT *>::iterator i;
-	for (i = _events.begin(); i != _events.end(); ++i) {
-		EVENT *evt = *i;
-		if (evt->pid == pid)
-			return evt;
-	}
+	EventMap::const_iterator i = _eventMap.find(pid);
+	return (i != _eventMap.end()) ? i->_value : nullptr;
+}
+
+bool CoroutineScheduler::isProcessActive(uint32 pid) const {
+	return _pidCount.contains(pid);
+}
+
+void CoroutineScheduler::releasePid(uint32 pid) {
+	PidCountMap::iterator i = _pidCount.find(pid);
+	assert(i != _pidCount.end());
 
-	return nullptr;
+	if (--i->_value == 0)
+		_pidCount.erase(i);
 }
 
 
@@ -690,6 +766,7 @@ uint32 CoroutineScheduler::createEvent(bool bManualReset, bool bInitialState) {
 	evt->pulsing = false;
 
 	_events.push_back(evt);
+	_eventMap[evt->pid] = evt;
 	return evt->pid;
 }
 
@@ -697,6 +774,7 @@ void CoroutineScheduler::closeEvent(uint32 pidEvent) {
 	EVENT *evt = getEvent(pidEvent);
 	if (evt) {
 		_events.remove(evt);
+		_eventMap.erase(pidEvent);
 		delete evt;
 	}
 }
@@ -24,6 +24,7 @@
 
 #include "common/scummsys.h"
 #include "common/util.h"    // for SCUMMVM_CURRENT_FUNCTION
+#include "common/hashmap.h"
 #include "common/list.h"
 #include "common/singleton.h"
 
@@ -67,6 +68,14 @@ struct CoroBaseContext {
 	 * Destructor for coroutine context.
 	 */
 	virtual ~CoroBaseContext();
+
+	/**
+	 * Contexts are created and destroyed at a high rate, so they are
+	 * allocated from a set of size-segregated memory pools rather than
+	 * through the general purpose heap.
+	 */
+	static void *operator new(size_t size);
+	static void operator delete(void *ptr, size_t size);
 };
 
 typedef CoroBaseContext *CoroContext;
@@ -364,6 +373,15 @@ private:
 	/** Event list. */
 	Common::List<EVENT *> _events;
 
+	typedef Common::HashMap<uint32, EVENT *> EventMap;
+	typedef Common::HashMap<uint32, int> PidCountMap;
+
+	/** Events indexed by their ID, mirrors _events. */
+	EventMap _eventMap;
+
+	/** Number of active processes using each process ID. */
+	PidCountMap _pidCount;
+
 #ifdef DEBUG
 	/** Diagnostic process counters. */
 	int numProcs;
@@ -384,6 +402,16 @@ private:
 
 	PROCESS *getProcess(uint32 pid);
 	EVENT *getEvent(uint32 pid);
+
+	/**
+	 * Return whether any active process uses the given process ID.
+	 */
+	bool isProcessActive(uint32 pid) const;
+
+	/**
+	 * Drop a process ID from the active process ID counts.
+	 */
+	void releasePid(uint32 pid);
 public:
 	/**
 	 * Kill all processes and place them on the free list.
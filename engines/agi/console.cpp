@@ -22,6 +22,7 @@
 #include "agi/agi.h"
 #include "agi/opcodes.h"
 #include "agi/graphics.h"
+#include "agi/sprite.h"
 
 #include "agi/preagi/preagi.h"
 #include "agi/preagi/mickey.h"
@@ -54,6 +55,10 @@ Console::Console(AgiEngine *vm) : GUI::Debugger() {
 	registerCmd("vmvars",          WRAP_METHOD(Console, Cmd_VmVars));
 	registerCmd("vmflags",         WRAP_METHOD(Console, Cmd_VmFlags));
 	registerCmd("disableautosave", WRAP_METHOD(Console, Cmd_DisableAutomaticSave));
+#ifndef RELEASE_BUILD
+	registerCmd("picbench",        WRAP_METHOD(Console, Cmd_PictureBench));
+#endif
+	registerCmd("spriteStats",     WRAP_METHOD(Console, Cmd_SpriteStats));
 }
 
 bool Console::Cmd_SetVar(int argc, const char **argv) {
@@ -606,6 +611,60 @@ bool Console::Cmd_DisableAutomaticSave(int argc, const char **argv) {
 	return true;
 }
 
+#ifndef RELEASE_BUILD
+bool Console::Cmd_PictureBench(int argc, const char **argv) {
+	if (argc != 1) {
+		debugPrintf("Draws all the pictures of the game with the original fill, the span fill and from the cache\n");
+		debugPrintf("Usage: %s\n", argv[0]);
+		return true;
+	}
+
+	bool loaded[MAX_DIRECTORY_ENTRIES];
+	for (int resourceNr = 0; resourceNr < MAX_DIRECTORY_ENTRIES; resourceNr++) {
+		AgiDir &dir = _vm->_game.dirPic[resourceNr];
+		loaded[resourceNr] = (dir.flags & RES_LOADED) != 0;
+		if (!loaded[resourceNr] && dir.offset != _EMPTY)
+			_vm->agiLoadResource(RESOURCETYPE_PICTURE, resourceNr);
+	}
+
+	int count;
+	uint32 referenceTime, time, cachedTime;
+	int mismatches = _vm->_picture->benchmarkPictures(count, referenceTime, time, cachedTime);
+
+	for (int resourceNr = 0; resourceNr < MAX_DIRECTORY_ENTRIES; resourceNr++) {
+		if (!loaded[resourceNr])
+			_vm->agiUnloadResource(RESOURCETYPE_PICTURE, resourceNr);
+	}
+
+	debugPrintf("%d pictures, %d differ from the original drawing\n", count, mismatches);
+	debugPrintf("original fill: %d ms, span fill: %d ms, cached: %d ms\n", referenceTime, time, cachedTime);
+	return true;
+}
+#endif
+
+bool Console::Cmd_SpriteStats(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "on") && strcmp(argv[1], "off") && strcmp(argv[1], "reset"))) {
+		debugPrintf("Shows how many sprites had to be drawn again during the incremental updates\n");
+		debugPrintf("With 'on' every update is compared against a full rebuild of the sprites\n");
+		debugPrintf("Usage: %s [on | off | reset]\n", argv[0]);
+		return true;
+	}
+
+	if (argc == 2) {
+		if (!strcmp(argv[1], "reset"))
+			_vm->_sprites->resetStats();
+		else
+			_vm->_sprites->setVerifyUpdates(!strcmp(argv[1], "on"));
+	}
+
+	const SpriteStats &stats = _vm->_sprites->getStats();
+	debugPrintf("%d updates, %d sprites, %d drawn again\n", stats.updates, stats.sprites, stats.redrawn);
+	if (_vm->_sprites->getVerifyUpdates() || stats.mismatches)
+		debugPrintf("%d updates differed from a full rebuild\n", stats.mismatches);
+	debugPrintf("Verification is %s\n", _vm->_sprites->getVerifyUpdates() ? "on" : "off");
+	return true;
+}
+
 bool Console::parseInteger(const char *argument, int &result) {
 	char *endPtr = nullptr;
 	int idxLen = strlen(argument);
@@ -66,6 +66,10 @@ private:
 	bool Cmd_VmVars(int argc, const char **argv);
 	bool Cmd_VmFlags(int argc, const char **argv);
 	bool Cmd_DisableAutomaticSave(int argc, const char **argv);
+#ifndef RELEASE_BUILD
+	bool Cmd_PictureBench(int argc, const char **argv);
+#endif
+	bool Cmd_SpriteStats(int argc, const char **argv);
 
 	bool parseInteger(const char *argument, int &result);
 
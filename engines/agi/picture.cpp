@@ -45,6 +45,10 @@ PictureMgr::PictureMgr(AgiBase *agi, GfxMgr *gfx) {
 	_currentStep = 0;
 
 	_width = _height = 0;
+
+#ifndef RELEASE_BUILD
+	_referenceFill = false;
+#endif
 }
 
 void PictureMgr::putVirtPixel(int x, int y) {
@@ -834,6 +838,93 @@ void PictureMgr::draw_Fill() {
 }
 
 void PictureMgr::draw_Fill(int16 x, int16 y) {
+#ifndef RELEASE_BUILD
+	if (_referenceFill) {
+		draw_FillReference(x, y);
+		return;
+	}
+#endif
+
+	if (!_scrOn && !_priOn)
+		return;
+
+	// Same tests as draw_FillCheck, as a table of the fillable values
+	byte *visual = _gfx->getGameScreen() + _yOffset * SCRIPT_WIDTH + _xOffset;
+	byte *priority = _gfx->getPriorityScreen() + _yOffset * SCRIPT_WIDTH + _xOffset;
+	const byte *check;
+	bool fillable[256];
+
+	if (_flags & kPicFTrollMode) {
+		// Without visual drawing, the filled pixels would stay fillable
+		if (!_scrOn)
+			return;
+
+		check = visual;
+		for (int i = 0; i < 256; i++)
+			fillable[i] = (i != 11) && (i != _scrColor);
+	} else if (_scrOn && _scrColor != 15) {
+		check = visual;
+		for (int i = 0; i < 256; i++)
+			fillable[i] = (i == 15);
+	} else if (_priOn && !_scrOn && _priColor != 4) {
+		check = priority;
+		for (int i = 0; i < 256; i++)
+			fillable[i] = (i == 4);
+	} else {
+		return;
+	}
+
+	// Filled pixels never pass the test again, so the filled area is the
+	// connected area around the start point, whatever the order of the spans
+	Common::Stack<Common::Point> stack;
+	stack.push(Common::Point(x, y));
+
+	while (!stack.empty()) {
+		Common::Point p = stack.pop();
+
+		if (p.x < 0 || p.x >= _width || p.y < 0 || p.y >= _height)
+			continue;
+
+		int offset = p.y * SCRIPT_WIDTH;
+		if (!fillable[check[offset + p.x]])
+			continue;
+
+		int left = p.x;
+		int right = p.x;
+		while (left > 0 && fillable[check[offset + left - 1]])
+			left--;
+		while (right < _width - 1 && fillable[check[offset + right + 1]])
+			right++;
+
+		if (_scrOn)
+			memset(visual + offset + left, _scrColor, right - left + 1);
+		if (_priOn)
+			memset(priority + offset + left, _priColor, right - left + 1);
+
+		// Push the start of every fillable span above and below
+		for (int nextY = p.y - 1; nextY <= p.y + 1; nextY += 2) {
+			if (nextY < 0 || nextY >= _height)
+				continue;
+
+			const byte *nextRow = check + nextY * SCRIPT_WIDTH;
+			bool newSpan = true;
+			for (int c = left; c <= right; c++) {
+				if (fillable[nextRow[c]]) {
+					if (newSpan) {
+						stack.push(Common::Point(c, nextY));
+						newSpan = false;
+					}
+				} else {
+					newSpan = true;
+				}
+			}
+		}
+	}
+}
+
+#ifndef RELEASE_BUILD
+// The original fill, pixel by pixel
+void PictureMgr::draw_FillReference(int16 x, int16 y) {
 	if (!_scrOn && !_priOn)
 		return;
 
@@ -902,6 +993,7 @@ int PictureMgr::draw_FillCheck(int16 x, int16 y) {
 
 	return (_scrOn && screenColor == 15 && _scrColor != 15);
 }
+#endif
 
 /**
  * Decode an AGI picture resource.
@@ -915,6 +1007,16 @@ int PictureMgr::draw_FillCheck(int16 x, int16 y) {
 int PictureMgr::decodePicture(int16 resourceNr, bool clearScreen, bool agi256, int16 pic_width, int16 pic_height) {
 	debugC(8, kDebugLevelResources, "(%d)", resourceNr);
 
+	drawPictureResource(resourceNr, clearScreen, agi256, pic_width, pic_height);
+
+	if (clearScreen)
+		_vm->clearImageStack();
+	_vm->recordImageStackCall(ADD_PIC, resourceNr, clearScreen, agi256, 0, 0, 0, 0);
+
+	return errOK;
+}
+
+void PictureMgr::drawPictureResource(int16 resourceNr, bool clearScreen, bool agi256, int16 pic_width, int16 pic_height) {
 	_patCode = 0;
 	_patNum = 0;
 	_priOn = _scrOn = false;
@@ -934,18 +1036,126 @@ int PictureMgr::decodePicture(int16 resourceNr, bool clearScreen, bool agi256, i
 		_gfx->clear(15, 4); // Clear 16 color AGI screen (Priority 4, color white).
 	}
 
-	if (!agi256) {
-		drawPicture(); // Draw 16 color picture.
-	} else {
+	if (agi256) {
 		drawPictureAGI256();
+		return;
 	}
 
-	if (clearScreen)
-		_vm->clearImageStack();
-	_vm->recordImageStackCall(ADD_PIC, resourceNr, clearScreen, agi256, 0, 0, 0, 0);
+	// A picture drawn on a cleared screen only depends on its data
+	bool useCache = clearScreen && _data && (_flags == 0) &&
+	                (_xOffset == 0) && (_yOffset == 0) && (_width == SCRIPT_WIDTH) && (_height == SCRIPT_HEIGHT);
+#ifndef RELEASE_BUILD
+	useCache = useCache && !_referenceFill;
+#endif
 
-	return errOK;
+	if (useCache && restoreCachedPicture())
+		return;
+
+	drawPicture(); // Draw 16 color picture.
+
+	if (useCache)
+		cachePicture();
+}
+
+bool PictureMgr::restoreCachedPicture() {
+	for (Common::List<CachedPicture>::iterator it = _cache.begin(); it != _cache.end(); ++it) {
+		if (it->resourceNr != _resourceNr)
+			continue;
+
+		if (it->data.size() != _dataSize || memcmp(it->data.data(), _data, _dataSize)) {
+			// The resource changed, draw it again
+			_cache.erase(it);
+			return false;
+		}
+
+		_gfx->block_restore(0, 0, SCRIPT_WIDTH, SCRIPT_HEIGHT, it->screens.data());
+
+		if (it != _cache.begin()) {
+			_cache.push_front(*it);
+			_cache.erase(it);
+		}
+		return true;
+	}
+
+	return false;
+}
+
+void PictureMgr::cachePicture() {
+	if (_cache.size() >= kPictureCacheSize)
+		_cache.pop_back();
+
+	_cache.push_front(CachedPicture());
+	CachedPicture &entry = _cache.front();
+	entry.resourceNr = _resourceNr;
+	entry.data.resize(_dataSize);
+	memcpy(entry.data.data(), _data, _dataSize);
+	entry.screens.resize(SCRIPT_WIDTH * SCRIPT_HEIGHT * 2);
+	_gfx->block_save(0, 0, SCRIPT_WIDTH, SCRIPT_HEIGHT, entry.screens.data());
+}
+
+void PictureMgr::flushCache() {
+	_cache.clear();
+}
+
+#ifndef RELEASE_BUILD
+int PictureMgr::benchmarkPictures(int &count, uint32 &referenceTime, uint32 &time, uint32 &cachedTime) {
+	const uint screensSize = SCRIPT_WIDTH * SCRIPT_HEIGHT * 2;
+	Common::Array<byte> savedScreens(screensSize), reference(screensSize), result(screensSize);
+
+	// Keep the game screens and the current picture
+	_gfx->block_save(0, 0, SCRIPT_WIDTH, SCRIPT_HEIGHT, savedScreens.data());
+	int16 savedResourceNr = _resourceNr;
+	uint8 *savedData = _data;
+	uint32 savedDataSize = _dataSize;
+	int16 savedWidth = _width;
+	int16 savedHeight = _height;
+
+	int mismatches = 0;
+	count = 0;
+	referenceTime = time = cachedTime = 0;
+	flushCache();
+
+	for (int16 resourceNr = 0; resourceNr < MAX_DIRECTORY_ENTRIES; resourceNr++) {
+		AgiDir &dir = _vm->_game.dirPic[resourceNr];
+		if (!(dir.flags & RES_LOADED) || dir.len == 0)
+			continue;
+
+		uint32 startTime = g_system->getMillis();
+		_referenceFill = true;
+		drawPictureResource(resourceNr, true, false, _DEFAULT_WIDTH, _DEFAULT_HEIGHT);
+		_referenceFill = false;
+		referenceTime += g_system->getMillis() - startTime;
+		_gfx->block_save(0, 0, SCRIPT_WIDTH, SCRIPT_HEIGHT, reference.data());
+
+		startTime = g_system->getMillis();
+		drawPictureResource(resourceNr, true, false, _DEFAULT_WIDTH, _DEFAULT_HEIGHT);
+		time += g_system->getMillis() - startTime;
+		_gfx->block_save(0, 0, SCRIPT_WIDTH, SCRIPT_HEIGHT, result.data());
+		bool identical = (reference == result);
+
+		startTime = g_system->getMillis();
+		drawPictureResource(resourceNr, true, false, _DEFAULT_WIDTH, _DEFAULT_HEIGHT);
+		cachedTime += g_system->getMillis() - startTime;
+		_gfx->block_save(0, 0, SCRIPT_WIDTH, SCRIPT_HEIGHT, result.data());
+		identical = identical && (reference == result);
+
+		if (!identical) {
+			debugC(1, kDebugLevelResources, "Picture %d differs from the original drawing", resourceNr);
+			mismatches++;
+		}
+		count++;
+	}
+
+	_gfx->block_restore(0, 0, SCRIPT_WIDTH, SCRIPT_HEIGHT, savedScreens.data());
+	_resourceNr = savedResourceNr;
+	_data = savedData;
+	_dataSize = savedDataSize;
+	_width = savedWidth;
+	_height = savedHeight;
+
+	return mismatches;
 }
+#endif
 
 /**
  * Decode an AGI picture resource.
@@ -1065,6 +1275,7 @@ void PictureMgr::setPattern(uint8 code, uint8 num) {
 
 void PictureMgr::setPictureVersion(AgiPictureVersion version) {
 	_pictureVersion = version;
+	flushCache();
 
 	if (version == AGIPIC_C64)
 		_minCommand = 0xe0;
@@ -22,6 +22,9 @@
 #ifndef AGI_PICTURE_H
 #define AGI_PICTURE_H
 
+#include "common/array.h"
+#include "common/list.h"
+
 namespace Agi {
 
 #define _DEFAULT_WIDTH      160
@@ -103,10 +106,17 @@ private:
 	void draw_LineShort();
 	void draw_LineAbsolute();
 
-	int  draw_FillCheck(int16 x, int16 y);
 	void draw_Fill(int16 x, int16 y);
+#ifndef RELEASE_BUILD
+	int  draw_FillCheck(int16 x, int16 y);
+	void draw_FillReference(int16 x, int16 y);
+#endif
 	void draw_Fill();
 
+	void drawPictureResource(int16 resourceNr, bool clearScreen, bool agi256, int16 pic_width, int16 pic_height);
+	bool restoreCachedPicture();
+	void cachePicture();
+
 public:
 	void showPic(); // <-- for regular AGI games
 	void showPic(int16 x, int16 y, int16 pic_width, int16 pic_height); // <-- for preAGI games
@@ -123,6 +133,18 @@ public:
 
 	void clear();
 
+	/** Forget all the rendered pictures. */
+	void flushCache();
+
+#ifndef RELEASE_BUILD
+	/**
+	 * Draw all the loaded pictures with the original fill, with the span fill
+	 * and from the cache, and check that the results are identical.
+	 * @return number of pictures which differ
+	 */
+	int benchmarkPictures(int &count, uint32 &referenceTime, uint32 &time, uint32 &cachedTime);
+#endif
+
 	void setOffset(int offX, int offY) {
 		_xOffset = offX;
 		_yOffset = offY;
@@ -155,6 +177,26 @@ private:
 
 	int _flags;
 	int _currentStep;
+
+#ifndef RELEASE_BUILD
+	bool _referenceFill;
+#endif
+
+	enum {
+		kPictureCacheSize = 16
+	};
+
+	/** Visual and priority screens of a picture drawn on a cleared screen. */
+	struct CachedPicture {
+		int16 resourceNr;
+		/** The picture data it was drawn from */
+		Common::Array<byte> data;
+		/** Screens, in the format of GfxMgr::block_save */
+		Common::Array<byte> screens;
+	};
+
+	/** Most recently used first */
+	Common::List<CachedPicture> _cache;
 };
 
 } // End of namespace Agi
@@ -29,11 +29,12 @@ namespace Agi {
 SpritesMgr::SpritesMgr(AgiEngine *agi, GfxMgr *gfx) {
 	_vm = agi;
 	_gfx = gfx;
+	_verifyUpdates = false;
+	resetStats();
 }
 
 SpritesMgr::~SpritesMgr() {
-	_spriteRegularList.clear();
-	_spriteStaticList.clear();
+	freeAllSprites();
 }
 
 static bool sortSpriteHelper(const Sprite &entry1, const Sprite &entry2) {
@@ -45,37 +46,52 @@ static bool sortSpriteHelper(const Sprite &entry1, const Sprite &entry2) {
 	return entry1.sortOrder < entry2.sortOrder;
 }
 
-void SpritesMgr::buildRegularSpriteList() {
+void SpritesMgr::buildSpriteList(SpriteList &spriteList, SpriteList &erasedList, uint32 wantedFlags, bool incremental) {
 	ScreenObjEntry *screenObj = nullptr;
 	uint16 givenOrderNr = 0;
 
-	freeList(_spriteRegularList);
+	freeList(spriteList);
+	_dirtyAreas.clear();
 	for (screenObj = _vm->_game.screenObjTable; screenObj < &_vm->_game.screenObjTable[SCREENOBJECTS_MAX]; screenObj++) {
-		if ((screenObj->flags & (fAnimated | fUpdate | fDrawn)) == (fAnimated | fUpdate | fDrawn)) {
-			buildSpriteListAdd(givenOrderNr, screenObj, _spriteRegularList);
+		if ((screenObj->flags & (fAnimated | fUpdate | fDrawn)) == wantedFlags) {
+			buildSpriteListAdd(givenOrderNr, screenObj, spriteList, erasedList, incremental);
 			givenOrderNr++;
 		}
 	}
 
-	// Now sort this list
-	Common::sort(_spriteRegularList.begin(), _spriteRegularList.end(), sortSpriteHelper);
+	// Sprites which are gone leave their area behind
+	for (uint i = 0; i < erasedList.size(); i++) {
+		const Sprite &sprite = erasedList[i];
+		_dirtyAreas.push_back(Common::Rect(sprite.xPos, sprite.yPos, sprite.xPos + sprite.xSize, sprite.yPos + sprite.ySize));
+	}
+	freeList(erasedList);
+
+	// Now sort this list. Insertion sort, as the sprites mostly keep their
+	// order from one cycle to the next one
+	for (uint i = 1; i < spriteList.size(); i++) {
+		if (!sortSpriteHelper(spriteList[i], spriteList[i - 1]))
+			continue;
+
+		Sprite sprite = spriteList[i];
+		uint j = i;
+		do {
+			spriteList[j] = spriteList[j - 1];
+			j--;
+		} while (j > 0 && sortSpriteHelper(sprite, spriteList[j - 1]));
+		spriteList[j] = sprite;
+	}
+
+	if (incremental)
+		markDependentSprites(spriteList);
+}
+
+void SpritesMgr::buildRegularSpriteList() {
+	buildSpriteList(_spriteRegularList, _spriteRegularErased, fAnimated | fUpdate | fDrawn, false);
 //	warning("buildRegular: %d", _spriteRegularList.size());
 }
 
 void SpritesMgr::buildStaticSpriteList() {
-	ScreenObjEntry *screenObj = nullptr;
-	uint16 givenOrderNr = 0;
-
-	freeList(_spriteStaticList);
-	for (screenObj = _vm->_game.screenObjTable; screenObj < &_vm->_game.screenObjTable[SCREENOBJECTS_MAX]; screenObj++) {
-		if ((screenObj->flags & (fAnimated | fUpdate | fDrawn)) == (fAnimated | fDrawn)) { // DIFFERENCE IN HERE!
-			buildSpriteListAdd(givenOrderNr, screenObj, _spriteStaticList);
-			givenOrderNr++;
-		}
-	}
-
-	// Now sort this list
-	Common::sort(_spriteStaticList.begin(), _spriteStaticList.end(), sortSpriteHelper);
+	buildSpriteList(_spriteStaticList, _spriteStaticErased, fAnimated | fDrawn, false); // DIFFERENCE IN HERE!
 }
 
 void SpritesMgr::buildAllSpriteLists() {
@@ -83,7 +99,7 @@ void SpritesMgr::buildAllSpriteLists() {
 	buildRegularSpriteList();
 }
 
-void SpritesMgr::buildSpriteListAdd(uint16 givenOrderNr, ScreenObjEntry *screenObj, SpriteList &spriteList) {
+void SpritesMgr::buildSpriteListAdd(uint16 givenOrderNr, ScreenObjEntry *screenObj, SpriteList &spriteList, SpriteList &erasedList, bool incremental) {
 	Sprite spriteEntry;
 
 	// Check, if screen object points to currently loaded view, if not don't add it
@@ -127,16 +143,136 @@ void SpritesMgr::buildSpriteListAdd(uint16 givenOrderNr, ScreenObjEntry *screenO
 		return;
 	}
 
+	spriteEntry.backgroundBuffer = nullptr;
+	spriteEntry.bufferSize = 0;
+	spriteEntry.celData = screenObj->celData;
+	spriteEntry.priority = screenObj->priority;
+	spriteEntry.viewHidden = true;
+	spriteEntry.redraw = true;
+
+	// Reuse the buffers of the sprite, that was erased for this screen object
+	for (uint i = 0; i < erasedList.size(); i++) {
+		Sprite &erased = erasedList[i];
+		if (erased.screenObjPtr != screenObj)
+			continue;
+
+		spriteEntry.backgroundBuffer = erased.backgroundBuffer;
+		spriteEntry.bufferSize = erased.bufferSize;
+
+		if (incremental && erased.sortOrder == spriteEntry.sortOrder &&
+			erased.xPos == spriteEntry.xPos && erased.yPos == spriteEntry.yPos &&
+			erased.xSize == spriteEntry.xSize && erased.ySize == spriteEntry.ySize &&
+			erased.celData == spriteEntry.celData && erased.priority == spriteEntry.priority) {
+			spriteEntry.viewHidden = erased.viewHidden;
+			spriteEntry.redraw = false;
+		} else {
+			_dirtyAreas.push_back(Common::Rect(erased.xPos, erased.yPos, erased.xPos + erased.xSize, erased.yPos + erased.ySize));
+		}
+
+		erasedList.remove_at(i);
+		break;
+	}
+
+	if (spriteEntry.redraw)
+		_dirtyAreas.push_back(Common::Rect(spriteEntry.xPos, spriteEntry.yPos, xRight, yBottom));
+
 //	warning("list-add: %d, %d, original yPos: %d, ySize: %d", spriteEntry.xPos, spriteEntry.yPos, screenObj->yPos, screenObj->ySize);
-	spriteEntry.backgroundBuffer = (uint8 *)malloc(spriteEntry.xSize * spriteEntry.ySize * 2); // for visual + priority data
-	assert(spriteEntry.backgroundBuffer);
+	uint32 bufferSize = spriteEntry.xSize * spriteEntry.ySize * 2; // for visual + priority data
+	if (spriteEntry.bufferSize < bufferSize * 2) {
+		free(spriteEntry.backgroundBuffer);
+		spriteEntry.bufferSize = bufferSize * 2;
+		spriteEntry.backgroundBuffer = (uint8 *)malloc(spriteEntry.bufferSize);
+		assert(spriteEntry.backgroundBuffer);
+	}
+	spriteEntry.foregroundBuffer = spriteEntry.backgroundBuffer + bufferSize;
 	spriteList.push_back(spriteEntry);
 }
 
+/**
+ * Mark the unchanged sprites, which have to be drawn again anyway.
+ * Drawing a cel depends on everything drawn before in its rectangle and,
+ * because of the control lines, in all the rows below it. So a sprite is
+ * redrawn, if a changed sprite touches this area.
+ */
+void SpritesMgr::markDependentSprites(SpriteList &spriteList) {
+	bool changed = true;
+
+	while (changed) {
+		changed = false;
+
+		for (uint i = 0; i < spriteList.size(); i++) {
+			Sprite &sprite = spriteList[i];
+			if (sprite.redraw)
+				continue;
+
+			Common::Rect dependencyArea(sprite.xPos, sprite.yPos, sprite.xPos + sprite.xSize, SCRIPT_HEIGHT);
+			for (uint j = 0; j < _dirtyAreas.size(); j++) {
+				if (dependencyArea.intersects(_dirtyAreas[j])) {
+					sprite.redraw = true;
+					_dirtyAreas.push_back(Common::Rect(sprite.xPos, sprite.yPos, sprite.xPos + sprite.xSize, sprite.yPos + sprite.ySize));
+					changed = true;
+					break;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Rebuild and draw the updating sprites after they were erased.
+ * Sprites that did not change since they were drawn and are not affected
+ * by a changed one get their drawn data restored instead of drawing
+ * the cel again.
+ */
+void SpritesMgr::updateRegularSpriteList() {
+	buildSpriteList(_spriteRegularList, _spriteRegularErased, fAnimated | fUpdate | fDrawn, true);
+	drawSprites(_spriteRegularList);
+
+	_stats.updates++;
+	_stats.sprites += _spriteRegularList.size();
+	for (uint i = 0; i < _spriteRegularList.size(); i++) {
+		if (_spriteRegularList[i].redraw)
+			_stats.redrawn++;
+	}
+
+	if (_verifyUpdates) {
+		// Compare against a full rebuild, which then replaces the incremental result
+		uint32 hash = hashScreens();
+		bool egoInvisible = _vm->getFlag(VM_FLAG_EGO_INVISIBLE);
+
+		eraseRegularSprites();
+		buildRegularSpriteList();
+		drawRegularSpriteList();
+
+		if (hash != hashScreens() || egoInvisible != _vm->getFlag(VM_FLAG_EGO_INVISIBLE)) {
+			warning("updateRegularSpriteList(): incremental update differs from a full rebuild");
+			_stats.mismatches++;
+		}
+	}
+}
+
+uint32 SpritesMgr::hashScreens() {
+	const byte *gameScreen = _gfx->getGameScreen();
+	const byte *priorityScreen = _gfx->getPriorityScreen();
+	uint32 hash = 2166136261U;
+
+	for (uint i = 0; i < SCRIPT_WIDTH * SCRIPT_HEIGHT; i++) {
+		hash = (hash ^ gameScreen[i]) * 16777619;
+		hash = (hash ^ priorityScreen[i]) * 16777619;
+	}
+	return hash;
+}
+
+void SpritesMgr::resetStats() {
+	_stats.updates = 0;
+	_stats.sprites = 0;
+	_stats.redrawn = 0;
+	_stats.mismatches = 0;
+}
+
 void SpritesMgr::freeList(SpriteList &spriteList) {
-	SpriteList::iterator iter;
-	for (iter = spriteList.reverse_begin(); iter != spriteList.end(); iter--) {
-		Sprite &sprite = *iter;
+	for (int i = spriteList.size() - 1; i >= 0; i--) {
+		Sprite &sprite = spriteList[i];
 
 		free(sprite.backgroundBuffer);
 	}
@@ -145,26 +281,29 @@ void SpritesMgr::freeList(SpriteList &spriteList) {
 
 void SpritesMgr::freeRegularSprites() {
 	freeList(_spriteRegularList);
+	freeList(_spriteRegularErased);
 }
 
 void SpritesMgr::freeStaticSprites() {
 	freeList(_spriteStaticList);
+	freeList(_spriteStaticErased);
 }
 
 void SpritesMgr::freeAllSprites() {
-	freeList(_spriteRegularList);
-	freeList(_spriteStaticList);
+	freeRegularSprites();
+	freeStaticSprites();
 }
 
-void SpritesMgr::eraseSprites(SpriteList &spriteList) {
-	SpriteList::iterator iter;
+void SpritesMgr::eraseSprites(SpriteList &spriteList, SpriteList &erasedList) {
 //	warning("eraseSprites - count %d", spriteList.size());
-	for (iter = spriteList.reverse_begin(); iter != spriteList.end(); iter--) {
-		Sprite &sprite = *iter;
+	for (int i = spriteList.size() - 1; i >= 0; i--) {
+		Sprite &sprite = spriteList[i];
 		_gfx->block_restore(sprite.xPos, sprite.yPos, sprite.xSize, sprite.ySize, sprite.backgroundBuffer);
 	}
 
-	freeList(spriteList);
+	// Keep the erased sprites around for the next build
+	freeList(erasedList);
+	erasedList.swap(spriteList);
 }
 
 /**
@@ -177,33 +316,41 @@ void SpritesMgr::eraseSprites(SpriteList &spriteList) {
  * @see erase_both()
  */
 void SpritesMgr::eraseRegularSprites() {
-	eraseSprites(_spriteRegularList);
+	eraseSprites(_spriteRegularList, _spriteRegularErased);
 }
 
 void SpritesMgr::eraseStaticSprites() {
-	eraseSprites(_spriteStaticList);
+	eraseSprites(_spriteStaticList, _spriteStaticErased);
 }
 
 void SpritesMgr::eraseSprites() {
-	eraseSprites(_spriteRegularList);
-	eraseSprites(_spriteStaticList);
+	eraseRegularSprites();
+	eraseStaticSprites();
 }
 
 /**
  * Draw all sprites in the given list.
  */
 void SpritesMgr::drawSprites(SpriteList &spriteList) {
-	SpriteList::iterator iter;
 //	warning("drawSprites");
 
-	for (iter = spriteList.begin(); iter != spriteList.end(); ++iter) {
-		Sprite &sprite = *iter;
+	for (uint i = 0; i < spriteList.size(); i++) {
+		Sprite &sprite = spriteList[i];
 		ScreenObjEntry *screenObj = sprite.screenObjPtr;
 
+		if (!sprite.redraw) {
+			// Unchanged since it was drawn, the background is still saved
+			_gfx->block_restore(sprite.xPos, sprite.yPos, sprite.xSize, sprite.ySize, sprite.foregroundBuffer);
+			if (screenObj->objectNr == 0)
+				_vm->setFlag(VM_FLAG_EGO_INVISIBLE, sprite.viewHidden);
+			continue;
+		}
+
 		_gfx->block_save(sprite.xPos, sprite.yPos, sprite.xSize, sprite.ySize, sprite.backgroundBuffer);
 		//debugC(8, kDebugLevelSprites, "drawSprites(): s->v->entry = %d (prio %d)", s->viewPtr->entry, s->viewPtr->priority);
 //		warning("sprite %d (view %d), priority %d, sort %d, givenOrder %d", screenObj->objectNr, screenObj->currentView, screenObj->priority, sprite.sortOrder, sprite.givenOrderNr);
-		drawCel(screenObj);
+		sprite.viewHidden = drawCel(screenObj);
+		_gfx->block_save(sprite.xPos, sprite.yPos, sprite.xSize, sprite.ySize, sprite.foregroundBuffer);
 	}
 }
 
@@ -230,7 +377,7 @@ void SpritesMgr::drawAllSpriteLists() {
 	drawSprites(_spriteRegularList);
 }
 
-void SpritesMgr::drawCel(ScreenObjEntry *screenObj) {
+bool SpritesMgr::drawCel(ScreenObjEntry *screenObj) {
 	int16 curX = screenObj->xPos;
 	int16 baseX = screenObj->xPos;
 	int16 curY = screenObj->yPos;
@@ -277,6 +424,7 @@ void SpritesMgr::drawCel(ScreenObjEntry *screenObj) {
 	if (screenObj->objectNr == 0) { // if ego, update if ego is visible at the moment
 		_vm->setFlag(VM_FLAG_EGO_INVISIBLE, isViewHidden);
 	}
+	return isViewHidden;
 }
 
 
@@ -358,12 +506,10 @@ void SpritesMgr::showSprite(ScreenObjEntry *screenObj) {
 }
 
 void SpritesMgr::showSprites(SpriteList &spriteList) {
-	SpriteList::iterator iter;
 	ScreenObjEntry *screenObjPtr = nullptr;
 
-	for (iter = spriteList.begin(); iter != spriteList.end(); ++iter) {
-		Sprite &sprite = *iter;
-		screenObjPtr = sprite.screenObjPtr;
+	for (uint i = 0; i < spriteList.size(); i++) {
+		screenObjPtr = spriteList[i].screenObjPtr;
 
 		showSprite(screenObjPtr);
 
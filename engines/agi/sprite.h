@@ -27,8 +27,8 @@ namespace Agi {
 /**
  * Sprite structure.
  * This structure holds information on visible and priority data of
- * a rectangular area of the AGI screen. Sprites are chained in two
- * circular lists, one for updating and other for non-updating sprites.
+ * a rectangular area of the AGI screen. Sprites are kept in two
+ * arrays, one for updating and other for non-updating sprites.
  */
 struct Sprite {
 	uint16 givenOrderNr;
@@ -39,10 +39,22 @@ struct Sprite {
 	int16 xSize;                  /**< width of the sprite */
 	int16 ySize;                  /**< height of the sprite */
 	byte *backgroundBuffer;       /**< buffer to store background data */
+	byte *foregroundBuffer;       /**< buffer to store the data after the cel was drawn */
+	uint32 bufferSize;            /**< allocated size of both buffers */
+	AgiViewCel *celData;          /**< cel that was drawn */
+	byte priority;                /**< priority the cel was drawn with */
+	bool viewHidden;              /**< no pixel of the cel was visible */
+	bool redraw;                  /**< cel has to be drawn, otherwise the foreground buffer is restored */
 };
 
-typedef Common::List<Sprite> SpriteList;
-typedef Common::List<Sprite *> SpritePtrList;
+typedef Common::Array<Sprite> SpriteList;
+
+struct SpriteStats {
+	uint32 updates;               /**< incremental updates of the regular sprites */
+	uint32 sprites;               /**< sprites in these updates */
+	uint32 redrawn;               /**< sprites whose cel had to be drawn again */
+	uint32 mismatches;            /**< updates that differed from a full rebuild */
+};
 
 class AgiEngine;
 class GfxMgr;
@@ -60,17 +72,33 @@ private:
 	SpriteList _spriteRegularList;
 	SpriteList _spriteStaticList;
 
+	// Sprites removed by the last erase, kept for their buffers and to
+	// find out which sprites changed since they were drawn
+	SpriteList _spriteRegularErased;
+	SpriteList _spriteStaticErased;
+
+	// Areas of the screen where sprites changed during an incremental update
+	Common::Array<Common::Rect> _dirtyAreas;
+
+	SpriteStats _stats;
+	bool _verifyUpdates;
+
+	void buildSpriteList(SpriteList &spriteList, SpriteList &erasedList, uint32 wantedFlags, bool incremental);
+	void markDependentSprites(SpriteList &spriteList);
+	uint32 hashScreens();
+
 public:
 	void buildRegularSpriteList();
 	void buildStaticSpriteList();
 	void buildAllSpriteLists();
-	void buildSpriteListAdd(uint16 givenOrderNr, ScreenObjEntry *screenObj, SpriteList &spriteList);
+	void buildSpriteListAdd(uint16 givenOrderNr, ScreenObjEntry *screenObj, SpriteList &spriteList, SpriteList &erasedList, bool incremental);
+	void updateRegularSpriteList();
 	void freeList(SpriteList &spriteList);
 	void freeRegularSprites();
 	void freeStaticSprites();
 	void freeAllSprites();
 
-	void eraseSprites(SpriteList &spriteList);
+	void eraseSprites(SpriteList &spriteList, SpriteList &erasedList);
 	void eraseRegularSprites();
 	void eraseStaticSprites();
 	void eraseSprites();
@@ -80,7 +108,7 @@ public:
 	void drawStaticSpriteList();
 	void drawAllSpriteLists();
 
-	void drawCel(ScreenObjEntry *screenObj);
+	bool drawCel(ScreenObjEntry *screenObj);
 
 	void showSprite(ScreenObjEntry *screenObj);
 	void showSprites(SpriteList &spriteList);
@@ -96,6 +124,11 @@ public:
 
 	void addToPic(int16 viewNr, int16 loopNr, int16 celNr, int16 xPos, int16 yPos, int16 priority, int16 border);
 	void addToPicDrawPriorityBox(ScreenObjEntry *screenObj, int16 border);
+
+	void setVerifyUpdates(bool verify) { _verifyUpdates = verify; }
+	bool getVerifyUpdates() const { return _verifyUpdates; }
+	const SpriteStats &getStats() const { return _stats; }
+	void resetStats();
 };
 
 } // End of namespace Agi
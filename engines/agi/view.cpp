@@ -669,8 +669,7 @@ void AgiEngine::updateScreenObjTable() {
 	if (changeCount) {
 		_sprites->eraseRegularSprites();
 		updatePosition();
-		_sprites->buildRegularSpriteList();
-		_sprites->drawRegularSpriteList();
+		_sprites->updateRegularSpriteList();
 		_sprites->showRegularSpriteList();
 
 		_game.screenObjTable[SCREENOBJECTS_EGO_ENTRY].flags &= ~(fOnWater | fOnLand);
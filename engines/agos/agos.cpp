@@ -240,6 +240,8 @@ AGOSEngine::AGOSEngine(OSystem *system, const AGOSGameDescription *gd)
 	_subroutineListOrg = nullptr;
 
 	_subroutineList = nullptr;
+	_subroutineIndexHead = nullptr;
+	_subroutineIndexValid = false;
 
 	_recursionDepth = 0;
 
@@ -510,6 +512,8 @@ AGOSEngine::AGOSEngine(OSystem *system, const AGOSGameDescription *gd)
 	memset(_lettersToPrintBuf, 0, sizeof(_lettersToPrintBuf));
 
 	_planarBuf = nullptr;
+	_decodedImagesSize = 0;
+	_decodedImagesBudget = kDecodedImagesBudget;
 	_pak98Buf = nullptr;
 	_paletteModNext = 16;
 
@@ -26,7 +26,9 @@
 
 #include "common/array.h"
 #include "common/error.h"
+#include "common/hashmap.h"
 #include "common/keyboard.h"
+#include "common/list.h"
 #include "common/random.h"
 #include "common/rect.h"
 #include "common/stack.h"
@@ -322,6 +324,14 @@ protected:
 
 	Subroutine *_subroutineList;
 
+	// Subroutines of _subroutineList by ID. The list is only ever extended
+	// at its head or reset to an older head, so the index is valid as long
+	// as its head matches the list head.
+	typedef Common::HashMap<uint16, Subroutine *> SubroutineIndex;
+	SubroutineIndex _subroutineIndex;
+	Subroutine *_subroutineIndexHead;
+	bool _subroutineIndexValid;
+
 	uint8 _recursionDepth;
 
 	uint32 _lastVgaTick;
@@ -563,6 +573,45 @@ protected:
 
 	byte *_planarBuf;
 	byte _videoBuf1[32000];
+
+	// Compressed images decoded once, while their VGA file stays in memory
+	struct DecodedImageKey {
+		const byte *vgaFile;
+		int16 image;
+		bool flip;
+
+		bool operator==(const DecodedImageKey &other) const {
+			return vgaFile == other.vgaFile && image == other.image && flip == other.flip;
+		}
+	};
+
+	struct DecodedImageKeyHash {
+		uint operator()(const DecodedImageKey &key) const {
+			return (uint)(uintptr)key.vgaFile * 31 + (uint16)key.image * 2 + (key.flip ? 1 : 0);
+		}
+	};
+
+	struct DecodedImage {
+		DecodedImageKey key;
+		uint16 width, height;
+		// The compressed data the image was decoded from
+		const byte *srcStart, *srcEnd;
+		Common::Array<byte> data;
+	};
+
+	typedef Common::List<DecodedImage> DecodedImageList;
+	typedef Common::HashMap<DecodedImageKey, DecodedImageList::iterator, DecodedImageKeyHash> DecodedImageIndex;
+
+	enum {
+		kDecodedImagesBudget = 2 * 1024 * 1024
+	};
+
+	// Most recently used first
+	DecodedImageList _decodedImages;
+	DecodedImageIndex _decodedImageIndex;
+	uint32 _decodedImagesSize;
+	uint32 _decodedImagesBudget;
+
 	uint16 _videoWindows[128];
 	const byte *_pak98Buf;
 	byte _paletteModNext;
@@ -688,6 +737,14 @@ protected:
 	void readSubroutineBlock(Common::SeekableReadStream *in);
 
 	Subroutine *getSubroutineByID(uint subroutineId);
+	Subroutine *findSubroutine(uint subroutineId);
+#ifndef RELEASE_BUILD
+	Subroutine *findSubroutineReference(uint subroutineId);
+#endif
+	void rebuildSubroutineIndex();
+#ifndef RELEASE_BUILD
+	bool benchmarkSubroutineLookup(uint lookups, uint &numSubroutines, uint32 &time, uint32 &referenceTime);
+#endif
 
 	/* used in debugger */
 	void dumpAllSubroutines();
@@ -1176,6 +1233,13 @@ protected:
 	void drawVertImageCompressed(VC10_state *state);
 	void drawVertImageUncompressed(VC10_state *state);
 
+	DecodedImage *findDecodedImage(const VC10_state *state, bool flip);
+	DecodedImage *addDecodedImage(const VC10_state *state, bool flip, uint32 size);
+	void useDecodedColumns(VC10_state *state);
+	const byte *uncompressFlipCached(VC10_state *state, uint16 w, uint16 h);
+	void invalidateDecodedImages(const byte *start, const byte *end);
+	DecodedImageList::iterator removeDecodedImage(DecodedImageList::iterator it);
+
 	void setMoveRect(uint16 x, uint16 y, uint16 width, uint16 height);
 
 	void horizontalScroll(VC10_state *state);
@@ -1314,6 +1378,9 @@ protected:
 	void waitForMark(uint i);
 	void scrollScreen();
 
+	void setDecodedImagesBudget(uint32 budget);
+	bool benchmarkImageDecoding(uint &numImages, uint32 &decodeTime, uint32 &firstTime, uint32 &cachedTime);
+
 	void decodeColumn(byte *dst, const byte *src, uint16 height, uint16 pitch);
 	void decodeRow(byte *dst, const byte *src, uint16 width, uint16 pitch);
 	void hitarea_stuff_helper_2();
@@ -44,6 +44,10 @@ Debugger::Debugger(AGOSEngine *vm)
 	registerCmd("sub",      WRAP_METHOD(Debugger, Cmd_StartSubroutine));
 	registerCmd("dumpimage",      WRAP_METHOD(Debugger, Cmd_dumpImage));
 	registerCmd("dumpscript",     WRAP_METHOD(Debugger, Cmd_dumpScript));
+#ifndef RELEASE_BUILD
+	registerCmd("subbench",       WRAP_METHOD(Debugger, Cmd_SubroutineBench));
+#endif
+	registerCmd("imagecache",     WRAP_METHOD(Debugger, Cmd_ImageCache));
 
 }
 
@@ -262,4 +266,43 @@ bool Debugger::Cmd_dumpScript(int argc, const char **argv) {
 	return true;
 }
 
+#ifndef RELEASE_BUILD
+bool Debugger::Cmd_SubroutineBench(int argc, const char **argv) {
+	uint lookups = 100000;
+	if (argc > 1)
+		lookups = atoi(argv[1]);
+
+	if (lookups == 0) {
+		debugPrintf("Syntax: subbench [<lookups>]\n");
+		return true;
+	}
+
+	uint numSubroutines;
+	uint32 time, referenceTime;
+	bool identical = _vm->benchmarkSubroutineLookup(lookups, numSubroutines, time, referenceTime);
+
+	debugPrintf("%d lookups in %d loaded subroutines\n", lookups, numSubroutines);
+	debugPrintf("Index: %d ms, list walk: %d ms, results %s\n", time, referenceTime,
+	            identical ? "identical" : "DIFFERENT");
+
+	return true;
+}
+#endif
+
+bool Debugger::Cmd_ImageCache(int argc, const char **argv) {
+	if (argc > 1)
+		_vm->setDecodedImagesBudget(atoi(argv[1]) * 1024);
+
+	uint numImages;
+	uint32 decodeTime, firstTime, cachedTime;
+	bool identical = _vm->benchmarkImageDecoding(numImages, decodeTime, firstTime, cachedTime);
+
+	debugPrintf("Decoded image cache: %d KB of %d KB used\n", _vm->_decodedImagesSize / 1024, _vm->_decodedImagesBudget / 1024);
+	debugPrintf("%d compressed images in the loaded zones\n", numImages);
+	debugPrintf("Decode: %d ms, first cached decode: %d ms, cache hits: %d ms, results %s\n",
+	            decodeTime, firstTime, cachedTime, identical ? "identical" : "DIFFERENT");
+
+	return true;
+}
+
 } // End of namespace AGOS
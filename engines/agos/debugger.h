@@ -46,6 +46,10 @@ private:
 	bool Cmd_StartSubroutine(int argc, const char **argv);
 	bool Cmd_dumpImage(int argc, const char **argv);
 	bool Cmd_dumpScript(int argc, const char **argv);
+#ifndef RELEASE_BUILD
+	bool Cmd_SubroutineBench(int argc, const char **argv);
+#endif
+	bool Cmd_ImageCache(int argc, const char **argv);
 };
 
 } // End of namespace AGOS
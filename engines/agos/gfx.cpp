@@ -33,6 +33,9 @@
 namespace AGOS {
 
 byte *vc10_depackColumn(VC10_state * vs) {
+	if (vs->decodedColumns)
+		return vs->decodedColumns + (vs->decodedColumn++) * vs->dh + vs->y_skip;
+
 	int8 a = vs->depack_cont;
 	const byte *src = vs->srcPtr;
 	byte *dst = vs->depack_dest;
@@ -81,6 +84,235 @@ void vc10_skip_cols(VC10_state *vs) {
 	}
 }
 
+AGOSEngine::DecodedImage *AGOSEngine::findDecodedImage(const VC10_state *state, bool flip) {
+	DecodedImageKey key;
+	key.vgaFile = _curVgaFile2;
+	key.image = state->image;
+	key.flip = flip;
+
+	DecodedImageIndex::iterator it = _decodedImageIndex.find(key);
+	if (it == _decodedImageIndex.end())
+		return nullptr;
+
+	DecodedImageList::iterator entry = it->_value;
+	if (entry->srcStart != state->srcPtr || entry->width != state->width || entry->height != state->height)
+		return nullptr;
+
+	if (entry != _decodedImages.begin()) {
+		// Move the entry to the front, without copying the image itself
+		_decodedImages.push_front(DecodedImage());
+		DecodedImage &front = _decodedImages.front();
+		front.key = entry->key;
+		front.width = entry->width;
+		front.height = entry->height;
+		front.srcStart = entry->srcStart;
+		front.srcEnd = entry->srcEnd;
+		front.data.swap(entry->data);
+		_decodedImages.erase(entry);
+		it->_value = _decodedImages.begin();
+	}
+	return &_decodedImages.front();
+}
+
+AGOSEngine::DecodedImageList::iterator AGOSEngine::removeDecodedImage(DecodedImageList::iterator it) {
+	_decodedImageIndex.erase(it->key);
+	_decodedImagesSize -= it->data.size();
+	return _decodedImages.erase(it);
+}
+
+AGOSEngine::DecodedImage *AGOSEngine::addDecodedImage(const VC10_state *state, bool flip, uint32 size) {
+	if (size > _decodedImagesBudget)
+		return nullptr;
+
+	DecodedImageKey key;
+	key.vgaFile = _curVgaFile2;
+	key.image = state->image;
+	key.flip = flip;
+
+	// Drop an older decoding of the same image, then the least recently used ones
+	DecodedImageIndex::iterator it = _decodedImageIndex.find(key);
+	if (it != _decodedImageIndex.end())
+		removeDecodedImage(it->_value);
+
+	while (_decodedImagesSize + size > _decodedImagesBudget)
+		removeDecodedImage(--_decodedImages.end());
+
+	_decodedImages.push_front(DecodedImage());
+	DecodedImage &entry = _decodedImages.front();
+	entry.key = key;
+	entry.width = state->width;
+	entry.height = state->height;
+	entry.srcStart = entry.srcEnd = state->srcPtr;
+	entry.data.resize(size);
+	_decodedImagesSize += size;
+	_decodedImageIndex[key] = _decodedImages.begin();
+
+	return &entry;
+}
+
+void AGOSEngine::useDecodedColumns(VC10_state *state) {
+	state->decodedColumns = nullptr;
+	state->decodedColumn = 0;
+
+	DecodedImage *entry = findDecodedImage(state, false);
+	if (!entry) {
+		uint columns = (getGameType() == GType_FF || getGameType() == GType_PP) ? state->width : state->width * 8;
+		entry = addDecodedImage(state, false, columns * state->height);
+		if (!entry)
+			return;
+
+		VC10_state vs;
+		vs.srcPtr = state->srcPtr;
+		vs.dh = state->height;
+		vs.depack_cont = -0x80;
+
+		byte *dst = entry->data.data();
+		for (uint i = 0; i < columns; i++) {
+			memcpy(dst, vc10_depackColumn(&vs), state->height);
+			dst += state->height;
+		}
+		entry->srcEnd = vs.srcPtr;
+	}
+
+	state->decodedColumns = entry->data.data();
+}
+
+const byte *AGOSEngine::uncompressFlipCached(VC10_state *state, uint16 w, uint16 h) {
+	DecodedImage *entry = findDecodedImage(state, true);
+	if (entry)
+		return entry->data.data();
+
+	const byte *src = vc10_uncompressFlip(state->srcPtr, w, h);
+
+	entry = addDecodedImage(state, true, w * 8 * h);
+	if (!entry)
+		return src;
+
+	// The size of the compressed data is not known, the start is enough to
+	// notice that the VGA file was replaced
+	entry->srcEnd = entry->srcStart + 1;
+	memcpy(entry->data.data(), src, entry->data.size());
+	return src;
+}
+
+void AGOSEngine::invalidateDecodedImages(const byte *start, const byte *end) {
+	DecodedImageList::iterator it = _decodedImages.begin();
+	while (it != _decodedImages.end()) {
+		bool overwritten = (it->key.vgaFile >= start && it->key.vgaFile < end) ||
+			(it->srcStart < end && it->srcEnd > start);
+
+		if (overwritten)
+			it = removeDecodedImage(it);
+		else
+			++it;
+	}
+}
+
+void AGOSEngine::setDecodedImagesBudget(uint32 budget) {
+	_decodedImagesBudget = budget;
+
+	while (_decodedImagesSize > _decodedImagesBudget)
+		removeDecodedImage(--_decodedImages.end());
+}
+
+bool AGOSEngine::benchmarkImageDecoding(uint &numImages, uint32 &decodeTime, uint32 &firstTime, uint32 &cachedTime) {
+	const bool feeble = (getGameType() == GType_FF || getGameType() == GType_PP);
+	byte *curVgaFile2 = _curVgaFile2;
+	Common::Array<VC10_state> images;
+	Common::Array<byte *> vgaFiles;
+
+	numImages = 0;
+	decodeTime = firstTime = cachedTime = 0;
+
+	// The other image formats are converted before they are drawn
+	if ((getFeatures() & GF_PLANAR) || getPlatform() == Common::kPlatformPC98)
+		return true;
+
+	for (uint zone = 0; zone < ARRAYSIZE(_vgaBufferPointers); zone++) {
+		const VgaPointersEntry *vpe = &_vgaBufferPointers[zone];
+		if (vpe->vgaFile2 == nullptr)
+			continue;
+
+		uint32 imageBlockSize = vpe->vgaFile2End - vpe->vgaFile2;
+		uint32 offsEnd = readUint32Wrapper(vpe->vgaFile2 + 8);
+
+		for (uint i = 1; (i * 8) < offsEnd; i++) {
+			const byte *p2 = vpe->vgaFile2 + i * 8;
+			uint32 offs = readUint32Wrapper(p2);
+
+			VC10_state state;
+			state.image = i;
+			state.srcPtr = vpe->vgaFile2 + offs;
+			if (feeble) {
+				state.width = READ_LE_UINT16(p2 + 6);
+				state.height = READ_LE_UINT16(p2 + 4) & 0x7FFF;
+			} else {
+				state.width = READ_BE_UINT16(p2 + 6) / 16;
+				state.height = p2[5];
+			}
+			byte flags = feeble ? p2[5] : p2[4];
+
+			if (offs >= imageBlockSize || state.width == 0 || state.height == 0)
+				break;
+			// Only compressed images which are drawn column by column
+			if (!(flags & 0x80) || state.height > 480 || state.width > (feeble ? 640 : 20))
+				continue;
+
+			state.dh = state.height;
+			state.depack_cont = -0x80;
+			images.push_back(state);
+			vgaFiles.push_back(vpe->vgaFile2);
+		}
+	}
+
+	numImages = images.size();
+
+	// Start with an empty cache
+	uint32 budget = _decodedImagesBudget;
+	setDecodedImagesBudget(0);
+	setDecodedImagesBudget(budget);
+
+	Common::Array<Common::Array<byte> > reference(numImages);
+	uint32 startTime = g_system->getMillis();
+	for (uint i = 0; i < numImages; i++) {
+		VC10_state state = images[i];
+		uint columns = feeble ? state.width : state.width * 8;
+		reference[i].resize(columns * state.height);
+
+		byte *dst = reference[i].data();
+		for (uint c = 0; c < columns; c++) {
+			memcpy(dst, vc10_depackColumn(&state), state.height);
+			dst += state.height;
+		}
+	}
+	decodeTime = g_system->getMillis() - startTime;
+
+	for (uint pass = 0; pass < 2; pass++) {
+		startTime = g_system->getMillis();
+		for (uint i = 0; i < numImages; i++) {
+			_curVgaFile2 = vgaFiles[i];
+			useDecodedColumns(&images[i]);
+		}
+		(pass == 0 ? firstTime : cachedTime) = g_system->getMillis() - startTime;
+	}
+
+	bool identical = true;
+	for (uint i = 0; i < numImages; i++) {
+		_curVgaFile2 = vgaFiles[i];
+		useDecodedColumns(&images[i]);
+
+		VC10_state &state = images[i];
+		uint columns = feeble ? state.width : state.width * 8;
+		for (uint c = 0; c < columns && state.decodedColumns; c++) {
+			if (memcmp(vc10_depackColumn(&state), reference[i].data() + c * state.height, state.height))
+				identical = false;
+		}
+	}
+
+	_curVgaFile2 = curVgaFile2;
+	return identical;
+}
+
 void AGOSEngine::decodeColumn(byte *dst, const byte *src, uint16 height, uint16 pitch) {
 	int8 reps = (int8)0x80;
 	byte color;
@@ -302,6 +534,7 @@ void AGOSEngine_Feeble::drawImage(VC10_state *state) {
 
 			state->dl = state->width;
 			state->dh = state->height;
+			useDecodedColumns(state);
 
 			dstPtr = state->surf_addr;
 			w = 0;
@@ -336,6 +569,7 @@ void AGOSEngine_Feeble::drawImage(VC10_state *state) {
 
 			state->dl = state->width;
 			state->dh = state->height;
+			useDecodedColumns(state);
 
 			dstPtr = state->surf_addr;
 			w = 0;
@@ -371,6 +605,7 @@ void AGOSEngine_Feeble::drawImage(VC10_state *state) {
 
 			state->dl = state->width;
 			state->dh = state->height;
+			useDecodedColumns(state);
 
 			vc10_skip_cols(state);
 
@@ -498,6 +733,7 @@ void AGOSEngine_Simon1::drawMaskedImage(VC10_state *state) {
 		state->x_skip *= 4;
 		state->dl = state->width;
 		state->dh = state->height;
+		useDecodedColumns(state);
 
 		vc10_skip_cols(state);
 
@@ -808,6 +1044,7 @@ void AGOSEngine::drawVertImageCompressed(VC10_state *state) {
 
 	state->dl = state->width;
 	state->dh = state->height;
+	useDecodedColumns(state);
 
 	vc10_skip_cols(state);
 
@@ -763,6 +763,9 @@ void AGOSEngine::decompressPN(Common::Stack<uint32> &dataList, uint8 *&dataOut,
 void AGOSEngine::loadVGABeardFile(uint16 id) {
 	uint32 offs, size;
 
+	// The beard images replace the data of zone 11 in place
+	invalidateDecodedImages(_vgaBufferPointers[11].vgaFile2, _vgaBufferPointers[11].vgaFile2 + 1);
+
 	if (getFeatures() & GF_OLD_BUNDLE) {
 		Common::File in;
 		char filename[15];
@@ -23,6 +23,7 @@
 #include "common/file.h"
 #include "common/textconsole.h"
 #include "common/memstream.h"
+#include "common/system.h"
 
 #include "agos/agos.h"
 #include "agos/intern.h"
@@ -194,29 +195,109 @@ static const char *const opcodeArgTable_puzzlepack[256] = {
 Subroutine *AGOSEngine::getSubroutineByID(uint subroutineId) {
 	Subroutine *cur;
 
-	for (cur = _subroutineList; cur; cur = cur->next) {
-		if (cur->id == subroutineId)
-			return cur;
-	}
+	cur = findSubroutine(subroutineId);
+	if (cur)
+		return cur;
 
 	if (loadXTablesIntoMem(subroutineId)) {
-		for (cur = _subroutineList; cur; cur = cur->next) {
-			if (cur->id == subroutineId)
-				return cur;
-		}
+		cur = findSubroutine(subroutineId);
+		if (cur)
+			return cur;
 	}
 
 	if (loadTablesIntoMem(subroutineId)) {
-		for (cur = _subroutineList; cur; cur = cur->next) {
-			if (cur->id == subroutineId)
-				return cur;
-		}
+		cur = findSubroutine(subroutineId);
+		if (cur)
+			return cur;
 	}
 
 	debug(0,"getSubroutineByID: subroutine %d not found", subroutineId);
 	return nullptr;
 }
 
+Subroutine *AGOSEngine::findSubroutine(uint subroutineId) {
+	if (!_subroutineIndexValid || _subroutineIndexHead != _subroutineList)
+		rebuildSubroutineIndex();
+
+	if (subroutineId > 0xFFFF)
+		return nullptr;
+
+	SubroutineIndex::const_iterator it = _subroutineIndex.find(subroutineId);
+	if (it == _subroutineIndex.end())
+		return nullptr;
+
+	return it->_value;
+}
+
+#ifndef RELEASE_BUILD
+Subroutine *AGOSEngine::findSubroutineReference(uint subroutineId) {
+	Subroutine *cur;
+
+	for (cur = _subroutineList; cur; cur = cur->next) {
+		if (cur->id == subroutineId)
+			return cur;
+	}
+
+	return nullptr;
+}
+#endif
+
+void AGOSEngine::rebuildSubroutineIndex() {
+	_subroutineIndex.clear(true);
+
+	// The first subroutine with an ID in the list hides the older ones
+	for (Subroutine *cur = _subroutineList; cur; cur = cur->next) {
+		if (!_subroutineIndex.contains(cur->id))
+			_subroutineIndex[cur->id] = cur;
+	}
+
+	_subroutineIndexHead = _subroutineList;
+	_subroutineIndexValid = true;
+}
+
+#ifndef RELEASE_BUILD
+bool AGOSEngine::benchmarkSubroutineLookup(uint lookups, uint &numSubroutines, uint32 &time, uint32 &referenceTime) {
+	Common::Array<uint16> ids;
+	for (Subroutine *cur = _subroutineList; cur; cur = cur->next)
+		ids.push_back(cur->id);
+
+	numSubroutines = ids.size();
+	time = referenceTime = 0;
+	if (ids.empty())
+		return true;
+
+	// Script calls go to all the loaded subroutines, plus a few IDs which
+	// are in none of them and would cause a table load
+	Common::Array<uint> trace;
+	uint32 seed = 1;
+	for (uint i = 0; i < lookups; i++) {
+		seed = seed * 1103515245 + 12345;
+		if (((seed >> 8) & 15) == 0)
+			trace.push_back((seed >> 12) & 0xFFFF);
+		else
+			trace.push_back(ids[(seed >> 12) % ids.size()]);
+	}
+
+	Common::Array<Subroutine *> results;
+	results.reserve(lookups);
+
+	uint32 startTime = g_system->getMillis();
+	for (uint i = 0; i < lookups; i++)
+		results.push_back(findSubroutine(trace[i]));
+	time = g_system->getMillis() - startTime;
+
+	bool identical = true;
+	startTime = g_system->getMillis();
+	for (uint i = 0; i < lookups; i++) {
+		if (findSubroutineReference(trace[i]) != results[i])
+			identical = false;
+	}
+	referenceTime = g_system->getMillis() - startTime;
+
+	return identical;
+}
+#endif
+
 void AGOSEngine::alignTableMem() {
 	while (!IS_ALIGNED(_tablesHeapPtr, sizeof(byte *))) {
 		_tablesHeapPtr++;
@@ -469,6 +550,15 @@ Subroutine *AGOSEngine::createSubroutine(uint16 id) {
 	sub = (Subroutine *)allocateTable(sizeof(Subroutine));
 	sub->id = id;
 	sub->first = 0;
+
+	// Keep the index in sync, unless the list was reset since it was built
+	if (_subroutineIndexValid && _subroutineIndexHead == _subroutineList) {
+		_subroutineIndex[id] = sub;
+		_subroutineIndexHead = sub;
+	} else {
+		_subroutineIndexValid = false;
+	}
+
 	sub->next = _subroutineList;
 	_subroutineList = sub;
 	return sub;
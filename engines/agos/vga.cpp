@@ -705,7 +705,7 @@ void AGOSEngine::drawImage_init(int16 image, uint16 palette, int16 x, int16 y, u
 
 	if (getGameType() != GType_FF && getGameType() != GType_PP) {
 		if (state.flags & kDFCompressedFlip) {
-			state.srcPtr = vc10_uncompressFlip(state.srcPtr, width, height);
+			state.srcPtr = uncompressFlipCached(&state, width, height);
 		} else if (state.flags & kDFFlip) {
 			state.srcPtr = vc10_flip(state.srcPtr, width, height);
 		}
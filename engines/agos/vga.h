@@ -134,6 +134,10 @@ struct VC10_state {
 
 	byte depack_dest[480];
 
+	// All the columns decoded in advance, vc10_depackColumn reads them instead of srcPtr
+	byte *decodedColumns;
+	uint16 decodedColumn;
+
 	VC10_state() { memset(this, 0, sizeof(*this)); }
 };
 
@@ -133,6 +133,7 @@ byte *AGOSEngine::allocBlock(uint32 size) {
 			if (_rejectBlock)
 				continue;
 			checkZonePtrs();
+			invalidateDecodedImages(_block, _blockEnd);
 			_vgaMemPtr = _blockEnd;
 			return _block;
 		}
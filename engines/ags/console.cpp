@@ -22,6 +22,7 @@
 #include "ags/console.h"
 #include "ags/ags.h"
 #include "ags/globals.h"
+#include "ags/engine/ac/draw.h"
 #include "ags/shared/ac/sprite_cache.h"
 #include "ags/shared/gfx/allegro_bitmap.h"
 #include "ags/shared/script/cc_common.h"
@@ -35,6 +36,8 @@ AGSConsole::AGSConsole(AGSEngine *vm) : GUI::Debugger(), _vm(vm), _logOutputTarg
 	registerCmd("ags_set_script_dump", WRAP_METHOD(AGSConsole, Cmd_SetScriptDump));
 	registerCmd("ags_sprite_info",   WRAP_METHOD(AGSConsole, Cmd_getSpriteInfo));
 	registerCmd("ags_sprite_dump",  WRAP_METHOD(AGSConsole, Cmd_dumpSprite));
+	registerCmd("ags_transform_cache",  WRAP_METHOD(AGSConsole, Cmd_transformCache));
+	registerCmd("ags_transform_bench",  WRAP_METHOD(AGSConsole, Cmd_transformBench));
 
 	_logOutputTarget = new LogOutputTarget();
 	_agsDebuggerOutput = _GP(DbgMgr).RegisterOutput("ScummVMLog", _logOutputTarget, AGS3::AGS::Shared::kDbgMsg_None);
@@ -184,6 +187,41 @@ bool AGSConsole::Cmd_SetScriptDump(int argc, const char **argv) {
 	return true;
 }
 
+bool AGSConsole::Cmd_transformCache(int argc, const char **argv) {
+	AGS3::TransformedSpriteCache &cache = _GP(transformedSpriteCache);
+
+	if (argc == 2 && !strcmp(argv[1], "clear")) {
+		cache.Clear();
+	} else if (argc == 3 && !strcmp(argv[1], "size")) {
+		cache.SetMaxSize((size_t)atoi(argv[2]) * 1024);
+	} else if (argc != 1) {
+		debugPrintf("Usage: %s [clear | size <KB>]\n", argv[0]);
+		return true;
+	}
+
+	debugPrintf("Transformed sprites: %u images, %u KB\n", (uint)cache.GetCount(), (uint)(cache.GetSize() / 1024));
+	debugPrintf("Hits: %u, misses: %u\n", cache.GetHits(), cache.GetMisses());
+	return true;
+}
+
+bool AGSConsole::Cmd_transformBench(int argc, const char **argv) {
+	if (argc > 3) {
+		debugPrintf("Usage: %s [<characters> [<frames>]]\n", argv[0]);
+		return true;
+	}
+
+	const int characters = (argc > 1) ? MAX(atoi(argv[1]), 1) : 20;
+	const int frames = (argc > 2) ? MAX(atoi(argv[2]), 1) : 200;
+	AGS3::TransformCacheBenchmark result;
+	AGS3::benchmark_transform_cache(characters, frames, result);
+
+	debugPrintf("%d characters, %d frames\n", characters, frames);
+	debugPrintf("Without cache: %u ms\n", result.UncachedTime);
+	debugPrintf("With cache: %u ms (hits: %u, misses: %u)\n", result.CachedTime, result.Hits, result.Misses);
+	debugPrintf("Images %s\n", result.Identical ? "identical" : "DIFFER");
+	return true;
+}
+
 bool AGSConsole::Cmd_getSpriteInfo(int argc, const char **argv) {
 	if (argc != 2) {
 		debugPrintf("Usage: %s SpriteNumber\n", argv[0]);
@@ -70,6 +70,7 @@
 #include "ags/engine/ac/game.h"
 #include "ags/ags.h"
 #include "ags/globals.h"
+#include "common/system.h"
 
 namespace AGS3 {
 
@@ -104,6 +105,97 @@ ObjTexture &ObjTexture::operator=(ObjTexture &&o) {
 	return *this;
 }
 
+bool TransformedSpriteCache::Key::operator==(const Key &other) const {
+	return sppic == other.sppic && zoom == other.zoom &&
+		tintr == other.tintr && tintg == other.tintg && tintb == other.tintb &&
+		tintamnt == other.tintamnt && tintlight == other.tintlight &&
+		lightlev == other.lightlev && mirrored == other.mirrored;
+}
+
+uint TransformedSpriteCache::KeyHash::operator()(const Key &key) const {
+	uint hash = (uint)key.sppic;
+	hash = hash * 31 + (uint16_t)key.zoom;
+	hash = hash * 31 + (((uint)(uint8_t)key.tintr << 16) | ((uint)(uint8_t)key.tintg << 8) | (uint8_t)key.tintb);
+	hash = hash * 31 + (uint16_t)key.tintamnt;
+	hash = hash * 31 + (uint16_t)key.tintlight;
+	hash = hash * 31 + (uint16_t)key.lightlev;
+	return hash * 2 + (key.mirrored ? 1 : 0);
+}
+
+TransformedSpriteCache::~TransformedSpriteCache() {
+	Clear();
+}
+
+void TransformedSpriteCache::SetMaxSize(size_t max_size) {
+	_maxSize = max_size;
+	FreeSpace(0);
+}
+
+Bitmap *TransformedSpriteCache::Get(const Key &key) {
+	ItemMap::iterator it = _items.find(key);
+	if (it == _items.end()) {
+		_misses++;
+		return nullptr;
+	}
+	_hits++;
+	it->_value.LastUse = ++_useCounter;
+	return it->_value.Image;
+}
+
+void TransformedSpriteCache::Put(const Key &key, Bitmap *image) {
+	const size_t size = image->GetDataSize();
+	if (size > _maxSize)
+		return;
+
+	ItemMap::iterator it = _items.find(key);
+	if (it != _items.end()) {
+		_size -= it->_value.Size;
+		delete it->_value.Image;
+		_items.erase(it);
+	}
+
+	FreeSpace(size);
+
+	Item item;
+	item.Image = BitmapHelper::CreateBitmapCopy(image);
+	item.Size = size;
+	item.LastUse = ++_useCounter;
+	_items[key] = item;
+	_size += size;
+}
+
+void TransformedSpriteCache::Invalidate(int sprnum) {
+	for (ItemMap::iterator it = _items.begin(); it != _items.end(); ++it) {
+		// Mirrored images are stored with a negative sprite number
+		if (it->_key.sppic == sprnum || it->_key.sppic == -sprnum) {
+			_size -= it->_value.Size;
+			delete it->_value.Image;
+			_items.erase(it);
+		}
+	}
+}
+
+void TransformedSpriteCache::Clear() {
+	for (ItemMap::iterator it = _items.begin(); it != _items.end(); ++it)
+		delete it->_value.Image;
+	_items.clear();
+	_size = 0;
+}
+
+void TransformedSpriteCache::FreeSpace(size_t needed) {
+	// Drop the least recently used images until the new one fits
+	while (!_items.empty() && _size + needed > _maxSize) {
+		ItemMap::iterator oldest = _items.begin();
+		for (ItemMap::iterator it = _items.begin(); it != _items.end(); ++it) {
+			if (it->_value.LastUse < oldest->_value.LastUse)
+				oldest = it;
+		}
+		_size -= oldest->_value.Size;
+		delete oldest->_value.Image;
+		_items.erase(oldest);
+	}
+}
+
 
 void setpal() {
 	set_palette_range(_G(palette), 0, 255, 0);
@@ -439,6 +531,9 @@ void clear_drawobj_cache() {
 	// room overlays cache
 	_GP(screenovercache).clear();
 
+	// shared cache of the transformed character sprites
+	_GP(transformedSpriteCache).Clear();
+
 	// cleanup Character + Room object textures
 	for (auto &o : _GP(actsps)) o = ObjTexture();
 	for (auto &o : _GP(walkbehindobj)) o = ObjTexture();
@@ -619,6 +714,8 @@ void reset_objcache_for_sprite(int sprnum, bool deleted) {
 		if (deleted && ((int)(_GP(actsps)[ACTSP_OBJSOFF + i].SpriteID) == sprnum))
 			_GP(actsps)[ACTSP_OBJSOFF + i].SpriteID = UINT32_MAX; // invalid sprite ref
 	}
+	// shared cache of the transformed character sprites
+	_GP(transformedSpriteCache).Invalidate(sprnum);
 }
 
 void mark_screen_dirty() {
@@ -1441,17 +1538,113 @@ void tint_image(Bitmap *ds, Bitmap *srcimg, int red, int grn, int blu, int light
 		// Copy the image to the new bitmap
 		ds->Blit(srcimg, 0, 0, 0, 0, srcimg->GetWidth(), srcimg->GetHeight());
 		// Render the colourised image to a temporary bitmap,
-		// then transparently draw it over the original image
-		Bitmap *finaltarget = BitmapHelper::CreateTransparentBitmap(srcimg->GetWidth(), srcimg->GetHeight(), srcimg->GetColorDepth());
+		// then transparently draw it over the original image;
+		// the temporary bitmap is kept to avoid allocating it on every call
+		_G(tintScratchBmp) = recycle_bitmap(_G(tintScratchBmp), srcimg->GetColorDepth(), srcimg->GetWidth(), srcimg->GetHeight(), true);
+		Bitmap *finaltarget = _G(tintScratchBmp);
 		finaltarget->LitBlendBlt(srcimg, 0, 0, luminance);
 
 		// customized trans blender to preserve alpha channel
 		set_my_trans_blender(0, 0, 0, light_level);
 		ds->TransBlendBlt(finaltarget, 0, 0);
-		delete finaltarget;
 	}
 }
 
+// Scales, flips and tints one character image the way the software renderer does
+static Bitmap *benchmark_draw_character(Bitmap *src, const Size &sz, bool mirrored, int tint_red, int tint_green, int tint_blue,
+										int tint_amount, int tint_light, std::unique_ptr<Bitmap> &scaled, std::unique_ptr<Bitmap> &out) {
+	Bitmap *transformed = transform_sprite(src, false, scaled, sz, mirrored ? kFlip_Horizontal : kFlip_None);
+	recycle_bitmap(out, transformed->GetColorDepth(), transformed->GetWidth(), transformed->GetHeight());
+	tint_image(out.get(), transformed, tint_red, tint_green, tint_blue, tint_amount, tint_light);
+	return out.get();
+}
+
+static bool benchmark_same_image(Bitmap *a, Bitmap *b) {
+	if (a->GetSize() != b->GetSize() || a->GetColorDepth() != b->GetColorDepth())
+		return false;
+	const size_t line_len = a->GetWidth() * a->GetBPP();
+	for (int y = 0; y < a->GetHeight(); ++y) {
+		if (memcmp(a->GetScanLine(y), b->GetScanLine(y), line_len) != 0)
+			return false;
+	}
+	return true;
+}
+
+void benchmark_transform_cache(int num_chars, int num_frames, TransformCacheBenchmark &result) {
+	const int anim_frames = 4;
+	const int spr_width = 64, spr_height = 128, coldept = 32;
+	// tint red, green, blue, amount and luminance; below 250 the sprite is also lit
+	static const int tints[][5] = {
+		{ 255, 0, 0, 40, 255 }, { 0, 64, 255, 60, 200 }, { 255, 255, 255, 100, 150 }, { 0, 0, 0, 1, 120 }
+	};
+	const int num_tints = ARRAYSIZE(tints);
+
+	// a walk cycle shared by all the characters
+	std::vector<std::unique_ptr<Bitmap> > sprites(anim_frames);
+	for (int i = 0; i < anim_frames; ++i) {
+		sprites[i].reset(BitmapHelper::CreateTransparentBitmap(spr_width, spr_height, coldept));
+		sprites[i]->FillRect(Rect(16, 4, 47, 35), makeacol32(224, 172, 140, 255));
+		sprites[i]->FillRect(Rect(10 + i * 2, 36, 53 - i * 2, 89), makeacol32(40, 80, 160, 255));
+		sprites[i]->FillRect(Rect(14 + i * 4, 90, 29 + i * 4, 123), makeacol32(60, 40, 20, 255));
+		sprites[i]->FillRect(Rect(34 - i * 4, 90, 49 - i * 4, 123), makeacol32(60, 40, 20, 255));
+	}
+
+	std::unique_ptr<Bitmap> scaled, out;
+	std::vector<std::unique_ptr<Bitmap> > last_frame(num_chars);
+	TransformedSpriteCache cache;
+
+	result = TransformCacheBenchmark();
+	for (int pass = 0; pass < 2; ++pass) {
+		const bool use_cache = (pass == 1);
+		const uint32_t start = g_system->getMillis();
+		for (int frame = 0; frame < num_frames; ++frame) {
+			for (int c = 0; c < num_chars; ++c) {
+				const int spr = (frame + c) % anim_frames;
+				const int zoom = 60 + (c % 5) * 20;
+				const int *tint = tints[c % num_tints];
+				const bool mirrored = (c / 5) % 2 != 0;
+				const Size sz(spr_width * zoom / 100, spr_height * zoom / 100);
+
+				TransformedSpriteCache::Key key;
+				key.sppic = mirrored ? -(spr + 1) : spr + 1;
+				key.zoom = zoom;
+				key.tintr = tint[0];
+				key.tintg = tint[1];
+				key.tintb = tint[2];
+				key.tintamnt = tint[3];
+				key.tintlight = tint[4];
+				key.mirrored = mirrored;
+
+				Bitmap *image = use_cache ? cache.Get(key) : nullptr;
+				if (image) {
+					recycle_bitmap(out, image->GetColorDepth(), image->GetWidth(), image->GetHeight());
+					out->Blit(image, 0, 0);
+					image = out.get();
+				} else {
+					image = benchmark_draw_character(sprites[spr].get(), sz, mirrored, tint[0], tint[1], tint[2],
+						tint[3], tint[4], scaled, out);
+					if (use_cache)
+						cache.Put(key, image);
+				}
+
+				if (frame == num_frames - 1) {
+					if (!use_cache)
+						last_frame[c].reset(BitmapHelper::CreateBitmapCopy(image));
+					else if (!benchmark_same_image(last_frame[c].get(), image))
+						result.Identical = false;
+				}
+			}
+		}
+		const uint32_t elapsed = g_system->getMillis() - start;
+		if (use_cache)
+			result.CachedTime = elapsed;
+		else
+			result.UncachedTime = elapsed;
+	}
+	result.Hits = cache.GetHits();
+	result.Misses = cache.GetMisses();
+}
+
 
 
 
@@ -1611,33 +1804,59 @@ void prepare_characters_for_drawing() {
 		// * it's a software renderer, otherwise
 		// * the walk-behind method is DrawOverCharSprite
 		if (((!_G(gfxDriver)->HasAcceleratedTransform()) || (_G(walkBehindMethod) == DrawOverCharSprite)) && !_GP(charcache)[aa].in_use) {
-			// create the base sprite in _GP(actsps)[useindx], which will
-			// be scaled and/or flipped, as appropriate
-			bool actspsUsed = false;
-			if (!_G(gfxDriver)->HasAcceleratedTransform()) {
-				actspsUsed = scale_and_flip_sprite(useindx, sppic, newwidth, newheight, isMirrored);
-			}
-			if (!actspsUsed) {
-				// ensure actsps exists // CHECKME: why do we need this in hardware accel mode too?
-				recycle_bitmap(actsp.Bmp, coldept, src_sprwidth, src_sprheight);
-			}
+			// see if another character, or this one earlier, already made this image
+			TransformedSpriteCache::Key transformKey;
+			transformKey.sppic = specialpic;
+			transformKey.zoom = zoom_level;
+			transformKey.tintr = tint_red;
+			transformKey.tintg = tint_green;
+			transformKey.tintb = tint_blue;
+			transformKey.tintamnt = tint_amount;
+			transformKey.tintlight = tint_light;
+			transformKey.lightlev = light_level;
+			transformKey.mirrored = isMirrored;
+			Bitmap *transformed = nullptr;
+			if (!_G(gfxDriver)->HasAcceleratedTransform())
+				transformed = _GP(transformedSpriteCache).Get(transformKey);
+
+			if (transformed) {
+				recycle_bitmap(actsp.Bmp, transformed->GetColorDepth(), transformed->GetWidth(), transformed->GetHeight());
+				actsp.Bmp->Blit(transformed, 0, 0);
+			} else {
+				// create the base sprite in _GP(actsps)[useindx], which will
+				// be scaled and/or flipped, as appropriate
+				bool actspsUsed = false;
+				if (!_G(gfxDriver)->HasAcceleratedTransform()) {
+					actspsUsed = scale_and_flip_sprite(useindx, sppic, newwidth, newheight, isMirrored);
+				}
+				if (!actspsUsed) {
+					// ensure actsps exists // CHECKME: why do we need this in hardware accel mode too?
+					recycle_bitmap(actsp.Bmp, coldept, src_sprwidth, src_sprheight);
+				}
+
+				_G(our_eip) = 335;
+
+				bool tinted = false;
+				if (((light_level != 0) || (tint_amount != 0)) &&
+				        (!_G(gfxDriver)->HasAcceleratedTransform())) {
+					// apply the lightning or tinting
+					Bitmap *comeFrom = nullptr;
+					// if possible, direct read from the source image
+					if (!actspsUsed)
+						comeFrom = _GP(spriteset)[sppic];
+
+					apply_tint_or_light(useindx, light_level, tint_amount, tint_red,
+					                    tint_green, tint_blue, tint_light, coldept,
+					                    comeFrom);
+					tinted = true;
+				} else if (!actspsUsed) {
+					// no scaling, flipping or tinting was done, so just blit it normally
+					actsp.Bmp->Blit(_GP(spriteset)[sppic], 0, 0);
+				}
 
-			_G(our_eip) = 335;
-
-			if (((light_level != 0) || (tint_amount != 0)) &&
-			        (!_G(gfxDriver)->HasAcceleratedTransform())) {
-				// apply the lightning or tinting
-				Bitmap *comeFrom = nullptr;
-				// if possible, direct read from the source image
-				if (!actspsUsed)
-					comeFrom = _GP(spriteset)[sppic];
-
-				apply_tint_or_light(useindx, light_level, tint_amount, tint_red,
-				                    tint_green, tint_blue, tint_light, coldept,
-				                    comeFrom);
-			} else if (!actspsUsed) {
-				// no scaling, flipping or tinting was done, so just blit it normally
-				actsp.Bmp->Blit(_GP(spriteset)[sppic], 0, 0);
+				// only remember the images which took some work to make
+				if (actspsUsed || tinted)
+					_GP(transformedSpriteCache).Put(transformKey, actsp.Bmp.get());
 			}
 
 			// update the character cache with the new image
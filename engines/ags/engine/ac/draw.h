@@ -22,6 +22,7 @@
 #ifndef AGS_ENGINE_AC_DRAW_H
 #define AGS_ENGINE_AC_DRAW_H
 
+#include "ags/lib/std/map.h"
 #include "ags/lib/std/memory.h"
 #include "ags/shared/core/types.h"
 #include "ags/shared/ac/common_defines.h"
@@ -98,6 +99,73 @@ struct ObjectCache {
 	int   x = 0, y = 0;
 };
 
+// TransformedSpriteCache keeps scaled, flipped, tinted and lit copies of the
+// sprites, shared by all the characters. Unlike ObjectCache, which only
+// remembers the last image of each character, this lets animated characters,
+// and several characters using the same sprite and light, reuse the result.
+// Used for software render mode only.
+class TransformedSpriteCache {
+public:
+	struct Key {
+		int   sppic = 0;
+		short zoom = 0;
+		short tintr = 0, tintg = 0, tintb = 0, tintamnt = 0, tintlight = 0;
+		short lightlev = 0;
+		bool  mirrored = false;
+
+		bool operator==(const Key &other) const;
+	};
+
+	TransformedSpriteCache() = default;
+	~TransformedSpriteCache();
+
+	// Sets the memory limit, in bytes
+	void SetMaxSize(size_t max_size);
+	// Returns the cached image, or nullptr if there is none
+	Shared::Bitmap *Get(const Key &key);
+	// Stores a copy of the image
+	void Put(const Key &key, Shared::Bitmap *image);
+	// Removes all the images made from the given sprite
+	void Invalidate(int sprnum);
+	void Clear();
+
+	size_t GetCount() const { return _items.size(); }
+	size_t GetSize() const { return _size; }
+	uint32_t GetHits() const { return _hits; }
+	uint32_t GetMisses() const { return _misses; }
+
+private:
+	struct KeyHash {
+		uint operator()(const Key &key) const;
+	};
+
+	struct Item {
+		Shared::Bitmap *Image = nullptr;
+		size_t Size = 0;
+		uint32_t LastUse = 0;
+	};
+
+	typedef std::unordered_map<Key, Item, KeyHash> ItemMap;
+
+	void FreeSpace(size_t needed);
+
+	ItemMap _items;
+	size_t _size = 0;
+	size_t _maxSize = 8 * 1024 * 1024;
+	uint32_t _useCounter = 0;
+	uint32_t _hits = 0;
+	uint32_t _misses = 0;
+};
+
+// Timings of benchmark_transform_cache(), in milliseconds
+struct TransformCacheBenchmark {
+	uint32_t UncachedTime = 0;
+	uint32_t CachedTime = 0;
+	uint32_t Hits = 0;
+	uint32_t Misses = 0;
+	bool Identical = true;
+};
+
 // Converts AGS color index to the actual bitmap color using game's color depth
 int MakeColor(int color_index);
 
@@ -172,6 +240,10 @@ void debug_draw_movelist(int charnum);
 void update_room_debug();
 
 void tint_image(Shared::Bitmap *g, Shared::Bitmap *source, int red, int grn, int blu, int light_level, int luminance = 255);
+// Draws num_chars synthetic scaled, tinted and lit characters for num_frames
+// frames, once without and once with a TransformedSpriteCache, and times both.
+// Does not touch the game's own cache.
+void benchmark_transform_cache(int num_chars, int num_frames, TransformCacheBenchmark &result);
 void draw_sprite_support_alpha(Shared::Bitmap *ds, bool ds_has_alpha, int xpos, int ypos, Shared::Bitmap *image, bool src_has_alpha,
                                Shared::BlendMode blend_mode = Shared::kBlendMode_Alpha, int alpha = 0xFF);
 void draw_sprite_slot_support_alpha(Shared::Bitmap *ds, bool ds_has_alpha, int xpos, int ypos, int src_slot,
@@ -19,6 +19,7 @@
  *
  */
 
+#include "ags/lib/std/algorithm.h"
 #include "ags/lib/std/vector.h"
 #include "ags/engine/ac/dynobj/managed_object_pool.h"
 #include "ags/engine/ac/dynobj/cc_dynamic_array.h" // globalDynamicArray, constants
@@ -38,6 +39,16 @@ const auto SERIALIZE_BUFFER_SIZE = 10240;
 const auto GARBAGE_COLLECTION_INTERVAL = 1024;
 const auto RESERVED_SIZE = 2048;
 
+void ManagedObjectPool::Init(ManagedObject &o, int32_t theHandle, const char *theAddress, ICCDynamicObject *theCallback, ScriptValueType objType) {
+	o.obj_type = objType;
+	o.handle = theHandle;
+	o.addr = theAddress;
+	o.callback = theCallback;
+	o.refCount = 0;
+	o.generation = theHandle >> HANDLE_INDEX_BITS;
+	handleByAddress.insert({ theAddress, theHandle });
+}
+
 int ManagedObjectPool::Remove(ManagedObject &o, bool force) {
 	if (!o.isUsed()) {
 		return 1;
@@ -48,21 +59,39 @@ int ManagedObjectPool::Remove(ManagedObject &o, bool force) {
 		return 0;
 	}
 
-	available_ids.push(o.handle);
+	const int32_t handle = o.handle;
+	const int32_t generation = (o.generation + 1) & HANDLE_GENERATION_MASK;
+	freeSlots.push_back(HandleIndex(handle));
 	handleByAddress.erase(o.addr);
-	ManagedObjectLog("Line %d Disposed managed object handle=%d", currentline, o.handle);
+	ManagedObjectLog("Line %d Disposed managed object handle=%d", currentline, handle);
 	o = ManagedObject();
+	o.generation = generation;
 	return 1;
 }
 
-int32_t ManagedObjectPool::AddRef(int32_t handle) {
-	if (handle < 0 || (size_t)handle >= objects.size()) {
-		return 0;
+void ManagedObjectPool::CompactSlots() {
+	while (nextIndex > 1 && !objects[nextIndex - 1].isUsed()) {
+		nextIndex--;
 	}
-	auto &o = objects[handle];
-	if (!o.isUsed()) {
+	// Hand out the lowest slots first, so that the table stays dense
+	freeSlots.clear();
+	for (int32_t i = nextIndex - 1; i >= 1; i--) {
+		if (!objects[i].isUsed()) {
+			freeSlots.push_back(i);
+		}
+	}
+}
+
+int ManagedObjectPool::GetObjectCount() const {
+	return nextIndex - 1 - (int)freeSlots.size();
+}
+
+int32_t ManagedObjectPool::AddRef(int32_t handle) {
+	ManagedObject *obj = Resolve(handle);
+	if (!obj) {
 		return 0;
 	}
+	auto &o = *obj;
 
 	o.refCount += 1;
 	ManagedObjectLog("Line %d AddRef: handle=%d new refcount=%d", _G(currentline), o.handle, o.refCount);
@@ -70,13 +99,11 @@ int32_t ManagedObjectPool::AddRef(int32_t handle) {
 }
 
 int ManagedObjectPool::CheckDispose(int32_t handle) {
-	if (handle < 0 || (size_t)handle >= objects.size()) {
-		return 1;
-	}
-	auto &o = objects[handle];
-	if (!o.isUsed()) {
+	ManagedObject *obj = Resolve(handle);
+	if (!obj) {
 		return 1;
 	}
+	auto &o = *obj;
 	if (o.refCount >= 1) {
 		return 0;
 	}
@@ -84,13 +111,11 @@ int ManagedObjectPool::CheckDispose(int32_t handle) {
 }
 
 int32_t ManagedObjectPool::SubRef(int32_t handle) {
-	if (handle < 0 || (size_t)handle >= objects.size()) {
-		return 0;
-	}
-	auto &o = objects[handle];
-	if (!o.isUsed()) {
+	ManagedObject *obj = Resolve(handle);
+	if (!obj) {
 		return 0;
 	}
+	auto &o = *obj;
 
 	o.refCount--;
 	auto newRefCount = o.refCount;
@@ -116,25 +141,17 @@ int32_t ManagedObjectPool::AddressToHandle(const char *addr) {
 
 // this function is called often (whenever a pointer is used)
 const char *ManagedObjectPool::HandleToAddress(int32_t handle) {
-	if (handle < 0 || (size_t)handle >= objects.size()) {
-		return nullptr;
-	}
-	auto &o = objects[handle];
-	if (!o.isUsed()) {
-		return nullptr;
-	}
-	return o.addr;
+	const ManagedObject *o = Resolve(handle);
+	return o ? o->addr : nullptr;
 }
 
 // this function is called often (whenever a pointer is used)
 ScriptValueType ManagedObjectPool::HandleToAddressAndManager(int32_t handle, void *&object, ICCDynamicObject *&manager) {
-	if (handle < 0 || (size_t)handle >= objects.size()) {
-		return kScValUndefined;
-	}
-	auto &o = objects[handle];
-	if (!o.isUsed()) {
+	const ManagedObject *obj = Resolve(handle);
+	if (!obj) {
 		return kScValUndefined;
 	}
+	auto &o = *obj;
 
 	object = const_cast<char *>(o.addr);  // WARNING: This strips the const from the char* pointer.
 	manager = o.callback;
@@ -150,7 +167,7 @@ int ManagedObjectPool::RemoveObject(const char *address) {
 		return 0;
 	}
 
-	auto &o = objects[it->_value];
+	auto &o = objects[HandleIndex(it->_value)];
 	return Remove(o, true);
 }
 
@@ -163,7 +180,7 @@ void ManagedObjectPool::RunGarbageCollectionIfAppropriate() {
 }
 
 void ManagedObjectPool::RunGarbageCollection() {
-	for (int i = 1; i < nextHandle; i++) {
+	for (int i = 1; i < nextIndex; i++) {
 		auto &o = objects[i];
 		if (!o.isUsed()) {
 			continue;
@@ -172,31 +189,35 @@ void ManagedObjectPool::RunGarbageCollection() {
 			Remove(o);
 		}
 	}
+	CompactSlots();
 	ManagedObjectLog("Ran garbage collection");
 }
 
 int ManagedObjectPool::AddObject(const char *address, ICCDynamicObject *callback, bool plugin_object) {
-	int32_t handle;
+	int32_t index;
 
-	if (!available_ids.empty()) {
-		handle = available_ids.front();
-		available_ids.pop();
+	if (!freeSlots.empty()) {
+		index = freeSlots.back();
+		freeSlots.pop_back();
 	} else {
-		handle = nextHandle++;
-		if ((size_t)handle >= objects.size()) {
-			objects.resize(handle + 1024, ManagedObject());
+		if (nextIndex > HANDLE_INDEX_MASK) {
+			cc_error("Managed object pool is full");
+			return 0;
+		}
+		index = nextIndex++;
+		if ((size_t)index >= objects.size()) {
+			objects.resize(index + 1024, ManagedObject());
 		}
 	}
 
-	auto &o = objects[handle];
+	auto &o = objects[index];
 	if (o.isUsed()) {
-		cc_error("used: %d", handle);
+		cc_error("used: %d", o.handle);
 		return 0;
 	}
 
-	o = ManagedObject(plugin_object ? kScValPluginObject : kScValDynamicObject, handle, address, callback);
-
-	handleByAddress.insert({ address, o.handle });
+	const int32_t handle = (o.generation << HANDLE_INDEX_BITS) | index;
+	Init(o, handle, address, callback, plugin_object ? kScValPluginObject : kScValDynamicObject);
 	objectCreationCounter++;
 	ManagedObjectLog("Allocated managed object handle=%d, type=%s", handle, callback->GetType());
 	return o.handle;
@@ -204,23 +225,34 @@ int ManagedObjectPool::AddObject(const char *address, ICCDynamicObject *callback
 
 
 int ManagedObjectPool::AddUnserializedObject(const char *address, ICCDynamicObject *callback, bool plugin_object, int handle) {
-	if (handle < 0) {
+	if (handle <= 0) {
 		cc_error("Attempt to assign invalid handle: %d", handle);
 		return 0;
 	}
-	if ((size_t)handle >= objects.size()) {
-		objects.resize(handle + 1024, ManagedObject());
+	const int32_t index = HandleIndex(handle);
+	if ((size_t)index >= objects.size()) {
+		objects.resize(index + 1024, ManagedObject());
 	}
 
-	auto &o = objects[handle];
+	auto &o = objects[index];
 	if (o.isUsed()) {
 		cc_error("bad save. used: %d", o.handle);
 		return 0;
 	}
 
-	o = ManagedObject(plugin_object ? kScValPluginObject : kScValDynamicObject, handle, address, callback);
+	// keep the free list in sync, objects may be restored in any order
+	if (index >= nextIndex) {
+		for (int32_t i = nextIndex; i < index; i++) {
+			freeSlots.push_back(i);
+		}
+		nextIndex = index + 1;
+	} else {
+		auto freeSlot = std::find(freeSlots.begin(), freeSlots.end(), index);
+		if (freeSlot != freeSlots.end())
+			freeSlots.erase(freeSlot);
+	}
 
-	handleByAddress.insert({ address, o.handle });
+	Init(o, handle, address, callback, plugin_object ? kScValPluginObject : kScValDynamicObject);
 	ManagedObjectLog("Allocated unserialized managed object handle=%d, type=%s", o.handle, callback->GetType());
 	return o.handle;
 }
@@ -237,7 +269,7 @@ void ManagedObjectPool::WriteToDisk(Stream *out) {
 	out->WriteInt32(2);  // version
 
 	int size = 0;
-	for (int i = 1; i < nextHandle; i++) {
+	for (int i = 1; i < nextIndex; i++) {
 		auto const &o = objects[i];
 		if (o.isUsed()) {
 			size += 1;
@@ -245,7 +277,7 @@ void ManagedObjectPool::WriteToDisk(Stream *out) {
 	}
 	out->WriteInt32(size);
 
-	for (int i = 1; i < nextHandle; i++) {
+	for (int i = 1; i < nextIndex; i++) {
 		auto const &o = objects[i];
 		if (!o.isUsed()) {
 			continue;
@@ -300,7 +332,11 @@ int ManagedObjectPool::ReadFromDisk(Stream *in, ICCObjectReader *reader) {
 				} else {
 					reader->Unserialize(i, typeNameBuffer, &serializeBuffer.front(), numBytes);
 				}
-				objects[i].refCount = in->ReadInt32();
+				if (ManagedObject *o = Resolve(i)) {
+					o->refCount = in->ReadInt32();
+				} else {
+					in->ReadInt32();
+				}
 				ManagedObjectLog("Read handle = %d", objects[i].handle);
 			}
 		}
@@ -324,7 +360,11 @@ int ManagedObjectPool::ReadFromDisk(Stream *in, ICCObjectReader *reader) {
 			} else {
 				reader->Unserialize(handle, typeNameBuffer, &serializeBuffer.front(), numBytes);
 			}
-			objects[handle].refCount = in->ReadInt32();
+			if (ManagedObject *o = Resolve(handle)) {
+				o->refCount = in->ReadInt32();
+			} else {
+				in->ReadInt32();
+			}
 			ManagedObjectLog("Read handle = %d", objects[i].handle);
 		}
 	}
@@ -334,42 +374,26 @@ int ManagedObjectPool::ReadFromDisk(Stream *in, ICCObjectReader *reader) {
 		return -1;
 	}
 
-	// re-adjust next handles. (in case saved in random order)
-	while (!available_ids.empty()) {
-		available_ids.pop();
-	}
-	nextHandle = 1;
-
-	for (const auto &o : objects) {
-		if (o.isUsed()) {
-			nextHandle = o.handle + 1;
-		}
-	}
-	for (int i = 1; i < nextHandle; i++) {
-		if (!objects[i].isUsed()) {
-			available_ids.push(i);
-		}
-	}
+	// reorder the free slots, so that the lowest ones get reused first
+	CompactSlots();
 
 	return 0;
 }
 
 // de-allocate all objects
 void ManagedObjectPool::reset() {
-	for (int i = 1; i < nextHandle; i++) {
+	for (int i = 1; i < nextIndex; i++) {
 		auto &o = objects[i];
 		if (!o.isUsed()) {
 			continue;
 		}
 		Remove(o, true);
 	}
-	while (!available_ids.empty()) {
-		available_ids.pop();
-	}
-	nextHandle = 1;
+	freeSlots.clear();
+	nextIndex = 1;
 }
 
-ManagedObjectPool::ManagedObjectPool() : objectCreationCounter(0), nextHandle(1), available_ids(), objects(RESERVED_SIZE, ManagedObject()), handleByAddress() {
+ManagedObjectPool::ManagedObjectPool() : objectCreationCounter(0), nextIndex(1), freeSlots(), objects(RESERVED_SIZE, ManagedObject()), handleByAddress() {
 	handleByAddress.reserve(RESERVED_SIZE);
 }
 
@@ -23,7 +23,6 @@
 #define AGS_ENGINE_AC_DYNOBJ_CC_MANAGED_OBJECT_POOL_H
 
 #include "ags/lib/std/vector.h"
-#include "ags/lib/std/queue.h"
 #include "ags/lib/std/map.h"
 
 #include "ags/shared/core/platform.h"
@@ -47,6 +46,10 @@ struct Pointer_Hash {
 };
 
 
+// Managed objects are kept in a table of slots. A script handle is made of
+// the slot index and a generation counter, which is increased every time the
+// slot is freed: a stale handle that still refers to a reused slot is then
+// rejected instead of resolving to the new object.
 struct ManagedObjectPool final {
 private:
 	// TODO: find out if we can make handle size_t
@@ -58,30 +61,50 @@ private:
 		const char *addr;
 		ICCDynamicObject *callback;
 		int refCount;
+		// generation of the slot, survives the removal of the object
+		int32_t generation;
 
 		bool isUsed() const {
 			return obj_type != kScValUndefined;
 		}
 
 		ManagedObject() : obj_type(kScValUndefined), handle(0), addr(nullptr),
-			callback(nullptr), refCount(0) {
-		}
-		ManagedObject(ScriptValueType theType, int32_t theHandle,
-		              const char *theAddr, ICCDynamicObject *theCallback)
-			: obj_type(theType), handle(theHandle), addr(theAddr),
-			  callback(theCallback), refCount(0) {
+			callback(nullptr), refCount(0), generation(0) {
 		}
 	};
 
+	// handle = generation << HANDLE_INDEX_BITS | slot index; handles stay positive
+	static const int HANDLE_INDEX_BITS = 22;
+	static const int32_t HANDLE_INDEX_MASK = (1 << HANDLE_INDEX_BITS) - 1;
+	static const int32_t HANDLE_GENERATION_MASK = (1 << (31 - HANDLE_INDEX_BITS)) - 1;
+
 	int objectCreationCounter;  // used to do garbage collection every so often
 
-	int32_t nextHandle{}; // TODO: manage nextHandle's going over INT32_MAX !
-	std::queue<int32_t> available_ids;
+	int32_t nextIndex; // first slot which was never used since the last compaction
+	std::vector<int32_t> freeSlots; // free slots below nextIndex, the last one is reused first
 	std::vector<ManagedObject> objects;
 	std::unordered_map<const char *, int32_t, Pointer_Hash> handleByAddress;
 
-	void Init(int32_t theHandle, const char *theAddress, ICCDynamicObject *theCallback, ScriptValueType objType);
+	static inline int32_t HandleIndex(int32_t handle) {
+		return handle & HANDLE_INDEX_MASK;
+	}
+
+	// Returns the object referenced by the handle, or null if the handle is invalid or stale
+	inline ManagedObject *Resolve(int32_t handle) {
+		if (handle <= 0 || (size_t)HandleIndex(handle) >= objects.size()) {
+			return nullptr;
+		}
+		ManagedObject &o = objects[HandleIndex(handle)];
+		if (!o.isUsed() || o.handle != handle) {
+			return nullptr;
+		}
+		return &o;
+	}
+
+	void Init(ManagedObject &o, int32_t theHandle, const char *theAddress, ICCDynamicObject *theCallback, ScriptValueType objType);
 	int Remove(ManagedObject &o, bool force = false);
+	// Drops the unused slots at the end of the table and rebuilds the free list
+	void CompactSlots();
 
 	void RunGarbageCollection();
 
@@ -102,6 +125,12 @@ public:
 	void reset();
 	ManagedObjectPool();
 
+	// Number of registered objects, and number of slots in use (including free ones)
+	int GetObjectCount() const;
+	int GetSlotCount() const {
+		return nextIndex - 1;
+	}
+
 	const char *disableDisposeForObject{ nullptr };
 };
 
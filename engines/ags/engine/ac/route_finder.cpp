@@ -42,6 +42,9 @@ public:
 	void set_wallscreen(Bitmap *wallscreen) override {
 		AGS::Engine::RouteFinder::set_wallscreen(wallscreen);
 	}
+	void set_walkablemask(Bitmap *walkablemask) override {
+		AGS::Engine::RouteFinder::set_walkablemask(walkablemask);
+	}
 	int can_see_from(int x1, int y1, int x2, int y2) override {
 		return AGS::Engine::RouteFinder::can_see_from(x1, y1, x2, y2);
 	}
@@ -69,6 +72,9 @@ public:
 	void set_wallscreen(Bitmap *wallscreen) override {
 		AGS::Engine::RouteFinderLegacy::set_wallscreen(wallscreen);
 	}
+	void set_walkablemask(Bitmap *walkablemask) override {
+		// the legacy path finder does not precompute anything
+	}
 	int can_see_from(int x1, int y1, int x2, int y2) override {
 		return AGS::Engine::RouteFinderLegacy::can_see_from(x1, y1, x2, y2);
 	}
@@ -104,6 +110,11 @@ void set_wallscreen(Bitmap *wallscreen) {
 	_GP(route_finder_impl)->set_wallscreen(wallscreen);
 }
 
+void set_walkablemask(Bitmap *walkablemask) {
+	if (_GP(route_finder_impl))
+		_GP(route_finder_impl)->set_walkablemask(walkablemask);
+}
+
 int can_see_from(int x1, int y1, int x2, int y2) {
 	return _GP(route_finder_impl)->can_see_from(x1, y1, x2, y2);
 }
@@ -43,6 +43,7 @@ public:
 	virtual void init_pathfinder() = 0;
 	virtual void shutdown_pathfinder() = 0;
 	virtual void set_wallscreen(AGS::Shared::Bitmap *wallscreen) = 0;
+	virtual void set_walkablemask(AGS::Shared::Bitmap *walkablemask) = 0;
 	virtual int can_see_from(int x1, int y1, int x2, int y2) = 0;
 	virtual void get_lastcpos(int &lastcx, int &lastcy) = 0;
 	virtual int find_route(short srcx, short srcy, short xx, short yy, int move_speed_x, int move_speed_y, AGS::Shared::Bitmap *onscreen, int movlst, int nocross = 0, int ignore_walls = 0) = 0;
@@ -53,6 +54,8 @@ void init_pathfinder(GameDataVersion game_file_version);
 void shutdown_pathfinder();
 
 void set_wallscreen(AGS::Shared::Bitmap *wallscreen);
+// Tells the path finder that the room walkable areas have changed
+void set_walkablemask(AGS::Shared::Bitmap *walkablemask);
 
 int can_see_from(int x1, int y1, int x2, int y2);
 void get_lastcpos(int &lastcx, int &lastcy);
@@ -0,0 +1,410 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ags/lib/std/algorithm.h"
+#include "ags/engine/ac/route_finder_hpa.h"
+#include "ags/engine/ac/route_finder_jps.h"
+
+namespace AGS3 {
+
+// entrances shorter than this get a single node in their middle,
+// longer ones get a node at both ends
+static const int MAX_SINGLE_ENTRANCE = 6;
+
+NavGraph::NavGraph()
+	: mapWidth(0)
+	, mapHeight(0)
+	, clustersX(0)
+	, clustersY(0)
+	, dirty(false)
+	, searchId(0) {
+}
+
+void NavGraph::SetMap(int width, int height, const unsigned char *const *rows) {
+	mapWidth = width;
+	mapHeight = height;
+	walkable.resize(width * height);
+
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++)
+			walkable[y * width + x] = rows[y][x] != 0 ? 1 : 0;
+	}
+
+	dirty = true;
+}
+
+void NavGraph::Clear() {
+	mapWidth = mapHeight = 0;
+	clustersX = clustersY = 0;
+	walkable.clear();
+	nodes.clear();
+	edges.clear();
+	clusterFirst.clear();
+	clusterNodes.clear();
+	dirty = false;
+}
+
+void NavGraph::Update() {
+	if (dirty) {
+		Build();
+		dirty = false;
+	}
+}
+
+int NavGraph::AddNode(int x, int y) {
+	const int cell = y * mapWidth + x;
+	Common::HashMap<int, int>::const_iterator it = cellNodes.find(cell);
+	if (it != cellNodes.end())
+		return it->_value;
+
+	Node node;
+	node.x = x;
+	node.y = y;
+	node.cluster = ClusterOf(x, y);
+	node.index = 0;
+	node.firstEdge = 0;
+	node.edgeCount = 0;
+	nodes.push_back(node);
+
+	const int id = (int)nodes.size() - 1;
+	cellNodes[cell] = id;
+	return id;
+}
+
+void NavGraph::AddEntrances(int x0, int y0, int dx, int dy, int length, int ox, int oy) {
+	int runStart = -1;
+
+	for (int i = 0; i <= length; i++) {
+		const int x = x0 + dx * i;
+		const int y = y0 + dy * i;
+		const bool open = i < length && Walkable(x, y) && Walkable(x + ox, y + oy);
+
+		if (open) {
+			if (runStart < 0)
+				runStart = i;
+			continue;
+		}
+
+		if (runStart < 0)
+			continue;
+
+		// the run of open cells is [runStart, i)
+		int ends[2];
+		int count;
+		if (i - runStart < MAX_SINGLE_ENTRANCE) {
+			ends[0] = (runStart + i - 1) / 2;
+			count = 1;
+		} else {
+			ends[0] = runStart;
+			ends[1] = i - 1;
+			count = 2;
+		}
+
+		for (int e = 0; e < count; e++) {
+			const int ex = x0 + dx * ends[e];
+			const int ey = y0 + dy * ends[e];
+			interEdges.push_back(AddNode(ex, ey));
+			interEdges.push_back(AddNode(ex + ox, ey + oy));
+		}
+
+		runStart = -1;
+	}
+}
+
+void NavGraph::ClusterDistances(int x, int y, std::vector<int> &dist) {
+	const int cluster = ClusterOf(x, y);
+	const int left = (cluster % clustersX) * CLUSTER_SIZE;
+	const int top = (cluster / clustersX) * CLUSTER_SIZE;
+	const int right = MIN(left + CLUSTER_SIZE, mapWidth);
+	const int bottom = MIN(top + CLUSTER_SIZE, mapHeight);
+	const int w = right - left;
+
+	// breadth first search, using the same orthogonal moves as the navigation
+	bfsDist.resize(CLUSTER_SIZE * CLUSTER_SIZE);
+	for (int i = 0; i < (int)bfsDist.size(); i++)
+		bfsDist[i] = -1;
+
+	bfsQueue.clear();
+	bfsDist[(y - top) * w + (x - left)] = 0;
+	bfsQueue.push_back(Navigation::PackSquare(x, y));
+
+	for (int head = 0; head < (int)bfsQueue.size(); head++) {
+		int cx, cy;
+		Navigation::UnpackSquare(bfsQueue[head], cx, cy);
+		const int d = bfsDist[(cy - top) * w + (cx - left)] + 1;
+
+		static const int dirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+		for (int i = 0; i < 4; i++) {
+			const int nx = cx + dirs[i][0];
+			const int ny = cy + dirs[i][1];
+
+			if (nx < left || nx >= right || ny < top || ny >= bottom)
+				continue;
+			if (!Walkable(nx, ny) || bfsDist[(ny - top) * w + (nx - left)] >= 0)
+				continue;
+
+			bfsDist[(ny - top) * w + (nx - left)] = d;
+			bfsQueue.push_back(Navigation::PackSquare(nx, ny));
+		}
+	}
+
+	const int first = clusterFirst[cluster];
+	const int count = clusterFirst[cluster + 1] - first;
+	dist.resize(count);
+	for (int i = 0; i < count; i++) {
+		const Node &node = nodes[clusterNodes[first + i]];
+		dist[i] = bfsDist[(node.y - top) * w + (node.x - left)];
+	}
+}
+
+void NavGraph::Build() {
+	clustersX = (mapWidth + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+	clustersY = (mapHeight + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+
+	nodes.clear();
+	edges.clear();
+	interEdges.clear();
+	cellNodes.clear();
+
+	// find the entrances on the borders between the clusters
+	for (int cy = 0; cy < clustersY; cy++) {
+		for (int cx = 0; cx < clustersX; cx++) {
+			const int left = cx * CLUSTER_SIZE;
+			const int top = cy * CLUSTER_SIZE;
+			const int right = MIN(left + CLUSTER_SIZE, mapWidth);
+			const int bottom = MIN(top + CLUSTER_SIZE, mapHeight);
+
+			// with the cluster on the right
+			if (right < mapWidth)
+				AddEntrances(right - 1, top, 0, 1, bottom - top, 1, 0);
+			// with the cluster below
+			if (bottom < mapHeight)
+				AddEntrances(left, bottom - 1, 1, 0, right - left, 0, 1);
+		}
+	}
+
+	cellNodes.clear();
+
+	// group the nodes by cluster
+	const int clusterCount = clustersX * clustersY;
+	clusterFirst.resize(clusterCount + 1);
+	for (int i = 0; i <= clusterCount; i++)
+		clusterFirst[i] = 0;
+	for (int i = 0; i < (int)nodes.size(); i++)
+		clusterFirst[nodes[i].cluster + 1]++;
+	for (int i = 0; i < clusterCount; i++)
+		clusterFirst[i + 1] += clusterFirst[i];
+
+	clusterNodes.resize(nodes.size());
+	std::vector<int> fill;
+	fill.resize(clusterCount, 0);
+	for (int i = 0; i < (int)nodes.size(); i++) {
+		Node &node = nodes[i];
+		node.index = fill[node.cluster]++;
+		clusterNodes[clusterFirst[node.cluster] + node.index] = i;
+	}
+
+	// link the crossings to the neighbouring clusters to their nodes
+	std::vector<int> crossHead, crossNext;
+	crossHead.resize(nodes.size(), -1);
+	crossNext.resize(interEdges.size(), -1);
+	for (int i = 0; i < (int)interEdges.size(); i++) {
+		crossNext[i] = crossHead[interEdges[i]];
+		crossHead[interEdges[i]] = i;
+	}
+
+	// the edges of each node are the crossings to the neighbouring clusters,
+	// and the walks to the other nodes of the same cluster
+	std::vector<int> dist;
+	for (int i = 0; i < (int)nodes.size(); i++) {
+		Node &node = nodes[i];
+		node.firstEdge = (int)edges.size();
+
+		for (int j = crossHead[i]; j >= 0; j = crossNext[j]) {
+			Edge edge;
+			// the two nodes of a crossing are stored next to each other
+			edge.to = interEdges[j ^ 1];
+			edge.cost = 1;
+			edges.push_back(edge);
+		}
+
+		ClusterDistances(node.x, node.y, dist);
+		const int first = clusterFirst[node.cluster];
+		for (int j = 0; j < (int)dist.size(); j++) {
+			if (j == node.index || dist[j] < 0)
+				continue;
+
+			Edge edge;
+			edge.to = clusterNodes[first + j];
+			edge.cost = dist[j];
+			edges.push_back(edge);
+		}
+
+		node.edgeCount = (int)edges.size() - node.firstEdge;
+	}
+
+	interEdges.clear();
+
+	gCost.resize(nodes.size() + 1);
+	prevNode.resize(nodes.size() + 1);
+	visitId.resize(nodes.size() + 1);
+	for (int i = 0; i < (int)visitId.size(); i++)
+		visitId[i] = 0;
+	searchId = 0;
+}
+
+void NavGraph::HeapPush(int cost, int node) {
+	HeapEntry entry;
+	entry.cost = cost;
+	entry.node = node;
+	heap.push_back(entry);
+
+	int i = (int)heap.size() - 1;
+	while (i > 0) {
+		const int parent = (i - 1) / 2;
+		if (heap[parent].cost <= heap[i].cost)
+			break;
+		SWAP(heap[parent], heap[i]);
+		i = parent;
+	}
+}
+
+NavGraph::HeapEntry NavGraph::HeapPop() {
+	const HeapEntry top = heap[0];
+	heap[0] = heap.back();
+	heap.pop_back();
+
+	const int size = (int)heap.size();
+	int i = 0;
+	for (;;) {
+		const int l = i * 2 + 1;
+		const int r = l + 1;
+		int smallest = i;
+		if (l < size && heap[l].cost < heap[smallest].cost)
+			smallest = l;
+		if (r < size && heap[r].cost < heap[smallest].cost)
+			smallest = r;
+		if (smallest == i)
+			break;
+		SWAP(heap[smallest], heap[i]);
+		i = smallest;
+	}
+
+	return top;
+}
+
+bool NavGraph::FindRoute(int sx, int sy, int ex, int ey, std::vector<int> &waypoints) {
+	waypoints.clear();
+	Update();
+
+	if (IsEmpty() || nodes.empty())
+		return false;
+	if ((unsigned)sx >= (unsigned)mapWidth || (unsigned)sy >= (unsigned)mapHeight ||
+	        (unsigned)ex >= (unsigned)mapWidth || (unsigned)ey >= (unsigned)mapHeight)
+		return false;
+	if (!Walkable(sx, sy) || !Walkable(ex, ey))
+		return false;
+
+	const int startCluster = ClusterOf(sx, sy);
+	const int goalCluster = ClusterOf(ex, ey);
+	if (startCluster == goalCluster)
+		return false;
+
+	ClusterDistances(sx, sy, startCost);
+	ClusterDistances(ex, ey, goalCost);
+
+	if (++searchId == 0) {
+		for (int i = 0; i < (int)visitId.size(); i++)
+			visitId[i] = 0;
+		searchId = 1;
+	}
+
+	// the goal is an extra node, after the graph ones
+	const int goal = (int)nodes.size();
+	heap.clear();
+
+	const int startFirst = clusterFirst[startCluster];
+	for (int i = 0; i < (int)startCost.size(); i++) {
+		if (startCost[i] < 0)
+			continue;
+
+		const int n = clusterNodes[startFirst + i];
+		visitId[n] = searchId;
+		gCost[n] = startCost[i];
+		prevNode[n] = -1;
+		HeapPush(gCost[n] + ABS(nodes[n].x - ex) + ABS(nodes[n].y - ey), n);
+	}
+
+	bool found = false;
+	while (!heap.empty()) {
+		const HeapEntry entry = HeapPop();
+		const int n = entry.node;
+
+		if (n == goal) {
+			found = true;
+			break;
+		}
+
+		const Node &node = nodes[n];
+		const int g = gCost[n];
+		// skip the outdated entries
+		if (entry.cost != g + ABS(node.x - ex) + ABS(node.y - ey))
+			continue;
+
+		if (node.cluster == goalCluster && goalCost[node.index] >= 0) {
+			const int cost = g + goalCost[node.index];
+			if (visitId[goal] != searchId || cost < gCost[goal]) {
+				visitId[goal] = searchId;
+				gCost[goal] = cost;
+				prevNode[goal] = n;
+				HeapPush(cost, goal);
+			}
+		}
+
+		for (int i = 0; i < node.edgeCount; i++) {
+			const Edge &edge = edges[node.firstEdge + i];
+			const int cost = g + edge.cost;
+			if (visitId[edge.to] == searchId && cost >= gCost[edge.to])
+				continue;
+
+			visitId[edge.to] = searchId;
+			gCost[edge.to] = cost;
+			prevNode[edge.to] = n;
+			HeapPush(cost + ABS(nodes[edge.to].x - ex) + ABS(nodes[edge.to].y - ey), edge.to);
+		}
+	}
+
+	if (!found)
+		return false;
+
+	// walk back from the goal, keeping the nodes where a new cluster is entered
+	waypoints.push_back(Navigation::PackSquare(ex, ey));
+	for (int n = prevNode[goal]; n >= 0; n = prevNode[n]) {
+		const int prev = prevNode[n];
+		if (prev >= 0 && nodes[prev].cluster != nodes[n].cluster)
+			waypoints.push_back(Navigation::PackSquare(nodes[n].x, nodes[n].y));
+	}
+
+	std::reverse(waypoints.begin(), waypoints.end());
+	return true;
+}
+
+} // namespace AGS3
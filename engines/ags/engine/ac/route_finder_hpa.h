@@ -0,0 +1,148 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//=============================================================================
+//
+// Hierarchical path abstraction (HPA*) on top of the JPS navigation.
+//
+// The walkable mask is split into square clusters. Cells where two
+// neighbouring clusters touch become entrances, and the walking distances
+// between the entrances of each cluster are computed once. A route request
+// first searches this small graph, then the JPS navigation only has to find
+// the short paths from one cluster entrance to the next.
+//
+// Reference: Near Optimal Hierarchical Path-Finding (Botea, Muller, Schaeffer)
+//
+//=============================================================================
+
+#ifndef AGS_ENGINE_AC_ROUTE_FINDER_HPA_H
+#define AGS_ENGINE_AC_ROUTE_FINDER_HPA_H
+
+#include "ags/lib/std/vector.h"
+#include "common/hashmap.h"
+
+namespace AGS3 {
+
+class NavGraph {
+public:
+	// size of the clusters, in mask pixels
+	static const int CLUSTER_SIZE = 32;
+
+	NavGraph();
+
+	// Copies the walkable mask; the graph is rebuilt on the next route request.
+	// Rows are mask scanlines, non-zero pixels are walkable.
+	void SetMap(int width, int height, const unsigned char *const *rows);
+	// Forgets the map, route requests are then handled by plain JPS
+	void Clear();
+
+	inline bool IsEmpty() const {
+		return mapWidth == 0 || mapHeight == 0;
+	}
+	inline int GetWidth() const {
+		return mapWidth;
+	}
+	inline int GetHeight() const {
+		return mapHeight;
+	}
+
+	// Builds the cluster graph, if the map changed since the last time
+	void Update();
+
+	// Finds a route through the cluster graph and returns the cells where
+	// it enters a new cluster, followed by the end point (packed squares).
+	// Returns false if both points are in the same cluster, or if no route
+	// exists in the graph.
+	bool FindRoute(int sx, int sy, int ex, int ey, std::vector<int> &waypoints);
+
+	inline int GetNodeCount() const {
+		return (int)nodes.size();
+	}
+	inline int GetEdgeCount() const {
+		return (int)edges.size();
+	}
+
+private:
+	struct Edge {
+		int to;
+		int cost;
+	};
+
+	struct Node {
+		int x, y;
+		int cluster;
+		// position in the node list of the cluster
+		int index;
+		// range in the edges array
+		int firstEdge, edgeCount;
+	};
+
+	struct HeapEntry {
+		int cost;
+		int node;
+	};
+
+	int mapWidth;
+	int mapHeight;
+	int clustersX;
+	int clustersY;
+	bool dirty;
+
+	std::vector<unsigned char> walkable;
+	std::vector<Node> nodes;
+	std::vector<Edge> edges;
+	// nodes of every cluster, clusterFirst[c] .. clusterFirst[c + 1]
+	std::vector<int> clusterFirst;
+	std::vector<int> clusterNodes;
+
+	// temporary buffers:
+	Common::HashMap<int, int> cellNodes;
+	std::vector<int> interEdges;
+	std::vector<int> bfsDist;
+	std::vector<int> bfsQueue;
+	std::vector<int> startCost;
+	std::vector<int> goalCost;
+	std::vector<int> gCost;
+	std::vector<int> prevNode;
+	std::vector<unsigned short> visitId;
+	unsigned short searchId;
+	std::vector<HeapEntry> heap;
+
+	inline bool Walkable(int x, int y) const {
+		return walkable[y * mapWidth + x] != 0;
+	}
+	inline int ClusterOf(int x, int y) const {
+		return (y / CLUSTER_SIZE) * clustersX + x / CLUSTER_SIZE;
+	}
+
+	void Build();
+	void AddEntrances(int x0, int y0, int dx, int dy, int length, int ox, int oy);
+	int AddNode(int x, int y);
+	// walking distances from x,y to all the nodes of its cluster, -1 if unreachable
+	void ClusterDistances(int x, int y, std::vector<int> &dist);
+
+	void HeapPush(int cost, int node);
+	HeapEntry HeapPop();
+};
+
+} // namespace AGS3
+
+#endif
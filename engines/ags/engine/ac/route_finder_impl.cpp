@@ -31,6 +31,7 @@
 #include "ags/shared/ac/common_defines.h"
 #include "ags/shared/gfx/bitmap.h"
 #include "ags/shared/debugging/out.h"
+#include "ags/engine/ac/route_finder_hpa.h"
 #include "ags/engine/ac/route_finder_jps.h"
 #include "ags/globals.h"
 
@@ -47,15 +48,31 @@ namespace RouteFinder {
 static const int MAXNAVPOINTS = MAXNEEDSTAGES;
 
 void init_pathfinder() {
+	_GP(nav).SetGraph(&_GP(navGraph));
 }
 
 void shutdown_pathfinder() {
+	_GP(nav).SetGraph(nullptr);
+	_GP(navGraph).Clear();
 }
 
 void set_wallscreen(Bitmap *wallscreen_) {
 	_G(wallscreen) = wallscreen_;
 }
 
+void set_walkablemask(Bitmap *walkablemask) {
+	if (!walkablemask) {
+		_GP(navGraph).Clear();
+		return;
+	}
+
+	// the cluster graph is only rebuilt on the next route request
+	std::vector<const unsigned char *> rows(walkablemask->GetHeight());
+	for (int y = 0; y < walkablemask->GetHeight(); y++)
+		rows[y] = walkablemask->GetScanLine(y);
+	_GP(navGraph).SetMap(walkablemask->GetWidth(), walkablemask->GetHeight(), rows.data());
+}
+
 static void sync_nav_wallscreen() {
 	// FIXME: this is dumb, but...
 	_GP(nav).Resize(_G(wallscreen)->GetWidth(), _G(wallscreen)->GetHeight());
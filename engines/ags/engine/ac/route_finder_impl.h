@@ -43,6 +43,7 @@ void init_pathfinder();
 void shutdown_pathfinder();
 
 void set_wallscreen(AGS::Shared::Bitmap *wallscreen);
+void set_walkablemask(AGS::Shared::Bitmap *walkablemask);
 
 int can_see_from(int x1, int y1, int x2, int y2);
 void get_lastcpos(int &lastcx, int &lastcy);
@@ -26,153 +26,11 @@
 //
 //=============================================================================
 
-#include "ags/lib/std/queue.h"
-#include "ags/lib/std/vector.h"
-#include "ags/lib/std/algorithm.h"
-#include "ags/lib/std/functional.h"
-#include "ags/lib/std/xutility.h"
+#include "ags/engine/ac/route_finder_jps.h"
+#include "ags/engine/ac/route_finder_hpa.h"
 
 namespace AGS3 {
 
-// TODO: this could be cleaned up/simplified ...
-
-// further optimizations possible:
-//    - forward refinement should use binary search
-
-class Navigation {
-public:
-	Navigation();
-
-	void Resize(int width, int height);
-
-	enum NavResult {
-		// unreachable
-		NAV_UNREACHABLE,
-		// straight line exists
-		NAV_STRAIGHT,
-		// path used
-		NAV_PATH
-	};
-
-	// ncpath = navpoint-compressed path
-	// opath = path composed of individual grid elements
-	NavResult NavigateRefined(int sx, int sy, int ex, int ey, std::vector<int> &opath,
-	                          std::vector<int> &ncpath);
-
-	NavResult Navigate(int sx, int sy, int ex, int ey, std::vector<int> &opath);
-
-	bool TraceLine(int srcx, int srcy, int targx, int targy, int &lastValidX, int &lastValidY) const;
-	bool TraceLine(int srcx, int srcy, int targx, int targy, std::vector<int> *rpath = nullptr) const;
-
-	inline void SetMapRow(int y, const unsigned char *row) {
-		map[y] = row;
-	}
-
-	inline static int PackSquare(int x, int y);
-	inline static void UnpackSquare(int sq, int &x, int &y);
-
-private:
-	// priority queue entry
-	struct Entry {
-		float cost;
-		int index;
-
-		inline Entry() {}
-
-		inline Entry(float ncost, int nindex)
-			: cost(ncost)
-			, index(nindex) {
-		}
-
-		inline bool operator <(const Entry &b) const {
-			return cost < b.cost;
-		}
-
-		inline bool operator >(const Entry &b) const {
-			return cost > b.cost;
-		}
-	};
-
-	int mapWidth;
-	int mapHeight;
-	std::vector<const unsigned char *> map;
-
-	typedef unsigned short tFrameId;
-	typedef int tPrev;
-
-	struct NodeInfo {
-		// quantized min distance from origin
-		unsigned short dist;
-		// frame id (counter to detect new search)
-		tFrameId frameId;
-		// previous node index (packed, relative to current node)
-		tPrev prev;
-
-		inline NodeInfo()
-			: dist(0)
-			, frameId(0)
-			, prev(-1) {
-		}
-	};
-
-	static const float DIST_SCALE_PACK;
-	static const float DIST_SCALE_UNPACK;
-
-	std::vector<NodeInfo> mapNodes;
-	tFrameId frameId;
-
-	std::priority_queue<Entry, std::vector<Entry>, Common::Less<Entry> > pq;
-
-	// temporary buffers:
-	mutable std::vector<int> fpath;
-	std::vector<int> ncpathIndex;
-	std::vector<int> rayPath, orayPath;
-
-	// temps for routing towards unreachable areas
-	int cnode;
-	int closest;
-
-	// orthogonal only (this should correspond to what AGS is doing)
-	bool nodiag;
-
-	bool navLock;
-
-	void IncFrameId();
-
-	// outside map test
-	inline bool Outside(int x, int y) const;
-	// stronger inside test
-	bool Passable(int x, int y) const;
-	// plain access, unchecked
-	inline bool Walkable(int x, int y) const;
-
-	void AddPruned(int *buf, int &bcount, int x, int y) const;
-	bool HasForcedNeighbor(int x, int y, int dx, int dy) const;
-	int FindJump(int x, int y, int dx, int dy, int ex, int ey);
-	int FindOrthoJump(int x, int y, int dx, int dy, int ex, int ey);
-
-	// neighbor reachable (nodiag only)
-	bool Reachable(int x0, int y0, int x1, int y1) const;
-
-	static inline int sign(int n) {
-		return n < 0 ? -1 : (n > 0 ? 1 : 0);
-	}
-
-	static inline int iabs(int n) {
-		return n < 0 ? -n : n;
-	}
-
-	static inline int iclamp(int v, int min, int max) {
-		return v < min ? min : (v > max ? max : v);
-	}
-
-	static inline int ClosestDist(int dx, int dy) {
-		return dx * dx + dy * dy;
-		// Manhattan?
-		//return iabs(dx) + iabs(dy);
-	}
-};
-
 // Navigation
 
 // scale pack of 2 means we can route up to 32767 units (euclidean distance) from starting point
@@ -188,7 +46,8 @@ Navigation::Navigation()
 	, closest(0)
 	  // no diagonal route - this should correspond to what AGS does
 	, nodiag(true)
-	, navLock(false) {
+	, navLock(false)
+	, graph(nullptr) {
 }
 
 void Navigation::Resize(int width, int height) {
@@ -210,26 +69,6 @@ void Navigation::IncFrameId() {
 	}
 }
 
-inline int Navigation::PackSquare(int x, int y) {
-	return (y << 16) + x;
-}
-
-inline void Navigation::UnpackSquare(int sq, int &x, int &y) {
-	y = sq >> 16;
-	x = sq & ((1 << 16) - 1);
-}
-
-inline bool Navigation::Outside(int x, int y) const {
-	return
-	    (unsigned)x >= (unsigned)mapWidth ||
-	    (unsigned)y >= (unsigned)mapHeight;
-}
-
-inline bool Navigation::Walkable(int x, int y) const {
-	// invert condition because of AGS
-	return map[y][x] != 0;
-}
-
 bool Navigation::Passable(int x, int y) const {
 	return !Outside(x, y) && Walkable(x, y);
 }
@@ -616,11 +455,46 @@ Navigation::NavResult Navigation::Navigate(int sx, int sy, int ex, int ey, std::
 	return NAV_PATH;
 }
 
+Navigation::NavResult Navigation::NavigateHierarchical(int sx, int sy, int ex, int ey, std::vector<int> &opath) {
+	// the graph only knows the static mask, so the straight line
+	// and the unreachable cases are left to the plain search
+	if (!graph || graph->GetWidth() != mapWidth || graph->GetHeight() != mapHeight ||
+	        !Passable(sx, sy) || !Passable(ex, ey) || !TraceLine(sx, sy, ex, ey))
+		return Navigate(sx, sy, ex, ey, opath);
+
+	if (!graph->FindRoute(sx, sy, ex, ey, hpaWaypoints))
+		return Navigate(sx, sy, ex, ey, opath);
+
+	opath.clear();
+	opath.push_back(PackSquare(sx, sy));
+
+	for (int i = 0, fx = sx, fy = sy; i < (int)hpaWaypoints.size(); i++) {
+		int tx, ty;
+		UnpackSquare(hpaWaypoints[i], tx, ty);
+
+		// refine each step between two cluster entrances with JPS;
+		// an obstacle which is not in the graph (e.g. a character standing
+		// in a doorway) makes us fall back to the full search
+		NavResult res = Navigate(fx, fy, tx, ty, hpaSegment);
+		if (res == NAV_UNREACHABLE || hpaSegment.empty() ||
+		        hpaSegment[0] != PackSquare(fx, fy) || hpaSegment.back() != hpaWaypoints[i])
+			return Navigate(sx, sy, ex, ey, opath);
+
+		for (int j = 1; j < (int)hpaSegment.size(); j++)
+			opath.push_back(hpaSegment[j]);
+
+		fx = tx;
+		fy = ty;
+	}
+
+	return NAV_PATH;
+}
+
 Navigation::NavResult Navigation::NavigateRefined(int sx, int sy, int ex, int ey,
 	std::vector<int> &opath, std::vector<int> &ncpath) {
 	ncpath.clear();
 
-	NavResult res = Navigate(sx, sy, ex, ey, opath);
+	NavResult res = NavigateHierarchical(sx, sy, ex, ey, opath);
 
 	if (res != NAV_PATH) {
 		if (res == NAV_STRAIGHT) {
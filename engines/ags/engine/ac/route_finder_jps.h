@@ -19,6 +19,9 @@
  *
  */
 
+#ifndef AGS_ENGINE_AC_ROUTE_FINDER_JPS_H
+#define AGS_ENGINE_AC_ROUTE_FINDER_JPS_H
+
 #include "ags/lib/std/queue.h"
 #include "ags/lib/std/vector.h"
 #include "ags/lib/std/algorithm.h"
@@ -32,6 +35,8 @@
 
 namespace AGS3 {
 
+class NavGraph;
+
 // TODO: this could be cleaned up/simplified ...
 
 // further optimizations possible:
@@ -59,6 +64,12 @@ public:
 
 	NavResult Navigate(int sx, int sy, int ex, int ey, std::vector<int> &opath);
 
+	// Uses the cluster graph to split long routes into short JPS searches;
+	// the graph must have been made from the same mask, without the obstacles
+	inline void SetGraph(NavGraph *ngraph) {
+		graph = ngraph;
+	}
+
 	bool TraceLine(int srcx, int srcy, int targx, int targy, int &lastValidX, int &lastValidY) const;
 	bool TraceLine(int srcx, int srcy, int targx, int targy, std::vector<int> *rpath = nullptr) const;
 
@@ -119,12 +130,16 @@ private:
 	std::vector<NodeInfo> mapNodes;
 	tFrameId frameId;
 
-	std::priority_queue<Entry, std::vector<Entry>, Common::Greater<Entry> > pq;
+	std::priority_queue<Entry, std::vector<Entry>, Common::Less<Entry> > pq;
 
 	// temporary buffers:
 	mutable std::vector<int> fpath;
 	std::vector<int> ncpathIndex;
 	std::vector<int> rayPath, orayPath;
+	std::vector<int> hpaWaypoints, hpaSegment;
+
+	// optional cluster graph
+	NavGraph *graph;
 
 	// temps for routing towards unreachable areas
 	int cnode;
@@ -137,6 +152,8 @@ private:
 
 	void IncFrameId();
 
+	NavResult NavigateHierarchical(int sx, int sy, int ex, int ey, std::vector<int> &opath);
+
 	// outside map test
 	inline bool Outside(int x, int y) const;
 	// stronger inside test
@@ -192,3 +209,5 @@ inline bool Navigation::Walkable(int x, int y) const {
 }
 
 } // namespace AGS3
+
+#endif
@@ -28,6 +28,7 @@
 #include "ags/engine/ac/room.h"
 #include "ags/engine/ac/room_object.h"
 #include "ags/engine/ac/room_status.h"
+#include "ags/engine/ac/route_finder.h"
 #include "ags/engine/ac/walkable_area.h"
 #include "ags/shared/game/room_struct.h"
 #include "ags/shared/gfx/bitmap.h"
@@ -47,6 +48,7 @@ void redo_walkable_areas() {
 				walls_scanline[w] = 0;
 		}
 	}
+	set_walkablemask(_GP(thisroom).WalkAreaMask.get());
 }
 
 int get_walkable_area_pixel(int x, int y) {
@@ -48,6 +48,7 @@
 #include "ags/engine/ac/mouse.h"
 #include "ags/engine/ac/move_list.h"
 #include "ags/engine/ac/room_status.h"
+#include "ags/engine/ac/route_finder_hpa.h"
 #include "ags/engine/ac/route_finder_jps.h"
 #include "ags/engine/ac/screen_overlay.h"
 #include "ags/engine/ac/sprite_list_entry.h"
@@ -243,6 +244,7 @@ Globals::Globals() {
 	_charcache = new std::vector<ObjectCache>();
 	_objcache = new ObjectCache[MAX_ROOM_OBJECTS];
 	_screenovercache = new std::vector<Point>();
+	_transformedSpriteCache = new TransformedSpriteCache();
 	_charextra = new std::vector<CharacterExtras>();
 	_mls = new std::vector<MoveList>();
 	_views = new std::vector<ViewStruct>();
@@ -340,6 +342,7 @@ Globals::Globals() {
 	// route_finder_impl.cpp globals
 	_navpoints = new int32_t[MAXNEEDSTAGES];
 	_nav = new Navigation();
+	_navGraph = new NavGraph();
 	_route_finder_impl = new std::unique_ptr<IRouteFinder>();
 
 	// screen.cpp globals
@@ -506,6 +509,8 @@ Globals::~Globals() {
 	delete _charcache;
 	delete[] _objcache;
 	delete _screenovercache;
+	delete _transformedSpriteCache;
+	delete _tintScratchBmp;
 	delete _charextra;
 	delete _mls;
 	delete _views;
@@ -592,6 +597,7 @@ Globals::~Globals() {
 	// route_finder_impl.cpp globals
 	delete[] _navpoints;
 	delete _nav;
+	delete _navGraph;
 
 	// screen.cpp globals
 	delete[] _old_palette;
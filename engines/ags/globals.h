@@ -105,6 +105,7 @@ class EngineExports;
 
 class IRouteFinder;
 class Navigation;
+class NavGraph;
 class SplitLines;
 class TTFFontRenderer;
 class WFNFontRenderer;
@@ -180,6 +181,7 @@ struct StaticArray;
 struct StaticGame;
 struct SystemImports;
 struct TopBarSettings;
+class TransformedSpriteCache;
 struct ViewStruct;
 
 class Globals {
@@ -772,6 +774,10 @@ public:
 	std::vector<ObjectCache> *_charcache;
 	ObjectCache *_objcache;
 	std::vector<Point> *_screenovercache;
+	// Scaled, flipped and tinted character sprites, shared between characters
+	TransformedSpriteCache *_transformedSpriteCache;
+	// Scratch bitmap for the partial tint in tint_image()
+	AGS::Shared::Bitmap *_tintScratchBmp = nullptr;
 	std::vector<CharacterExtras> *_charextra;
 	// MoveLists for characters and room objects; NOTE: 1-based array!
 	// object sprites begin with index 1, characters are after MAX_ROOM_OBJECTS + 1
@@ -1235,6 +1241,7 @@ public:
 
 	int32_t *_navpoints;
 	Navigation *_nav;
+	NavGraph *_navGraph;
 	int _num_navpoints = 0;
 	AGS::Shared::Bitmap *_wallscreen = nullptr;
 	int _lastcx = 0, _lastcy = 0;
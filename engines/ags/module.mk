@@ -177,6 +177,7 @@ MODULE_OBJS = \
 	engine/ac/route_finder.o \
 	engine/ac/route_finder_impl.o \
 	engine/ac/route_finder_impl_legacy.o \
+	engine/ac/route_finder_hpa.o \
 	engine/ac/route_finder_jps.o \
 	engine/ac/screen.o \
 	engine/ac/screen_overlay.o \
@@ -382,8 +383,10 @@ MODULE_OBJS += \
 	tests/test_file.o \
 	tests/test_gfx.o \
 	tests/test_inifile.o \
+	tests/test_managed_object_pool.o \
 	tests/test_math.o \
 	tests/test_memory.o \
+	tests/test_route_finder.o \
 	tests/test_sprintf.o \
 	tests/test_string.o \
 	tests/test_version.o
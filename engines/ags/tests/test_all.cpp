@@ -27,6 +27,7 @@ namespace AGS3 {
 void Test_DoAllTests() {
 	Test_Math();
 	Test_Memory();
+	Test_ManagedObjectPool();
 	// The commented out tests don't work right now (will fix, but that is not my problem right now) @eklipsed
 	//Test_Path();
 	Test_ScriptSprintf();
@@ -35,6 +36,7 @@ void Test_DoAllTests() {
 	//Test_File();
 	//Test_IniFile();
 	Test_Gfx();
+	Test_RouteFinder();
 }
 
 } // namespace AGS3
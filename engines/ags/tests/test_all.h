@@ -38,6 +38,12 @@ extern void Test_Gfx();
 // Memory / bit-byte operations
 extern void Test_Memory();
 
+// Script runtime tests
+extern void Test_ManagedObjectPool();
+
+// Path finding tests
+extern void Test_RouteFinder();
+
 // String tests
 extern void Test_ScriptSprintf();
 extern void Test_String();
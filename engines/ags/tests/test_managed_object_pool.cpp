@@ -0,0 +1,166 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+#include "common/debug.h"
+#include "ags/shared/core/platform.h"
+#include "ags/engine/ac/dynobj/cc_ags_dynamic_object.h"
+#include "ags/engine/ac/dynobj/managed_object_pool.h"
+#include "ags/lib/std/chrono.h"
+#include "ags/lib/std/vector.h"
+
+namespace AGS3 {
+
+struct TestManagedObject final : AGSCCDynamicObject {
+	int disposed = 0;
+
+	int Dispose(const char *address, bool force) override {
+		disposed++;
+		return 1;
+	}
+	const char *GetType() override {
+		return "TestObject";
+	}
+	void Unserialize(int index, AGS::Shared::Stream *in, size_t data_sz) override {
+	}
+
+protected:
+	size_t CalcSerializeSize() override {
+		return 0;
+	}
+	void Serialize(const char *address, AGS::Shared::Stream *out) override {
+	}
+};
+
+static uint32 pool_rand(uint32 &seed) {
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 8) & 0xFFFF;
+}
+
+static void Test_PoolHandles() {
+	ManagedObjectPool pool;
+	TestManagedObject manager;
+	char memory[4];
+
+	int32_t h0 = pool.AddObject(&memory[0], &manager, false);
+	int32_t h1 = pool.AddObject(&memory[1], &manager, false);
+	assert(h0 > 0 && h1 > 0 && h0 != h1);
+	assert(pool.HandleToAddress(h0) == &memory[0]);
+	assert(pool.AddressToHandle(&memory[1]) == h1);
+	assert(pool.GetObjectCount() == 2);
+
+	// A freed slot is reused under a new handle, the old one must not resolve
+	assert(pool.RemoveObject(&memory[0]) == 1);
+	assert(pool.HandleToAddress(h0) == nullptr);
+	int32_t h2 = pool.AddObject(&memory[2], &manager, false);
+	assert(h2 > 0 && h2 != h0);
+	assert(pool.HandleToAddress(h0) == nullptr);
+	assert(pool.HandleToAddress(h2) == &memory[2]);
+	assert(pool.AddRef(h0) == 0);
+	assert(pool.SubRef(h0) == 0);
+
+	// Reference counting
+	assert(pool.AddRef(h2) == 1);
+	assert(pool.AddRef(h2) == 2);
+	assert(pool.SubRef(h2) == 1);
+	assert(pool.HandleToAddress(h2) == &memory[2]);
+	int disposed = manager.disposed;
+	assert(pool.SubRef(h2) == 0);
+	assert(manager.disposed == disposed + 1);
+	assert(pool.HandleToAddress(h2) == nullptr);
+	assert(pool.AddressToHandle(&memory[2]) == 0);
+
+	// Restored objects keep their saved handle
+	pool.reset();
+	int32_t h3 = pool.AddUnserializedObject(&memory[3], &manager, false, h0 + (1 << 24));
+	assert(pool.HandleToAddress(h3) == &memory[3]);
+	assert(pool.HandleToAddress(h0) == nullptr);
+	assert(pool.GetObjectCount() == 1);
+	int32_t h4 = pool.AddObject(&memory[0], &manager, false);
+	assert(h4 > 0 && h4 != h3);
+	assert(pool.HandleToAddress(h3) == &memory[3]);
+	assert(pool.GetObjectCount() == 2);
+
+	pool.reset();
+	assert(pool.GetObjectCount() == 0);
+	assert(pool.HandleToAddress(h3) == nullptr);
+}
+
+static void Test_PoolStress() {
+	const int NUM_ITERATIONS = 200000;
+	const int MAX_LIVE = 4096;
+
+	ManagedObjectPool pool;
+	TestManagedObject manager;
+	std::vector<char> memory(NUM_ITERATIONS);
+	std::vector<int32_t> live;
+	uint32 seed = 1;
+	uint64 resolved = 0;
+	int maxSlots = 0;
+
+	uint32 start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < NUM_ITERATIONS; i++) {
+		// Most script objects are temporaries which are only collected by the GC,
+		// some get stored in variables for a while
+		int32_t handle = pool.AddObject(&memory[i], &manager, false);
+		assert(pool.AddressToHandle(&memory[i]) == handle);
+		if ((pool_rand(seed) & 3) == 0 && (int)live.size() < MAX_LIVE) {
+			pool.AddRef(handle);
+			live.push_back(handle);
+		}
+
+		// Pointer accesses from the scripts
+		for (int j = 0; j < 8 && !live.empty(); j++) {
+			if (pool.HandleToAddress(live[pool_rand(seed) % live.size()]) != nullptr)
+				resolved++;
+		}
+
+		// Release a stored reference
+		if (!live.empty() && (pool_rand(seed) & 3) == 0) {
+			size_t idx = pool_rand(seed) % live.size();
+			pool.SubRef(live[idx]);
+			live[idx] = live.back();
+			live.pop_back();
+		}
+
+		pool.RunGarbageCollectionIfAppropriate();
+		maxSlots = MAX(maxSlots, pool.GetSlotCount());
+	}
+	uint32 time = std::chrono::high_resolution_clock::now() - start;
+
+	assert(pool.GetObjectCount() >= (int)live.size());
+	for (size_t i = 0; i < live.size(); i++)
+		assert(pool.HandleToAddress(live[i]) != nullptr);
+	// the garbage collection keeps the table from growing with the temporaries
+	assert(maxSlots < MAX_LIVE * 2);
+
+	debug("Managed object pool: %d allocations, %u pointer accesses, max %d slots, %u ms",
+		NUM_ITERATIONS, (uint32)resolved, maxSlots, time);
+	pool.reset();
+	assert(manager.disposed == NUM_ITERATIONS);
+}
+
+void Test_ManagedObjectPool() {
+	Test_PoolHandles();
+	Test_PoolStress();
+}
+
+} // namespace AGS3
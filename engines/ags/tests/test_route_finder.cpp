@@ -0,0 +1,197 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+#include "common/debug.h"
+#include "ags/shared/core/platform.h"
+#include "ags/engine/ac/route_finder_hpa.h"
+#include "ags/engine/ac/route_finder_jps.h"
+#include "ags/lib/std/chrono.h"
+#include "ags/lib/std/vector.h"
+
+namespace AGS3 {
+
+// Hierarchical routes may be a bit longer than the plain JPS ones,
+// but never by more than this factor
+static const float MAX_ROUTE_LENGTH_RATIO = 1.25f;
+
+struct RouteTestMap {
+	int width, height;
+	std::vector<unsigned char> cells;
+	std::vector<const unsigned char *> rows;
+
+	RouteTestMap(int w, int h) : width(w), height(h), cells(w * h, 1), rows(h) {
+		for (int y = 0; y < h; y++)
+			rows[y] = &cells[y * w];
+	}
+
+	void Fill(int x, int y, int w, int h, unsigned char value) {
+		for (int j = y; j < y + h; j++)
+			for (int i = x; i < x + w; i++)
+				cells[j * width + i] = value;
+	}
+
+	bool Walkable(int x, int y) const {
+		return cells[y * width + x] != 0;
+	}
+};
+
+static uint32 test_rand(uint32 &seed) {
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 8) & 0xFFFF;
+}
+
+// A grid of rooms, each wall between two rooms has a single doorway
+static void make_rooms_map(RouteTestMap &map, int roomSize, uint32 seed) {
+	const int doorSize = 8;
+	for (int x = roomSize; x < map.width; x += roomSize)
+		map.Fill(x, 0, 2, map.height, 0);
+	for (int y = roomSize; y < map.height; y += roomSize)
+		map.Fill(0, y, map.width, 2, 0);
+
+	for (int y = 0; y < map.height; y += roomSize) {
+		for (int x = 0; x < map.width; x += roomSize) {
+			const int h = MIN(roomSize, map.height - y);
+			const int w = MIN(roomSize, map.width - x);
+			if (x + roomSize < map.width && h > doorSize + 4)
+				map.Fill(x + roomSize, y + 2 + test_rand(seed) % (h - doorSize - 4), 2, doorSize, 1);
+			if (y + roomSize < map.height && w > doorSize + 4)
+				map.Fill(x + 2 + test_rand(seed) % (w - doorSize - 4), y + roomSize, doorSize, 2, 1);
+		}
+	}
+}
+
+// Open floor scattered with rectangular obstacles
+static void make_obstacles_map(RouteTestMap &map, int count, uint32 seed) {
+	for (int i = 0; i < count; i++) {
+		const int w = 4 + test_rand(seed) % 40;
+		const int h = 4 + test_rand(seed) % 40;
+		const int x = test_rand(seed) % (map.width - w);
+		const int y = test_rand(seed) % (map.height - h);
+		map.Fill(x, y, w, h, 0);
+	}
+}
+
+static float path_length(const std::vector<int> &cpath) {
+	float length = 0.f;
+	for (size_t i = 1; i < cpath.size(); i++) {
+		int x0, y0, x1, y1;
+		Navigation::UnpackSquare(cpath[i - 1], x0, y0);
+		Navigation::UnpackSquare(cpath[i], x1, y1);
+		length += sqrt((float)((x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0)));
+	}
+	return length;
+}
+
+static void random_walkable_cell(const RouteTestMap &map, uint32 &seed, int &x, int &y) {
+	do {
+		x = test_rand(seed) % map.width;
+		y = test_rand(seed) % map.height;
+	} while (!map.Walkable(x, y));
+}
+
+static void test_route_map(const char *name, const RouteTestMap &map, NavGraph &graph, int numRoutes) {
+	Navigation nav;
+	nav.Resize(map.width, map.height);
+	for (int y = 0; y < map.height; y++)
+		nav.SetMapRow(y, map.rows[y]);
+	graph.SetMap(map.width, map.height, &map.rows[0]);
+
+	// Build the graph before timing, as the engine would do on room load
+	uint32 start = std::chrono::high_resolution_clock::now();
+	graph.Update();
+	uint32 buildTime = std::chrono::high_resolution_clock::now() - start;
+
+	std::vector<int> routes;
+	uint32 seed = 1;
+	for (int i = 0; i < numRoutes; i++) {
+		int sx, sy, ex, ey;
+		random_walkable_cell(map, seed, sx, sy);
+		random_walkable_cell(map, seed, ex, ey);
+		routes.push_back(sx);
+		routes.push_back(sy);
+		routes.push_back(ex);
+		routes.push_back(ey);
+	}
+
+	std::vector<int> path, cpath;
+	std::vector<float> lengths;
+	nav.SetGraph(nullptr);
+	start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < numRoutes; i++) {
+		const int *r = &routes[i * 4];
+		Navigation::NavResult res = nav.NavigateRefined(r[0], r[1], r[2], r[3], path, cpath);
+		lengths.push_back(res == Navigation::NAV_UNREACHABLE ? -1.f : path_length(cpath));
+	}
+	uint32 plainTime = std::chrono::high_resolution_clock::now() - start;
+
+	std::vector<float> hpaLengths;
+	nav.SetGraph(&graph);
+	start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < numRoutes; i++) {
+		const int *r = &routes[i * 4];
+		Navigation::NavResult res = nav.NavigateRefined(r[0], r[1], r[2], r[3], path, cpath);
+		hpaLengths.push_back(res == Navigation::NAV_UNREACHABLE ? -1.f : path_length(cpath));
+	}
+	uint32 hpaTime = std::chrono::high_resolution_clock::now() - start;
+
+	float totalPlain = 0.f, totalHpa = 0.f, worstRatio = 1.f;
+	for (int i = 0; i < numRoutes; i++) {
+		// both searches must agree on whether the end point can be reached
+		assert((lengths[i] < 0.f) == (hpaLengths[i] < 0.f));
+		if (lengths[i] <= 0.f)
+			continue;
+		totalPlain += lengths[i];
+		totalHpa += hpaLengths[i];
+		worstRatio = MAX(worstRatio, hpaLengths[i] / lengths[i]);
+		assert(hpaLengths[i] <= lengths[i] * MAX_ROUTE_LENGTH_RATIO + 2.f);
+	}
+
+	debug("Route finder %s: %d nodes, %d edges, graph built in %u ms", name,
+		graph.GetNodeCount(), graph.GetEdgeCount(), buildTime);
+	debug("Route finder %s: %d routes, JPS %u ms, hierarchical %u ms, length ratio avg %f worst %f", name,
+		numRoutes, plainTime, hpaTime, totalPlain > 0.f ? totalHpa / totalPlain : 1.f, worstRatio);
+}
+
+void Test_RouteFinder() {
+	NavGraph graph;
+	{
+		RouteTestMap map(640, 400);
+		make_rooms_map(map, 48, 7);
+		test_route_map("rooms", map, graph, 200);
+	}
+	{
+		RouteTestMap map(640, 400);
+		make_obstacles_map(map, 120, 3);
+		test_route_map("obstacles", map, graph, 200);
+	}
+	{
+		// Walkable areas changed: the graph must follow the new map
+		RouteTestMap map(320, 200);
+		make_rooms_map(map, 40, 11);
+		test_route_map("small rooms", map, graph, 100);
+		map.Fill(0, 0, 320, 200, 1);
+		map.Fill(0, 96, 300, 8, 0);
+		test_route_map("changed rooms", map, graph, 100);
+	}
+}
+
+} // namespace AGS3
@@ -30,6 +30,7 @@
 #include "gob/inter.h"
 #include "gob/dataio.h"
 #include "gob/cheater.h"
+#include "gob/video.h"
 
 namespace Gob {
 
@@ -43,6 +44,7 @@ GobConsole::GobConsole(GobEngine *vm) : GUI::Debugger(), _vm(vm), _cheater(nullp
 	registerCmd("varString",    WRAP_METHOD(GobConsole, cmd_varString));
 	registerCmd("cheat",        WRAP_METHOD(GobConsole, cmd_cheat));
 	registerCmd("listArchives", WRAP_METHOD(GobConsole, cmd_listArchives));
+	registerCmd("dirtyRects",   WRAP_METHOD(GobConsole, cmd_dirtyRects));
 }
 
 GobConsole::~GobConsole() {
@@ -192,4 +194,39 @@ bool GobConsole::cmd_listArchives(int argc, const char **argv) {
 	return true;
 }
 
+bool GobConsole::cmd_dirtyRects(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Usage: %s [on|off]\n", argv[0]);
+		return true;
+	}
+
+	if (argc == 2) {
+		if (!scumm_stricmp(argv[1], "on"))
+			_vm->_video->setDirtyRectStats(true);
+		else if (!scumm_stricmp(argv[1], "off"))
+			_vm->_video->setDirtyRectStats(false);
+		else
+			debugPrintf("Usage: %s [on|off]\n", argv[0]);
+		return true;
+	}
+
+	if (!_vm->_video->hasDirtyRectStats()) {
+		debugPrintf("Screen update statistics are off, use \"%s on\" and play for a while\n", argv[0]);
+		return true;
+	}
+
+	const DirtyRectStats &stats = _vm->_video->getDirtyRectStats();
+	const uint32 frames = MAX<uint32>(stats.frames, 1);
+
+	debugPrintf("%d frames, %d dirty rectangles added\n", stats.frames, stats.addedRects);
+	debugPrintf("             |  Rects/frame | Bytes/frame\n");
+	debugPrintf("--------------------------------------------\n");
+	debugPrintf("Separate     | %12.1f | %11.0f\n",
+	            (double)stats.plainRects / frames, (double)stats.plainBytes / frames);
+	debugPrintf("Merged       | %12.1f | %11.0f\n",
+	            (double)stats.mergedRects / frames, (double)stats.mergedBytes / frames);
+
+	return true;
+}
+
 } // End of namespace Gob
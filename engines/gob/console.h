@@ -58,6 +58,8 @@ private:
 	bool cmd_cheat(int argc, const char **argv);
 
 	bool cmd_listArchives(int argc, const char **argv);
+
+	bool cmd_dirtyRects(int argc, const char **argv);
 };
 
 } // End of namespace Gob
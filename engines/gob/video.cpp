@@ -176,6 +176,150 @@ const byte *Font::getCharData(uint8 c) const {
 }
 
 
+DirtyTiles::DirtyTiles() : _width(0), _height(0), _tilesX(0), _tilesY(0), _rowWords(0),
+	_rectsValid(true) {
+}
+
+void DirtyTiles::resize(uint16 width, uint16 height) {
+	_width  = width;
+	_height = height;
+
+	_tilesX   = (width  + kTileSize - 1) >> kTileShift;
+	_tilesY   = (height + kTileSize - 1) >> kTileShift;
+	_rowWords = (_tilesX + 31) >> 5;
+
+	_tiles.resize(_rowWords * _tilesY);
+	Common::fill(_tiles.begin(), _tiles.end(), 0);
+
+	_bounds = Common::Rect();
+	_rects.clear();
+	_rectsValid = true;
+}
+
+void DirtyTiles::clear() {
+	if (!_bounds.isEmpty()) {
+		// Only the rows within the bounding box can have dirty tiles
+		uint32 *row = _tiles.data() + (_bounds.top >> kTileShift) * _rowWords;
+		uint32 *end = _tiles.data() + (((_bounds.bottom - 1) >> kTileShift) + 1) * _rowWords;
+		memset(row, 0, (end - row) * sizeof(uint32));
+	}
+
+	_bounds = Common::Rect();
+	_rects.clear();
+	_rectsValid = true;
+}
+
+void DirtyTiles::add(const Common::Rect &rect) {
+	Common::Rect area = rect;
+	area.clip(Common::Rect(_width, _height));
+	if (area.isEmpty())
+		return;
+
+	if (_bounds.isEmpty())
+		_bounds = area;
+	else
+		_bounds.extend(area);
+
+	int left   =  area.left          >> kTileShift;
+	int right  = (area.right  - 1)   >> kTileShift;
+	int top    =  area.top           >> kTileShift;
+	int bottom = (area.bottom - 1)   >> kTileShift;
+
+	int leftWord  = left  >> 5;
+	int rightWord = right >> 5;
+	uint32 leftMask  = 0xFFFFFFFF << (left & 31);
+	uint32 rightMask = 0xFFFFFFFF >> (31 - (right & 31));
+
+	for (int y = top; y <= bottom; y++) {
+		uint32 *row = _tiles.data() + y * _rowWords;
+
+		if (leftWord == rightWord) {
+			row[leftWord] |= leftMask & rightMask;
+			continue;
+		}
+
+		row[leftWord] |= leftMask;
+		for (int w = leftWord + 1; w < rightWord; w++)
+			row[w] = 0xFFFFFFFF;
+		row[rightWord] |= rightMask;
+	}
+
+	_rectsValid = false;
+}
+
+void DirtyTiles::mergeRow(int row, Common::Array<Common::Rect> &open, Common::Array<Common::Rect> &next) {
+	const uint32 *bits = _tiles.data() + row * _rowWords;
+
+	next.clear();
+
+	// Both the spans of this row and the open rectangles are sorted from left to right
+	uint o = 0;
+	int x = _bounds.left >> kTileShift;
+	int end = ((_bounds.right - 1) >> kTileShift) + 1;
+	while (x < end) {
+		if (bits[x >> 5] == 0) {
+			x = (x | 31) + 1;
+			continue;
+		}
+		if (!(bits[x >> 5] & (1u << (x & 31)))) {
+			x++;
+			continue;
+		}
+
+		int spanLeft = x;
+		while ((x < end) && (bits[x >> 5] & (1u << (x & 31))))
+			x++;
+
+		// Close the open rectangles left of this span
+		while ((o < open.size()) && (open[o].left < spanLeft))
+			_rects.push_back(open[o++]);
+
+		if ((o < open.size()) && (open[o].left == spanLeft) && (open[o].right == x)) {
+			// Same columns as in the row above, grow that rectangle
+			next.push_back(open[o++]);
+			next.back().bottom = row + 1;
+		} else
+			next.push_back(Common::Rect(spanLeft, row, x, row + 1));
+	}
+
+	while (o < open.size())
+		_rects.push_back(open[o++]);
+}
+
+const Common::Array<Common::Rect> &DirtyTiles::getRects() {
+	if (_rectsValid)
+		return _rects;
+
+	_rects.clear();
+
+	Common::Array<Common::Rect> open, next;
+
+	int top    =  _bounds.top            >> kTileShift;
+	int bottom = ((_bounds.bottom - 1)   >> kTileShift) + 1;
+	for (int y = top; y < bottom; y++) {
+		mergeRow(y, open, next);
+		SWAP(open, next);
+	}
+
+	_rects.push_back(open);
+
+	// Convert from tiles to pixels
+	for (uint i = 0; i < _rects.size(); i++) {
+		Common::Rect &rect = _rects[i];
+
+		rect.left   <<= kTileShift;
+		rect.top    <<= kTileShift;
+		rect.right  <<= kTileShift;
+		rect.bottom <<= kTileShift;
+
+		rect.clip(_bounds);
+	}
+
+	_rectsValid = true;
+	return _rects;
+}
+
+
 Video::Video(GobEngine *vm) : _vm(vm) {
 	_doRangeClamp = false;
 
@@ -196,6 +340,7 @@ Video::Video(GobEngine *vm) : _vm(vm) {
 	_lastSparse = 0xFFFFFFFF;
 
 	_dirtyAll = false;
+	_dirtyStatsFl = false;
 }
 
 Video::~Video() {
@@ -285,6 +430,9 @@ void Video::retrace(bool mouse) {
 			dirtyRectsApply(0, _splitStart, screenWidth, screenHeight, screenX, screenY);
 		}
 
+		if (_dirtyStatsFl)
+			_dirtyStats.frames++;
+
 		dirtyRectsClear();
 		g_system->updateScreen();
 	}
@@ -434,11 +582,13 @@ void Video::setPalette(Color *palette) {
 }
 
 void Video::dirtyRectsClear() {
+	_dirtyTiles.clear();
 	_dirtyRects.clear();
 	_dirtyAll = false;
 }
 
 void Video::dirtyRectsAll() {
+	_dirtyTiles.clear();
 	_dirtyRects.clear();
 	_dirtyAll = true;
 }
@@ -447,30 +597,87 @@ void Video::dirtyRectsAdd(int16 left, int16 top, int16 right, int16 bottom) {
 	if (_dirtyAll)
 		return;
 
-	_dirtyRects.push_back(Common::Rect(left, top, right + 1, bottom + 1));
+	uint16 width  = _surfWidth;
+	uint16 height = _surfHeight;
+	if (_vm->_global->_primarySurfDesc) {
+		width  = _vm->_global->_primarySurfDesc->getWidth();
+		height = _vm->_global->_primarySurfDesc->getHeight();
+	}
+
+	if ((width != _dirtyTiles.getWidth()) || (height != _dirtyTiles.getHeight())) {
+		if (!_dirtyTiles.isEmpty()) {
+			// The surface changed size under the pending updates
+			dirtyRectsAll();
+			return;
+		}
+
+		_dirtyTiles.resize(width, height);
+	}
+
+	Common::Rect rect(left, top, right + 1, bottom + 1);
+
+	_dirtyTiles.add(rect);
+
+	if (_dirtyStatsFl) {
+		_dirtyRects.push_back(rect);
+		_dirtyStats.addedRects++;
+	}
 }
 
 void Video::dirtyRectsApply(int left, int top, int width, int height, int x, int y) {
-	if (_dirtyAll) {
-		_vm->_global->_primarySurfDesc->blitToScreen(left, top, left + width - 1, top + height - 1, x, y);
+	const SurfacePtr &surface = _vm->_global->_primarySurfDesc;
+	const uint8 bpp = surface->getBPP();
+
+	bool sizeChanged = !_dirtyTiles.isEmpty() &&
+		((surface->getWidth() != _dirtyTiles.getWidth()) || (surface->getHeight() != _dirtyTiles.getHeight()));
+
+	if (_dirtyAll || sizeChanged) {
+		surface->blitToScreen(left, top, left + width - 1, top + height - 1, x, y);
+
+		if (_dirtyStatsFl && (width > 0) && (height > 0)) {
+			_dirtyStats.plainRects++;
+			_dirtyStats.mergedRects++;
+			_dirtyStats.plainBytes  += width * height * bpp;
+			_dirtyStats.mergedBytes += width * height * bpp;
+		}
 		return;
 	}
 
-	int right  = left + width;
-	int bottom = top  + height;
+	const Common::Rect window(left, top, left + width, top + height);
 
-	Common::List<Common::Rect>::const_iterator it;
-	for (it = _dirtyRects.begin(); it != _dirtyRects.end(); ++it) {
-		int l = MAX<int>(left  , it->left);
-		int t = MAX<int>(top   , it->top);
-		int r = MIN<int>(right , it->right);
-		int b = MIN<int>(bottom, it->bottom);
+	const Common::Array<Common::Rect> &rects = _dirtyTiles.getRects();
+	for (Common::Array<Common::Rect>::const_iterator it = rects.begin(); it != rects.end(); ++it) {
+		Common::Rect area = it->findIntersectingRect(window);
+		if (area.isEmpty())
+			continue;
 
-		if ((r <= l) || (b <= t))
+		surface->blitToScreen(area.left, area.top, area.right - 1, area.bottom - 1,
+				x + (area.left - left), y + (area.top - top));
+
+		if (_dirtyStatsFl) {
+			_dirtyStats.mergedRects++;
+			_dirtyStats.mergedBytes += area.width() * area.height() * bpp;
+		}
+	}
+
+	if (!_dirtyStatsFl)
+		return;
+
+	// What updating every dirty rectangle separately would have cost
+	for (Common::List<Common::Rect>::const_iterator it = _dirtyRects.begin(); it != _dirtyRects.end(); ++it) {
+		Common::Rect area = it->findIntersectingRect(window);
+		if (area.isEmpty())
 			continue;
 
-		_vm->_global->_primarySurfDesc->blitToScreen(l, t, r - 1, b - 1, x + (l - left), y + (t - top));
+		_dirtyStats.plainRects++;
+		_dirtyStats.plainBytes += area.width() * area.height() * bpp;
 	}
 }
 
+void Video::setDirtyRectStats(bool enabled) {
+	_dirtyStatsFl = enabled;
+	_dirtyStats.reset();
+	_dirtyRects.clear();
+}
+
 } // End of namespace Gob
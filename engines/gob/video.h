@@ -28,6 +28,7 @@
 #ifndef GOB_VIDEO_H
 #define GOB_VIDEO_H
 
+#include "common/array.h"
 #include "common/list.h"
 #include "common/rect.h"
 #include "common/ptr.h"
@@ -72,6 +73,74 @@ private:
 	const byte *getCharData(uint8 c) const;
 };
 
+/** Dirty areas of a surface, tracked in a tile bitmap.
+ *
+ *  Overlapping areas only mark their tiles once. The dirty tiles are merged
+ *  into horizontal spans, and spans covering the same columns in consecutive
+ *  tile rows are merged into one rectangle.
+ */
+class DirtyTiles {
+public:
+	enum {
+		kTileShift = 3,
+		kTileSize  = 1 << kTileShift
+	};
+
+	DirtyTiles();
+
+	uint16 getWidth () const { return _width;  }
+	uint16 getHeight() const { return _height; }
+
+	/** Set the size of the tracked surface, forgetting all dirty tiles. */
+	void resize(uint16 width, uint16 height);
+
+	void clear();
+	bool isEmpty() const { return _bounds.isEmpty(); }
+
+	/** Mark an area as dirty, clipped to the surface. */
+	void add(const Common::Rect &rect);
+
+	/** The dirty area, merged into rectangles. */
+	const Common::Array<Common::Rect> &getRects();
+
+private:
+	uint16 _width;
+	uint16 _height;
+
+	int _tilesX;
+	int _tilesY;
+	int _rowWords;
+
+	/** One bit per tile, _rowWords words per tile row. */
+	Common::Array<uint32> _tiles;
+	/** Bounding box of all dirty areas, to trim the tile rounding. */
+	Common::Rect _bounds;
+
+	Common::Array<Common::Rect> _rects;
+	bool _rectsValid;
+
+	void mergeRow(int row, Common::Array<Common::Rect> &open, Common::Array<Common::Rect> &next);
+};
+
+/** Statistics about the screen updates, for the debug console. */
+struct DirtyRectStats {
+	uint32 frames;
+	/** Dirty rectangles added by the engine. */
+	uint32 addedRects;
+	/** Rectangles and bytes a separate update for each added rectangle would have copied. */
+	uint32 plainRects;
+	uint64 plainBytes;
+	/** Rectangles and bytes actually copied after merging. */
+	uint32 mergedRects;
+	uint64 mergedBytes;
+
+	DirtyRectStats() { reset(); }
+	void reset() {
+		frames = addedRects = plainRects = mergedRects = 0;
+		plainBytes = mergedBytes = 0;
+	}
+};
+
 class Video {
 public:
 #define GDR_VERSION 4
@@ -147,6 +216,11 @@ public:
 	void dirtyRectsAdd(int16 left, int16 top, int16 right, int16 bottom);
 	void dirtyRectsApply(int left, int top, int width, int height, int x, int y);
 
+	/** Start or stop collecting statistics about the screen updates. */
+	void setDirtyRectStats(bool enabled);
+	bool hasDirtyRectStats() const { return _dirtyStatsFl; }
+	const DirtyRectStats &getDirtyRectStats() const { return _dirtyStats; }
+
 	virtual char spriteUncompressor(byte *sprBuf, int16 srcWidth,
 			int16 srcHeight, int16 x, int16 y, int16 transp,
 			Surface &destDesc) = 0;
@@ -156,6 +230,11 @@ public:
 
 protected:
 	bool _dirtyAll;
+	DirtyTiles _dirtyTiles;
+
+	bool _dirtyStatsFl;
+	DirtyRectStats _dirtyStats;
+	/** The unmerged dirty rectangles, only kept while collecting statistics. */
 	Common::List<Common::Rect> _dirtyRects;
 
 	int _curSparse;
@@ -35,6 +35,9 @@ Debugger::Debugger(HopkinsEngine *vm) : GUI::Debugger() {
 	registerCmd("show_room", WRAP_METHOD(Debugger, cmd_ShowCurrentRoom));
 	registerCmd("zones", WRAP_METHOD(Debugger, cmd_Zones));
 	registerCmd("lines", WRAP_METHOD(Debugger, cmd_Lines));
+#ifndef RELEASE_BUILD
+	registerCmd("hittests", WRAP_METHOD(Debugger, cmd_HitTests));
+#endif
 }
 
 // Turns dirty rects on or off
@@ -85,5 +88,16 @@ bool Debugger::cmd_Lines(int argc, const char **argv) {
 	}
 }
 
+#ifndef RELEASE_BUILD
+// Checks the line and zone hit tests of the current room against the original ones
+bool Debugger::cmd_HitTests(int argc, const char **argv) {
+	int numTests;
+	uint32 time, referenceTime;
+	bool identical = _vm->_linesMan->checkHitTests(numTests, time, referenceTime);
+	debugPrintf("%d hit tests: %d ms, original %d ms, results %s\n", numTests, time, referenceTime,
+		identical ? "identical" : "DIFFERENT");
+	return true;
+}
+#endif
 
 } // End of namespace Hopkins
@@ -42,6 +42,9 @@ public:
 	bool cmd_ShowCurrentRoom(int argc, const char **argv);
 	bool cmd_Zones(int argc, const char **argv);
 	bool cmd_Lines(int argc, const char **argv);
+#ifndef RELEASE_BUILD
+	bool cmd_HitTests(int argc, const char **argv);
+#endif
 };
 
 } // End of namespace Hopkins
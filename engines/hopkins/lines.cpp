@@ -117,6 +117,28 @@ int LigneItem::appendToRouteDec(int from, int to, RouteItem *route, int index) {
 	return index;
 }
 
+void LinePointGrid::beginCount() {
+	_cellStart.clear();
+	_cellStart.resize(kCellsX * kCellsY + 1);
+}
+
+void LinePointGrid::beginAdd() {
+	for (uint cell = 1; cell < _cellStart.size(); ++cell)
+		_cellStart[cell] += _cellStart[cell - 1];
+
+	_entries.resize(_cellStart.back());
+	_fill = _cellStart;
+}
+
+void LinePointGrid::addPoint(int x, int y, int lineIdx, int pointIdx) {
+	_entries[_fill[getCell(x, y)]++] = (lineIdx << 16) | pointIdx;
+}
+
+void LinePointGrid::finish() {
+	_fill.clear();
+	_dirtyFl = false;
+}
+
 /**
  * Load lines
  */
@@ -136,6 +158,7 @@ void LinesManager::loadLines(const Common::Path &file) {
 	}
 	initRoute();
 	_vm->_globals->freeMemory(ptr);
+	buildLineGrid();
 }
 
 /**
@@ -217,6 +240,7 @@ void LinesManager::addZoneLine(int idx, int fromX, int fromY, int destX, int des
 	} else {
 		assert(idx < MAX_LINES + 1);
 		_zoneLine[idx]._zoneData = (int16 *)_vm->_globals->freeMemory((byte *)_zoneLine[idx]._zoneData);
+		_zoneGrid._dirtyFl = true;
 
 		int distX = abs(fromX - destX);
 		int distY = abs(fromY - destY);
@@ -266,6 +290,7 @@ void LinesManager::addLine(int lineIdx, Directions direction, int fromX, int fro
 		_linesNumb = lineIdx;
 
 	_lineItem[lineIdx]._lineData = (int16 *)_vm->_globals->freeMemory((byte *)_lineItem[lineIdx]._lineData);
+	_lineGrid._dirtyFl = true;
 	int distX = abs(fromX - destX) + 1;
 	int distY = abs(fromY - destY) + 1;
 	int maxDist = distY;
@@ -375,6 +400,54 @@ void LinesManager::addLine(int lineIdx, Directions direction, int fromX, int fro
  */
 bool LinesManager::checkCollisionLine(int xp, int yp, int *foundDataIdx, int *foundLineIdx, int startLineIdx, int endLineIdx) {
 	debugC(5, kDebugPath, "checkCollisionLine(%d, %d, foundDataIdx, foundLineIdx, %d, %d)", xp, yp, startLineIdx ,endLineIdx);
+
+	if (_lineGrid._dirtyFl)
+		buildLineGrid();
+
+	*foundDataIdx = -1;
+	*foundLineIdx = -1;
+
+	// The matching points may be in up to four cells. In each cell, the first
+	// match is the one with the lowest line and point indexes
+	int cells[4] = {
+		LinePointGrid::getCell(xp, yp), LinePointGrid::getCell(xp + 1, yp),
+		LinePointGrid::getCell(xp, yp + 1), LinePointGrid::getCell(xp + 1, yp + 1)
+	};
+	uint32 bestEntry = 0xFFFFFFFF;
+
+	for (int i = 0; i < 4; i++) {
+		if ((i & 1 && cells[i] == cells[i - 1]) || (i >= 2 && cells[i] == cells[i - 2]))
+			continue;
+
+		for (const uint32 *entry = _lineGrid.cellBegin(cells[i]); entry != _lineGrid.cellEnd(cells[i]) && *entry < bestEntry; ++entry) {
+			int lineIdx = *entry >> 16;
+			if (lineIdx < startLineIdx)
+				continue;
+			if (lineIdx > endLineIdx)
+				break;
+
+			int16 *lineData = &_lineItem[lineIdx]._lineData[2 * (*entry & 0xFFFF)];
+			if ((xp == lineData[0] || xp + 1 == lineData[0]) && (yp == lineData[1] || yp + 1 == lineData[1]) && isLineNear(lineIdx, xp, yp)) {
+				bestEntry = *entry;
+				break;
+			}
+		}
+	}
+
+	if (bestEntry == 0xFFFFFFFF)
+		return false;
+
+	*foundDataIdx = bestEntry & 0xFFFF;
+	*foundLineIdx = bestEntry >> 16;
+	return true;
+}
+
+#ifndef RELEASE_BUILD
+/**
+ * Check collision line, by testing all the lines
+ */
+bool LinesManager::checkCollisionLineReference(int xp, int yp, int *foundDataIdx, int *foundLineIdx, int startLineIdx, int endLineIdx) {
+	debugC(5, kDebugPath, "checkCollisionLineReference(%d, %d, foundDataIdx, foundLineIdx, %d, %d)", xp, yp, startLineIdx ,endLineIdx);
 	int16 *lineData;
 
 	int left = xp + 4;
@@ -429,6 +502,64 @@ bool LinesManager::checkCollisionLine(int xp, int yp, int *foundDataIdx, int *fo
 	}
 	return false;
 }
+#endif
+
+/**
+ * Check if a position is close to the bounding box of a line
+ */
+bool LinesManager::isLineNear(int lineIdx, int xp, int yp) const {
+	const int16 *lineData = _lineItem[lineIdx]._lineData;
+
+	int left = xp + 4;
+	int right = xp - 4;
+	int top = yp + 4;
+	int bottom = yp - 4;
+
+	int lineStartX = lineData[0];
+	int lineStartY = lineData[1];
+	int lineDataIdx = 2 * _lineItem[lineIdx]._lineDataEndIdx;
+	int lineEndX = lineData[lineDataIdx - 2];
+	int lineEndY = lineData[lineDataIdx - 1];
+	if (lineStartX >= lineEndX) {
+		if (right > lineStartX || left < lineEndX)
+			return false;
+	} else { // lineStartX < lineEndX
+		if (left < lineStartX || right > lineEndX)
+			return false;
+	}
+	if (lineStartY >= lineEndY) {
+		if (bottom > lineStartY || top < lineEndY)
+			return false;
+	} else { // lineStartY < lineEndY
+		if (top < lineStartY || bottom > lineEndY)
+			return false;
+	}
+
+	return true;
+}
+
+void LinesManager::buildLineGrid() {
+	debugC(5, kDebugPath, "buildLineGrid()");
+	_lineGrid.beginCount();
+	for (int pass = 0; pass < 2; pass++) {
+		for (int lineIdx = 0; lineIdx < MAX_LINES; lineIdx++) {
+			const int16 *lineData = _lineItem[lineIdx]._lineData;
+			if (lineData == nullptr)
+				continue;
+
+			for (int idx = 0; idx < _lineItem[lineIdx]._lineDataEndIdx; idx++) {
+				if (pass == 0)
+					_lineGrid.countPoint(lineData[2 * idx], lineData[2 * idx + 1]);
+				else
+					_lineGrid.addPoint(lineData[2 * idx], lineData[2 * idx + 1], lineIdx, idx);
+			}
+		}
+
+		if (pass == 0)
+			_lineGrid.beginAdd();
+	}
+	_lineGrid.finish();
+}
 
 /**
  * Init route
@@ -2665,6 +2796,61 @@ int LinesManager::checkCollision(int xp, int yp) {
 	if (_currentSegmentId <= 0)
 		return -1;
 
+	if (_zoneGrid._dirtyFl)
+		buildZoneGrid();
+
+	// Find the zone lines going through the position, by increasing index
+	const int maxCandidates = 16;
+	int candidates[maxCandidates];
+	int numCandidates = 0;
+	int cells[2] = { LinePointGrid::getCell(xp, yp), LinePointGrid::getCell(xp + 1, yp) };
+	for (int i = 0; i < 2; i++) {
+		if (i == 1 && cells[1] == cells[0])
+			break;
+
+		int lastZoneLineIdx = -1;
+		for (const uint32 *entry = _zoneGrid.cellBegin(cells[i]); entry != _zoneGrid.cellEnd(cells[i]); ++entry) {
+			int zoneLineIdx = *entry >> 16;
+			if (zoneLineIdx == lastZoneLineIdx)
+				continue;
+
+			const int16 *dataP = &_zoneLine[zoneLineIdx]._zoneData[2 * (*entry & 0xFFFF)];
+			if ((xp == dataP[0] || xp + 1 == dataP[0]) && yp == dataP[1] && isZoneLineNear(zoneLineIdx, xp, yp)) {
+				lastZoneLineIdx = zoneLineIdx;
+
+				int pos = 0;
+				while (pos < numCandidates && candidates[pos] < zoneLineIdx)
+					++pos;
+				if (pos < numCandidates && candidates[pos] == zoneLineIdx)
+					continue;
+				if (numCandidates == maxCandidates)
+					return checkCollisionAllLines(xp, yp);
+
+				for (int k = numCandidates; k > pos; --k)
+					candidates[k] = candidates[k - 1];
+				candidates[pos] = zoneLineIdx;
+				++numCandidates;
+			}
+		}
+	}
+
+	// Zone lines are tested segment by segment, then by increasing index
+	for (int idx = 0; idx <= _currentSegmentId; ++idx) {
+		for (int i = 0; i < numCandidates; ++i) {
+			if (candidates[i] >= _segment[idx]._minZoneLineIdx && candidates[i] <= _segment[idx]._maxZoneLineIdx)
+				return _zoneLine[candidates[i]]._bobZoneIdx;
+		}
+	}
+
+	return -1;
+}
+
+// Fallback of checkCollision() for the positions crossed by too many zone lines
+int LinesManager::checkCollisionAllLines(int xp, int yp) {
+	debugC(7, kDebugPath, "checkCollisionAllLines(%d, %d)", xp, yp);
+	if (_currentSegmentId <= 0)
+		return -1;
+
 	int xMax = xp + 4;
 	int xMin = xp - 4;
 
@@ -2709,6 +2895,108 @@ int LinesManager::checkCollision(int xp, int yp) {
 	return -1;
 }
 
+/**
+ * Check if a position is close to the bounding box of a zone line
+ */
+bool LinesManager::isZoneLineNear(int zoneLineIdx, int xp, int yp) const {
+	const LigneZoneItem *curZoneLine = &_zoneLine[zoneLineIdx];
+	const int16 *dataP = curZoneLine->_zoneData;
+
+	int xMax = xp + 4;
+	int xMin = xp - 4;
+	int yMax = yp + 4;
+	int yMin = yp - 4;
+
+	int count = curZoneLine->_count;
+	int startX = dataP[0];
+	int startY = dataP[1];
+	int destX = dataP[count * 2 - 2];
+	int destY = dataP[count * 2 - 1];
+
+	return !((startX < destX && (xMax < startX || xMin > destX))  ||
+	         (startX >= destX && (xMin > startX || xMax < destX)) ||
+	         (startY < destY && (yMax < startY || yMin > destY))  ||
+	         (startY >= destY && (yMin > startY || yMax < destY)));
+}
+
+void LinesManager::buildZoneGrid() {
+	debugC(5, kDebugPath, "buildZoneGrid()");
+	_zoneGrid.beginCount();
+	for (int pass = 0; pass < 2; pass++) {
+		for (int zoneLineIdx = 0; zoneLineIdx < MAX_LINES + 1; zoneLineIdx++) {
+			const int16 *dataP = _zoneLine[zoneLineIdx]._zoneData;
+			if (dataP == nullptr)
+				continue;
+
+			for (int idx = 0; idx < _zoneLine[zoneLineIdx]._count; idx++) {
+				if (pass == 0)
+					_zoneGrid.countPoint(dataP[2 * idx], dataP[2 * idx + 1]);
+				else
+					_zoneGrid.addPoint(dataP[2 * idx], dataP[2 * idx + 1], zoneLineIdx, idx);
+			}
+		}
+
+		if (pass == 0)
+			_zoneGrid.beginAdd();
+	}
+	_zoneGrid.finish();
+}
+
+#ifndef RELEASE_BUILD
+bool LinesManager::checkHitTests(int &numTests, uint32 &time, uint32 &referenceTime) {
+	// Test the zone lines of all the square zones, as if the mouse was over all of them
+	SegmentItem oldSegment[101];
+	int oldSegmentId = _currentSegmentId;
+	Common::copy(_segment, _segment + 101, oldSegment);
+	_currentSegmentId = 0;
+	for (int squareZoneId = 0; squareZoneId <= 99; squareZoneId++) {
+		if (_squareZone[squareZoneId]._enabledFl) {
+			_segment[_currentSegmentId]._minZoneLineIdx = _squareZone[squareZoneId]._minZoneLineIdx;
+			_segment[_currentSegmentId]._maxZoneLineIdx = _squareZone[squareZoneId]._maxZoneLineIdx;
+			++_currentSegmentId;
+		}
+	}
+
+	if (_lineGrid._dirtyFl)
+		buildLineGrid();
+	if (_zoneGrid._dirtyFl)
+		buildZoneGrid();
+
+	const int ranges[3][2] = { { 0, _lastLine }, { _lastLine + 1, _linesNumb }, { 0, _linesNumb } };
+	uint32 results[2] = { 0, 0 };
+	uint32 times[2];
+	numTests = 0;
+
+	for (int pass = 0; pass < 2; pass++) {
+		uint32 startTime = g_system->getMillis();
+		for (int yp = 0; yp < LinePointGrid::kCellsY << LinePointGrid::kCellShift; yp++) {
+			for (int xp = 0; xp < LinePointGrid::kCellsX << LinePointGrid::kCellShift; xp++) {
+				for (int r = 0; r < 3; r++) {
+					int dataIdx, lineIdx;
+					bool found = (pass == 0) ?
+						checkCollisionLine(xp, yp, &dataIdx, &lineIdx, ranges[r][0], MIN(ranges[r][1], MAX_LINES - 1)) :
+						checkCollisionLineReference(xp, yp, &dataIdx, &lineIdx, ranges[r][0], MIN(ranges[r][1], MAX_LINES - 1));
+					results[pass] = results[pass] * 31 + (found ? (lineIdx << 16) + dataIdx : 0xFFFF);
+				}
+
+				int zoneId = (pass == 0) ? checkCollision(xp, yp) : checkCollisionAllLines(xp, yp);
+				results[pass] = results[pass] * 31 + zoneId;
+				if (pass == 0)
+					numTests += 4;
+			}
+		}
+		times[pass] = g_system->getMillis() - startTime;
+	}
+
+	Common::copy(oldSegment, oldSegment + 101, _segment);
+	_currentSegmentId = oldSegmentId;
+
+	time = times[0];
+	referenceTime = times[1];
+	return results[0] == results[1];
+}
+#endif
+
 // Square Zone
 void LinesManager::initSquareZones() {
 	debugC(5, kDebugPath, "initSquareZones()");
@@ -2751,6 +3039,8 @@ void LinesManager::initSquareZones() {
 		if (zoneWidth == zoneHeight)
 			_squareZone[idx]._squareZoneFl = true;
 	}
+
+	buildZoneGrid();
 }
 
 void LinesManager::clearAll() {
@@ -2782,6 +3072,9 @@ void LinesManager::clearAll() {
 	for (int idx = 0; idx < 100; ++idx)
 		_squareZone[idx]._enabledFl = false;
 
+	_lineGrid._dirtyFl = true;
+	_zoneGrid._dirtyFl = true;
+
 	_testRoute0 = new RouteItem[8334];
 	_testRoute1 = new RouteItem[8334];
 	_testRoute2 = new RouteItem[8334];
@@ -2812,6 +3105,7 @@ void LinesManager::removeZoneLine(int idx) {
 	debugC(5, kDebugPath, "removeZoneLine(%d)", idx);
 	assert(idx < MAX_LINES + 1);
 	_zoneLine[idx]._zoneData = (int16 *)_vm->_globals->freeMemory((byte *)_zoneLine[idx]._zoneData);
+	_zoneGrid._dirtyFl = true;
 }
 
 void LinesManager::resetLines() {
@@ -2821,6 +3115,7 @@ void LinesManager::resetLines() {
 		_lineItem[idx]._lineDataEndIdx = 0;
 		_lineItem[idx]._lineData = nullptr;
 	}
+	_lineGrid._dirtyFl = true;
 }
 
 void LinesManager::setMaxLineIdx(int idx) {
@@ -24,6 +24,7 @@
 
 #include "hopkins/globals.h"
 
+#include "common/array.h"
 #include "common/scummsys.h"
 #include "common/str.h"
 
@@ -93,6 +94,43 @@ struct ZoneItem {
 	int _messageId;
 };
 
+/**
+ * Uniform grid over the points of lines, used to find the lines going through
+ * a position without testing all of them. Each cell lists its points as
+ * (line index << 16 | point index), ordered by line, then by point.
+ */
+struct LinePointGrid {
+	enum {
+		kCellShift = 3,
+		kCellsX = 1280 >> kCellShift,
+		kCellsY = 480 >> kCellShift
+	};
+
+	Common::Array<uint32> _cellStart;	// First entry of every cell, followed by the entry count
+	Common::Array<uint32> _entries;
+	Common::Array<uint32> _fill;		// Next free entry of every cell, while adding
+	bool _dirtyFl;
+
+	LinePointGrid() : _dirtyFl(true) {}
+
+	static int getCell(int x, int y) {
+		return CLIP(y >> kCellShift, 0, kCellsY - 1) * kCellsX + CLIP(x >> kCellShift, 0, kCellsX - 1);
+	}
+
+	/**
+	 * Builds the grid in two passes over the same points: first count them,
+	 * then add them by increasing line and point indexes
+	 */
+	void beginCount();
+	void countPoint(int x, int y) { ++_cellStart[getCell(x, y) + 1]; }
+	void beginAdd();
+	void addPoint(int x, int y, int lineIdx, int pointIdx);
+	void finish();
+
+	const uint32 *cellBegin(int cell) const { return _entries.data() + _cellStart[cell]; }
+	const uint32 *cellEnd(int cell) const { return _entries.data() + _cellStart[cell + 1]; }
+};
+
 struct RouteItem {
 	int16 _x;
 	int16 _y;
@@ -137,13 +175,24 @@ private:
 	int _zoneSkipCount;
 	int _oldMouseZoneId;
 
+	LinePointGrid _lineGrid;
+	LinePointGrid _zoneGrid;
+
 	int avoidObstacle(int lineIdx, int lineDataIdx, int routeIdx, int destLineIdx, int destLineDataIdx, RouteItem *route);
 	int avoidObstacleOnSegment(int lineIdx, int lineDataIdx, int routeIdx, int destLineIdx, int destLineDataIdx, RouteItem *route, int startLineIdx, int endLineIdx);
 	int checkInventoryHotspotsRow(int posX, int minZoneNum, bool lastRow);
 	void removeZoneLine(int idx);
 	void removeLine(int idx);
 	int checkCollision(int xp, int yp);
+	int checkCollisionAllLines(int xp, int yp);
 	bool checkCollisionLine(int xp, int yp, int *foundDataIdx, int *foundLineIdx, int startLineIdx, int endLineIdx);
+#ifndef RELEASE_BUILD
+	bool checkCollisionLineReference(int xp, int yp, int *foundDataIdx, int *foundLineIdx, int startLineIdx, int endLineIdx);
+#endif
+	bool isLineNear(int lineIdx, int xp, int yp) const;
+	bool isZoneLineNear(int zoneLineIdx, int xp, int yp) const;
+	void buildLineGrid();
+	void buildZoneGrid();
 	bool checkSmoothMove(int fromX, int fromY, int destX, int destY);
 	bool makeSmoothMove(int fromX, int fromY, int destX, int destY);
 	int characterRoute(int fromX, int fromY, int destX, int destY, int startLineIdx, int endLineIdx, int routeIdx);
@@ -190,6 +239,14 @@ public:
 	void checkZone();
 	int getMouseZone();
 	void optimizeRoute(RouteItem *route);
+
+#ifndef RELEASE_BUILD
+	/**
+	 * Compares the grid based hit tests with the original ones on every position of the
+	 * room, and times both. Returns false if any result differs. Used by the debugger.
+	 */
+	bool checkHitTests(int &numTests, uint32 &time, uint32 &referenceTime);
+#endif
 };
 
 } // End of namespace Hopkins
@@ -40,6 +40,7 @@ static const DebugChannelDef debugFlagList[] = {
 	{Kyra::kDebugLevelSequence, "Sequence", "Sequence debug level"},
 	{Kyra::kDebugLevelMovie, "Movie", "Movie debug level"},
 	{Kyra::kDebugLevelTimer, "Timer", "Timer debug level"},
+	{Kyra::kDebugLevelShapes, "Shapes", "Shape drawing verification debug level"},
 	DEBUG_CHANNEL_END
 };
 
@@ -23,6 +23,7 @@
 #include "kyra/kyra_v1.h"
 #include "kyra/resource/resource.h"
 
+#include "common/debug-channels.h"
 #include "common/endian.h"
 #include "common/memstream.h"
 #include "common/system.h"
@@ -1759,7 +1760,43 @@ void Screen::drawShape(uint8 pageNum, const uint8 *shapeData, int x, int y, int
 		nullptr
 	};
 
-	int scaleCounterV = 0;
+#define DS_SPECIALIZED_LINE_FUNCS(plot) { \
+		&Screen::drawShapeProcessLineNoScaleUpwindT<&Screen::plot>, \
+		&Screen::drawShapeProcessLineNoScaleDownwindT<&Screen::plot>, \
+		&Screen::drawShapeProcessLineNoScaleUpwindT<&Screen::plot>, \
+		&Screen::drawShapeProcessLineNoScaleDownwindT<&Screen::plot>, \
+		&Screen::drawShapeProcessLineScaleUpwindT<&Screen::plot>, \
+		&Screen::drawShapeProcessLineScaleDownwindT<&Screen::plot>, \
+		&Screen::drawShapeProcessLineScaleUpwindT<&Screen::plot>, \
+		&Screen::drawShapeProcessLineScaleDownwindT<&Screen::plot> \
+	}
+
+	// Line functions with the plotting method inlined, for the plotting
+	// methods used most often. The layout matches dsLineFunc.
+	static const DsLineFunc dsSpecializedLineFunc[][8] = {
+		DS_SPECIALIZED_LINE_FUNCS(drawShapePlotType0),
+		DS_SPECIALIZED_LINE_FUNCS(drawShapePlotType1),
+		DS_SPECIALIZED_LINE_FUNCS(drawShapePlotType3_7),
+		DS_SPECIALIZED_LINE_FUNCS(drawShapePlotType4),
+		DS_SPECIALIZED_LINE_FUNCS(drawShapePlotType5),
+		DS_SPECIALIZED_LINE_FUNCS(drawShapePlotType8),
+		DS_SPECIALIZED_LINE_FUNCS(drawShapePlotType9),
+		DS_SPECIALIZED_LINE_FUNCS(drawShapePlotType11_15),
+		DS_SPECIALIZED_LINE_FUNCS(drawShapePlotType12),
+		DS_SPECIALIZED_LINE_FUNCS(drawShapePlotType13),
+		DS_SPECIALIZED_LINE_FUNCS(drawShapePlotType37),
+		DS_SPECIALIZED_LINE_FUNCS(drawShapePlotType52)
+	};
+
+#undef DS_SPECIALIZED_LINE_FUNCS
+
+	// Maps the plotting method type to its row in dsSpecializedLineFunc
+	static const int8 dsSpecializedIndex[] = {
+		 0,  1, -1,  2,  3,  4, -1,  2,  5,  6, -1,  7,  8,  9, -1,  7,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+	};
 
 	const int drawFunc = flags & 0x0F;
 	DsMarginSkipFunc dsProcessMargin = dsMarginFunc[drawFunc];
@@ -1767,12 +1804,11 @@ void Screen::drawShape(uint8 pageNum, const uint8 *shapeData, int x, int y, int
 	DsLineFunc dsProcessLine = dsLineFunc[drawFunc];
 
 	const int ppc = (flags >> 8) & 0x3F;
-	DsPlotFunc dsPlot = dsPlotFunc[ppc];
 	DsPlotFunc dsPlot2 = dsPlotFunc[ppc], dsPlot3 = dsPlotFunc[ppc];
 	if (_vm->gameFlags().gameID == GI_KYRA3 && (flags & kDRAWSHP_PRIORITY))
 		dsPlot3 = dsPlotFunc[ppc & ~8];
 
-	if (!dsPlot || !dsPlot2 || !dsPlot3) {
+	if (!dsPlot2 || !dsPlot3) {
 		if (!dsPlot2)
 			warning("Missing drawShape plotting method type %d", ppc);
 		if (dsPlot3 != dsPlot2 && !dsPlot3)
@@ -1780,6 +1816,44 @@ void Screen::drawShape(uint8 pageNum, const uint8 *shapeData, int x, int y, int
 		return;
 	}
 
+	// The specialized line functions can only be used if the same plotting
+	// method applies to all lines. Everything else uses the generic path.
+	if (dsPlot2 != dsPlot3 || dsSpecializedIndex[ppc] == -1) {
+		drawShapeIntern(pageNum, shapeData, x, y, sd, flags, dsProcessMargin, dsScaleSkip, dsProcessLine, dsPlot2, dsPlot3);
+		return;
+	}
+
+	DsLineFunc dsSpecializedLine = dsSpecializedLineFunc[dsSpecializedIndex[ppc]][drawFunc];
+
+	if (DebugMan.isDebugChannelEnabled(kDebugLevelShapes)) {
+		// Draw the shape through the generic path first, and make sure the
+		// specialized line function produces exactly the same result.
+		uint8 *page = getPagePtr(pageNum);
+		uint8 *backup = new uint8[_screenPageSize];
+		uint8 *expected = new uint8[_screenPageSize];
+
+		memcpy(backup, page, _screenPageSize);
+		drawShapeIntern(pageNum, shapeData, x, y, sd, flags, dsProcessMargin, dsScaleSkip, dsProcessLine, dsPlot2, dsPlot3);
+		memcpy(expected, page, _screenPageSize);
+		memcpy(page, backup, _screenPageSize);
+
+		drawShapeIntern(pageNum, shapeData, x, y, sd, flags, dsProcessMargin, dsScaleSkip, dsSpecializedLine, dsPlot2, dsPlot3);
+		if (memcmp(expected, page, _screenPageSize))
+			warning("Screen::drawShape(): specialized plotting method type %d, flags 0x%.04X differs from generic path", ppc, flags);
+
+		delete[] backup;
+		delete[] expected;
+		return;
+	}
+
+	drawShapeIntern(pageNum, shapeData, x, y, sd, flags, dsProcessMargin, dsScaleSkip, dsSpecializedLine, dsPlot2, dsPlot3);
+}
+
+void Screen::drawShapeIntern(uint8 pageNum, const uint8 *shapeData, int x, int y, int sd, int flags,
+	DsMarginSkipFunc dsProcessMargin, DsMarginSkipFunc dsScaleSkip, DsLineFunc dsProcessLine, DsPlotFunc dsPlot2, DsPlotFunc dsPlot3) {
+	int scaleCounterV = 0;
+	DsPlotFunc dsPlot = dsPlot2;
+
 	int curY = y;
 	const uint8 *src = shapeData;
 	uint8 *dst = _dsDstPage = getPagePtr(pageNum);
@@ -2173,6 +2247,96 @@ void Screen::drawShapeProcessLineScaleDownwind(uint8 *&dst, const uint8 *&src, c
 	cnt = -1;
 }
 
+template<Screen::DsPlotFunc plot>
+void Screen::drawShapeProcessLineNoScaleUpwindT(uint8 *&dst, const uint8 *&src, const DsPlotFunc, int &cnt, int16) {
+	do {
+		uint8 c = *src++;
+		if (c) {
+			uint8 *d = dst++;
+			(this->*plot)(d, c);
+			cnt--;
+		} else {
+			c = *src++;
+			dst += c;
+			cnt -= c;
+		}
+	} while (cnt > 0);
+}
+
+template<Screen::DsPlotFunc plot>
+void Screen::drawShapeProcessLineNoScaleDownwindT(uint8 *&dst, const uint8 *&src, const DsPlotFunc, int &cnt, int16) {
+	do {
+		uint8 c = *src++;
+		if (c) {
+			uint8 *d = dst--;
+			(this->*plot)(d, c);
+			cnt--;
+		} else {
+			c = *src++;
+			dst -= c;
+			cnt -= c;
+		}
+	} while (cnt > 0);
+}
+
+template<Screen::DsPlotFunc plot>
+void Screen::drawShapeProcessLineScaleUpwindT(uint8 *&dst, const uint8 *&src, const DsPlotFunc, int &cnt, int16 scaleState) {
+	int c = 0;
+
+	do {
+		if ((scaleState & 0x8000) || !(scaleState & 0xFF00)) {
+			c = *src++;
+			_dsTmpWidth--;
+			if (c) {
+				scaleState += _dsScaleW;
+			} else {
+				_dsTmpWidth++;
+				c = *src++;
+				_dsTmpWidth -= c;
+				int r = c * _dsScaleW + scaleState;
+				dst += (r >> 8);
+				cnt -= (r >> 8);
+				scaleState = r & 0xFF;
+			}
+		} else if (scaleState) {
+			(this->*plot)(dst++, c);
+			scaleState -= 0x100;
+			cnt--;
+		}
+	} while (cnt > 0);
+
+	cnt = -1;
+}
+
+template<Screen::DsPlotFunc plot>
+void Screen::drawShapeProcessLineScaleDownwindT(uint8 *&dst, const uint8 *&src, const DsPlotFunc, int &cnt, int16 scaleState) {
+	int c = 0;
+
+	do {
+		if ((scaleState & 0x8000) || !(scaleState & 0xFF00)) {
+			c = *src++;
+			_dsTmpWidth--;
+			if (c) {
+				scaleState += _dsScaleW;
+			} else {
+				_dsTmpWidth++;
+				c = *src++;
+				_dsTmpWidth -= c;
+				int r = c * _dsScaleW + scaleState;
+				dst -= (r >> 8);
+				cnt -= (r >> 8);
+				scaleState = r & 0xFF;
+			}
+		} else {
+			(this->*plot)(dst--, c);
+			scaleState -= 0x100;
+			cnt--;
+		}
+	} while (cnt > 0);
+
+	cnt = -1;
+}
+
 void Screen::drawShapePlotType0(uint8 *dst, uint8 cmd) {
 	*dst = cmd;
 }
@@ -915,6 +915,15 @@ protected:
 	void drawShapeProcessLineScaleUpwind(uint8 *&dst, const uint8 *&src, const DsPlotFunc plot, int &cnt, int16 scaleState);
 	void drawShapeProcessLineScaleDownwind(uint8 *&dst, const uint8 *&src, const DsPlotFunc plot, int &cnt, int16 scaleState);
 
+	// variants of the above with the plotting method resolved at compile time
+	template<DsPlotFunc plot> void drawShapeProcessLineNoScaleUpwindT(uint8 *&dst, const uint8 *&src, const DsPlotFunc, int &cnt, int16);
+	template<DsPlotFunc plot> void drawShapeProcessLineNoScaleDownwindT(uint8 *&dst, const uint8 *&src, const DsPlotFunc, int &cnt, int16);
+	template<DsPlotFunc plot> void drawShapeProcessLineScaleUpwindT(uint8 *&dst, const uint8 *&src, const DsPlotFunc, int &cnt, int16 scaleState);
+	template<DsPlotFunc plot> void drawShapeProcessLineScaleDownwindT(uint8 *&dst, const uint8 *&src, const DsPlotFunc, int &cnt, int16 scaleState);
+
+	void drawShapeIntern(uint8 pageNum, const uint8 *shapeData, int x, int y, int sd, int flags,
+		DsMarginSkipFunc dsProcessMargin, DsMarginSkipFunc dsScaleSkip, DsLineFunc dsProcessLine, DsPlotFunc dsPlot2, DsPlotFunc dsPlot3);
+
 	void drawShapePlotType0(uint8 *dst, uint8 cmd);
 	void drawShapePlotType1(uint8 *dst, uint8 cmd);
 	void drawShapePlotType3_7(uint8 *dst, uint8 cmd);
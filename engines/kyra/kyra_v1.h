@@ -103,7 +103,8 @@ enum DebugLevels {
 	kDebugLevelGUI         = 1 <<  7, ///< debug level for "KyraEngine*" gui functions
 	kDebugLevelSequence    = 1 <<  8, ///< debug level for "SeqPlayer" functions
 	kDebugLevelMovie       = 1 <<  9, ///< debug level for movie specific funtions
-	kDebugLevelTimer       = 1 << 10  ///< debug level for "TimerManager" functions
+	kDebugLevelTimer       = 1 << 10, ///< debug level for "TimerManager" functions
+	kDebugLevelShapes      = 1 << 11  ///< debug level for verifying the specialized "Screen::drawShape" paths
 };
 
 enum AudioResourceSet {
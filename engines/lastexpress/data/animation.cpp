@@ -27,7 +27,9 @@
 #include "lastexpress/data/snd.h"
 
 #include "lastexpress/debug.h"
+#include "lastexpress/graphics.h"
 #include "lastexpress/helpers.h"
+#include "lastexpress/lastexpress.h"
 
 #include "common/events.h"
 #include "common/rational.h"
@@ -258,7 +260,8 @@ void Animation::processChunkAudio(Common::SeekableReadStream *in, const Chunk &c
 // TODO: this method will probably go away and be integrated in the main loop
 void Animation::play() {
 	Common::EventManager *eventMan = g_system->getEventManager();
-	while (!hasEnded() && !Engine::shouldQuit()) {
+	bool interrupted = false;
+	while (!interrupted && !hasEnded() && !Engine::shouldQuit()) {
 		process();
 
 		if (_changed) {
@@ -292,10 +295,14 @@ void Animation::play() {
 					_audio->finish();
 
 				// TODO start LNK file sound?
-				return;
+				interrupted = true;
+				break;
 			}
 		}
 	}
+
+	// The animation was drawn directly to the screen, so the planes need to be fully redrawn
+	((LastExpressEngine *)g_engine)->getGraphicsManager()->invalidate();
 }
 
 } // End of namespace LastExpress
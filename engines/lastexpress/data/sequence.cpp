@@ -24,8 +24,10 @@
 #include "lastexpress/data/sequence.h"
 
 #include "lastexpress/debug.h"
+#include "lastexpress/lastexpress.h"
 
 #include "common/stream.h"
+#include "common/system.h"
 
 namespace LastExpress {
 
@@ -77,7 +79,7 @@ void FrameInfo::read(Common::SeekableReadStream *in, bool isSequence) {
 
 AnimFrame::AnimFrame(Common::SeekableReadStream *in, const FrameInfo &f, bool /* ignoreSubtype */) : _palette(nullptr) {
 	_palSize = 1;
-	// TODO: use just the needed rectangle
+	// The frame is decoded at full size and cropped to its contents afterwards
 	_image.create(640, 480, Graphics::PixelFormat::createFormatCLUT8());
 
 	//debugC(6, kLastExpressDebugGraphics, "    Offsets: data=%d, unknown=%d, palette=%d", f.dataOffset, f.unknown, f.paletteOffset);
@@ -119,6 +121,8 @@ AnimFrame::AnimFrame(Common::SeekableReadStream *in, const FrameInfo &f, bool /*
 	readPalette(in, f);
 	_rect = Common::Rect((int16)f.xPos1, (int16)f.yPos1, (int16)f.xPos2, (int16)f.yPos2);
 	//_rect.debugPrint(0, "Frame rect:");
+
+	crop();
 }
 
 AnimFrame::~AnimFrame() {
@@ -127,13 +131,60 @@ AnimFrame::~AnimFrame() {
 }
 
 Common::Rect AnimFrame::draw(Graphics::Surface *s) {
-	byte *inp = (byte *)_image.getPixels();
-	uint16 *outp = (uint16 *)s->getPixels();
-	for (int i = 0; i < 640 * 480; i++, inp++, outp++) {
-		if (*inp)
-			*outp = _palette[*inp];
+	for (int y = 0; y < _image.h; y++) {
+		const byte *inp = (const byte *)_image.getBasePtr(0, y);
+		uint16 *outp = (uint16 *)s->getBasePtr(_bounds.left, _bounds.top + y);
+
+		for (int x = 0; x < _image.w; x++) {
+			if (inp[x])
+				outp[x] = _palette[inp[x]];
+		}
 	}
-	return _rect;
+
+	// Some frames draw slightly outside of their declared rectangle
+	if (_rect.isEmpty())
+		return _bounds;
+
+	Common::Rect rect(_rect);
+	if (!_bounds.isEmpty())
+		rect.extend(_bounds);
+
+	return rect;
+}
+
+uint32 AnimFrame::getSize() const {
+	return sizeof(AnimFrame) + _image.w * _image.h + _palSize * sizeof(uint16);
+}
+
+void AnimFrame::crop() {
+	// Find the area that actually contains pixels
+	int16 left = 640, top = 480, right = 0, bottom = 0;
+	for (int16 y = 0; y < _image.h; y++) {
+		const byte *row = (const byte *)_image.getBasePtr(0, y);
+
+		for (int16 x = 0; x < _image.w; x++) {
+			if (!row[x])
+				continue;
+
+			left = MIN(left, x);
+			right = MAX<int16>(right, x + 1);
+			top = MIN(top, y);
+			bottom = y + 1;
+		}
+	}
+
+	Graphics::Surface image;
+	if (left < right && top < bottom) {
+		_bounds = Common::Rect(left, top, right, bottom);
+
+		image.create(_bounds.width(), _bounds.height(), Graphics::PixelFormat::createFormatCLUT8());
+		image.copyRectToSurface(_image, 0, 0, _bounds);
+	} else {
+		_bounds = Common::Rect();
+	}
+
+	_image.free();
+	_image = image;
 }
 
 void AnimFrame::readPalette(Common::SeekableReadStream *in, const FrameInfo &f) {
@@ -333,6 +384,11 @@ void AnimFrame::decompFF(Common::SeekableReadStream *in, const FrameInfo &f) {
 //////////////////////////////////////////////////////////////////////////
 
 Sequence::~Sequence() {
+	// Make sure no frame of this sequence is still waiting to be decoded
+	FrameCache *cache = ((LastExpressEngine *)g_engine)->getFrameCache();
+	if (cache)
+		cache->cancel(this);
+
 	reset();
 }
 
@@ -433,15 +489,29 @@ Common::Rect SequenceFrame::draw(Graphics::Surface *surface) {
 	if (!_sequence || _frame >= _sequence->count())
 		return Common::Rect();
 
-	AnimFrame *f = _sequence->getFrame(_frame);
-	if (!f)
-		return Common::Rect();
+	FrameCache *cache = ((LastExpressEngine *)g_engine)->getFrameCache();
+	if (!cache) {
+		AnimFrame *f = _sequence->getFrame(_frame);
+		if (!f)
+			return Common::Rect();
 
-	Common::Rect rect = f->draw(surface);
+		Common::Rect rect = f->draw(surface);
 
-	delete f;
+		delete f;
 
-	return rect;
+		return rect;
+	}
+
+	AnimFrame *f = cache->getFrame(_sequence, _frame);
+
+	// Get the next frame ready while the game is waiting for the next tick
+	if (_frame + 1 < _sequence->count())
+		cache->schedule(_sequence, _frame + 1);
+
+	if (!f)
+		return Common::Rect();
+
+	return f->draw(surface);
 }
 
 bool SequenceFrame::setFrame(uint16 frame) {
@@ -477,4 +547,135 @@ bool SequenceFrame::equal(const SequenceFrame *other) const {
 	return _sequence->getName() == other->_sequence->getName() && _frame == other->_frame;
 }
 
+//////////////////////////////////////////////////////////////////////////
+// FrameCache
+//////////////////////////////////////////////////////////////////////////
+
+// Maximum number of frames waiting to be decoded
+#define MAX_FRAME_REQUESTS 32
+
+FrameCache::FrameCache(uint32 budget) : _budget(budget), _size(0), _hits(0), _misses(0), _predecoded(0), _evictions(0) {
+}
+
+FrameCache::~FrameCache() {
+	clear();
+}
+
+Common::String FrameCache::getKey(Sequence *sequence, uint16 index) {
+	return Common::String::format("%s:%d", sequence->getName().c_str(), index);
+}
+
+AnimFrame *FrameCache::getFrame(Sequence *sequence, uint16 index) {
+	Common::String key = getKey(sequence, index);
+
+	EntryMap::iterator it = _map.find(key);
+	if (it != _map.end()) {
+		_hits++;
+
+		// Move to the front of the list
+		EntryList::iterator entry = it->_value;
+		if (entry != _entries.begin()) {
+			_entries.push_front(*entry);
+			_entries.erase(entry);
+			it->_value = _entries.begin();
+		}
+
+		return _entries.front().frame;
+	}
+
+	_misses++;
+
+	return decode(sequence, index, key);
+}
+
+AnimFrame *FrameCache::decode(Sequence *sequence, uint16 index, const Common::String &key) {
+	AnimFrame *frame = sequence->getFrame(index);
+	if (!frame)
+		return nullptr;
+
+	Entry entry;
+	entry.key = key;
+	entry.frame = frame;
+	entry.size = frame->getSize();
+
+	_entries.push_front(entry);
+	_map[key] = _entries.begin();
+	_size += entry.size;
+
+	// Evict the least recently used frames, but always keep the new one
+	while (_size > _budget && _entries.size() > 1) {
+		Entry &last = _entries.back();
+
+		_size -= last.size;
+		_map.erase(last.key);
+		delete last.frame;
+		_entries.pop_back();
+
+		_evictions++;
+	}
+
+	return frame;
+}
+
+void FrameCache::schedule(Sequence *sequence, uint16 index) {
+	if (!sequence->isLoaded() || index >= sequence->count())
+		return;
+
+	if (_map.contains(getKey(sequence, index)))
+		return;
+
+	for (Common::List<Request>::const_iterator it = _requests.begin(); it != _requests.end(); ++it)
+		if (it->sequence == sequence && it->index == index)
+			return;
+
+	if (_requests.size() >= MAX_FRAME_REQUESTS)
+		_requests.pop_front();
+
+	Request request;
+	request.sequence = sequence;
+	request.index = index;
+	_requests.push_back(request);
+}
+
+void FrameCache::cancel(Sequence *sequence) {
+	Common::List<Request>::iterator it = _requests.begin();
+	while (it != _requests.end()) {
+		if (it->sequence == sequence)
+			it = _requests.erase(it);
+		else
+			++it;
+	}
+}
+
+void FrameCache::predecode(uint32 endTime) {
+	while (!_requests.empty() && g_system->getMillis() < endTime) {
+		Request request = _requests.front();
+		_requests.pop_front();
+
+		Common::String key = getKey(request.sequence, request.index);
+		if (_map.contains(key))
+			continue;
+
+		if (decode(request.sequence, request.index, key))
+			_predecoded++;
+	}
+}
+
+void FrameCache::clear() {
+	for (EntryList::iterator it = _entries.begin(); it != _entries.end(); ++it)
+		delete it->frame;
+
+	_entries.clear();
+	_map.clear();
+	_requests.clear();
+	_size = 0;
+}
+
+void FrameCache::resetStats() {
+	_hits = 0;
+	_misses = 0;
+	_predecoded = 0;
+	_evictions = 0;
+}
+
 } // End of namespace LastExpress
@@ -74,6 +74,8 @@
 #include "lastexpress/shared.h"
 
 #include "common/array.h"
+#include "common/hashmap.h"
+#include "common/list.h"
 #include "common/rect.h"
 #include "common/str.h"
 
@@ -133,7 +135,11 @@ public:
 	~AnimFrame() override;
 	Common::Rect draw(Graphics::Surface *s) override;
 
+	// Memory used by the decoded frame
+	uint32 getSize() const;
+
 private:
+	void crop();
 	void decomp3(Common::SeekableReadStream *in, const FrameInfo &f);
 	void decomp4(Common::SeekableReadStream *in, const FrameInfo &f);
 	void decomp34(Common::SeekableReadStream *in, const FrameInfo &f, byte mask, byte shift);
@@ -142,10 +148,11 @@ private:
 	void decompFF(Common::SeekableReadStream *in, const FrameInfo &f);
 	void readPalette(Common::SeekableReadStream *in, const FrameInfo &f);
 
-	Graphics::Surface _image;
+	Graphics::Surface _image;  ///< Decoded pixels, cropped to _bounds
 	uint16 _palSize;
 	uint16 *_palette;
 	Common::Rect _rect;
+	Common::Rect _bounds;
 };
 
 class Sequence {
@@ -202,6 +209,75 @@ private:
 	bool _dispose;
 };
 
+/**
+ * Cache of decoded sequence frames.
+ *
+ * Frames are keyed by sequence name and frame index, so that sequences
+ * reloaded by entities reuse the frames decoded for a previous instance.
+ * The least recently used frames are evicted once the memory budget is
+ * exceeded. Frames following the ones that were drawn are queued and
+ * decoded ahead of time when the engine is idle.
+ */
+class FrameCache {
+public:
+	FrameCache(uint32 budget = 8 * 1024 * 1024);
+	~FrameCache();
+
+	// Get a decoded frame, owned by the cache (valid until the next call)
+	AnimFrame *getFrame(Sequence *sequence, uint16 index);
+
+	// Queue a frame to be decoded during idle time
+	void schedule(Sequence *sequence, uint16 index);
+
+	// Remove all the queued frames of a sequence that is being destroyed
+	void cancel(Sequence *sequence);
+
+	// Decode queued frames until the given time (in milliseconds) is reached
+	void predecode(uint32 endTime);
+
+	void clear();
+
+	// Statistics
+	uint32 getHits() const { return _hits; }
+	uint32 getMisses() const { return _misses; }
+	uint32 getPredecoded() const { return _predecoded; }
+	uint32 getEvictions() const { return _evictions; }
+	uint32 getCount() const { return _entries.size(); }
+	uint32 getSize() const { return _size; }
+	uint32 getBudget() const { return _budget; }
+	void resetStats();
+
+private:
+	struct Entry {
+		Common::String key;
+		AnimFrame *frame;
+		uint32 size;
+	};
+
+	struct Request {
+		Sequence *sequence;
+		uint16 index;
+	};
+
+	typedef Common::List<Entry> EntryList;
+	typedef Common::HashMap<Common::String, EntryList::iterator, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> EntryMap;
+
+	static Common::String getKey(Sequence *sequence, uint16 index);
+	AnimFrame *decode(Sequence *sequence, uint16 index, const Common::String &key);
+
+	EntryList _entries; ///< Most recently used first
+	EntryMap _map;
+	Common::List<Request> _requests;
+
+	uint32 _budget;
+	uint32 _size;
+
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _predecoded;
+	uint32 _evictions;
+};
+
 } // End of namespace LastExpress
 
 #endif // LASTEXPRESS_SEQUENCE_H
@@ -68,6 +68,8 @@ Debugger::Debugger(LastExpressEngine *engine) : _engine(engine), _command(nullpt
 	registerCmd("showframe", WRAP_METHOD(Debugger, cmdShowFrame));
 	registerCmd("showbg",    WRAP_METHOD(Debugger, cmdShowBg));
 	registerCmd("playseq",   WRAP_METHOD(Debugger, cmdPlaySeq));
+	registerCmd("benchseq",  WRAP_METHOD(Debugger, cmdBenchSeq));
+	registerCmd("framecache", WRAP_METHOD(Debugger, cmdFrameCache));
 	registerCmd("playsnd",   WRAP_METHOD(Debugger, cmdPlaySnd));
 	registerCmd("playsbe",   WRAP_METHOD(Debugger, cmdPlaySbe));
 	registerCmd("playnis",   WRAP_METHOD(Debugger, cmdPlayNis));
@@ -210,6 +212,8 @@ bool Debugger::cmdHelp(int, const char **) {
 	debugPrintf(" showframe - show a frame from a sequence\n");
 	debugPrintf(" showbg - show a background\n");
 	debugPrintf(" playseq - play a sequence\n");
+	debugPrintf(" benchseq - time the screen merging for a sequence\n");
+	debugPrintf(" framecache - show or reset the decoded frame cache statistics\n");
 	debugPrintf(" playsnd - play a sound\n");
 	debugPrintf(" playsbe - play a subtitle\n");
 	debugPrintf(" playnis - play an animation\n");
@@ -510,6 +514,115 @@ bool Debugger::cmdPlaySeq(int argc, const char **argv) {
 	return true;
 }
 
+/**
+ * Command: replays a sequence without displaying it and times the merging of the screen planes
+ *
+ * @param argc The argument count.
+ * @param argv The values.
+ *
+ * @return true if it was handled, false otherwise
+ */
+bool Debugger::cmdBenchSeq(int argc, const char **argv) {
+	if (argc >= 2 && argc <= 4) {
+		Common::String filename(const_cast<char *>(argv[1]));
+		filename += ".seq";
+
+		int loops = (argc >= 3) ? getNumber(argv[2]) : 10;
+		if (loops <= 0)
+			loops = 1;
+
+		if (argc == 4) {
+			if (!loadArchive(getNumber(argv[3])))
+				return true;
+		}
+
+		if (!_engine->getResourceManager()->hasFile(Common::Path(filename))) {
+			debugPrintf("Cannot find file: %s\n", filename.c_str());
+		} else {
+			Sequence *sequence = new Sequence(filename);
+			if (sequence->load(getArchiveMember(filename)) && sequence->count() != 0) {
+				GraphicsManager *graphics = _engine->getGraphicsManager();
+				uint32 frames = 0;
+				uint32 elapsed[2] = { 0, 0 };
+
+				// First pass only merges the dirty regions, second pass merges the whole screen every frame
+				for (int pass = 0; pass < 2; pass++) {
+					clearBg(GraphicsManager::kBackgroundA);
+					graphics->mergeDirty();
+
+					frames = 0;
+					for (int loop = 0; loop < loops; loop++) {
+						for (uint16 i = 0; i < sequence->count(); i++) {
+							// Only the last frame needs to be removed
+							if (i > 0) {
+								FrameInfo *info = sequence->getFrameInfo(i - 1);
+								graphics->clear(GraphicsManager::kBackgroundA, Common::Rect((int16)info->xPos1, (int16)info->yPos1, (int16)info->xPos2, (int16)info->yPos2));
+							}
+
+							SequenceFrame frame(sequence, i, false);
+							graphics->draw(&frame, GraphicsManager::kBackgroundA);
+
+							if (pass == 1)
+								graphics->invalidate();
+
+							uint32 start = _engine->_system->getMillis();
+							graphics->mergeDirty();
+							elapsed[pass] += _engine->_system->getMillis() - start;
+
+							frames++;
+						}
+					}
+				}
+
+				debugPrintf("%s: %d frames\n", filename.c_str(), frames);
+				debugPrintf(" dirty regions: %d ms\n", elapsed[0]);
+				debugPrintf(" full screen:   %d ms\n", elapsed[1]);
+
+				clearBg(GraphicsManager::kBackgroundA);
+				graphics->invalidate();
+			}
+
+			delete sequence;
+		}
+
+		if (argc == 4)
+			restoreArchive();
+	} else {
+		debugPrintf("Syntax: benchseq <seqname> (<loops>) (<cd number>)\n");
+	}
+	return true;
+}
+
+/**
+ * Command: shows the decoded frame cache statistics
+ *
+ * @param argc The argument count.
+ * @param argv The values.
+ *
+ * @return true if it was handled, false otherwise
+ */
+bool Debugger::cmdFrameCache(int argc, const char **argv) {
+	FrameCache *cache = _engine->getFrameCache();
+
+	if (argc == 1) {
+		uint32 lookups = cache->getHits() + cache->getMisses();
+
+		debugPrintf("Frames:      %d (%d / %d KB)\n", cache->getCount(), cache->getSize() / 1024, cache->getBudget() / 1024);
+		debugPrintf("Hits:        %d (%d%%)\n", cache->getHits(), lookups ? cache->getHits() * 100 / lookups : 0);
+		debugPrintf("Misses:      %d\n", cache->getMisses());
+		debugPrintf("Predecoded:  %d\n", cache->getPredecoded());
+		debugPrintf("Evictions:   %d\n", cache->getEvictions());
+	} else if (argc == 2 && !strcmp(argv[1], "reset")) {
+		cache->resetStats();
+	} else if (argc == 2 && !strcmp(argv[1], "clear")) {
+		cache->clear();
+	} else {
+		debugPrintf("Syntax: framecache (reset|clear)\n");
+	}
+
+	return true;
+}
+
 /**
  * Command: plays a sound
  *
@@ -63,6 +63,8 @@ private:
 	bool cmdShowFrame(int argc, const char **argv);
 	bool cmdShowBg(int argc, const char **argv);
 	bool cmdPlaySeq(int argc, const char **argv);
+	bool cmdBenchSeq(int argc, const char **argv);
+	bool cmdFrameCache(int argc, const char **argv);
 	bool cmdPlaySnd(int argc, const char **argv);
 	bool cmdPlaySbe(int argc, const char **argv);
 	bool cmdPlayNis(int argc, const char **argv);
@@ -27,9 +27,25 @@
 
 namespace LastExpress {
 
-#define COLOR_KEY  0xFFFF
+// Above this number of dirty rectangles, the whole screen is merged instead
+#define MAX_DIRTY_RECTS 32
+
+static void mergeRow(uint16 *screen, const uint16 *inventory, const uint16 *overlay, const uint16 *backgroundA, const uint16 *backgroundC, uint count) {
+	for (uint i = 0; i < count; i++) {
+		if (inventory[i] != COLOR_KEY)
+			screen[i] = inventory[i];
+		else if (overlay[i] != COLOR_KEY)
+			screen[i] = overlay[i];
+		else if (backgroundA[i] != COLOR_KEY)
+			screen[i] = backgroundA[i];
+		else if (backgroundC[i] != COLOR_KEY)
+			screen[i] = backgroundC[i];
+		else
+			screen[i] = 0;
+	}
+}
 
-GraphicsManager::GraphicsManager() : _changed(false) {
+GraphicsManager::GraphicsManager() : _mergeRow(mergeRow), _changed(false) {
 	const Graphics::PixelFormat format(2, 5, 5, 5, 0, 10, 5, 0, 0);
 	_screen.create(640, 480, format);
 
@@ -40,6 +56,15 @@ GraphicsManager::GraphicsManager() : _changed(false) {
 	_inventory.create(640, 480, format);
 
 	clear(kBackgroundAll);
+
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		_mergeRow = mergeRowNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		_mergeRow = mergeRowSSE2;
+#endif
 }
 
 GraphicsManager::~GraphicsManager() {
@@ -64,6 +89,48 @@ void GraphicsManager::change() {
 	_changed = true;
 }
 
+void GraphicsManager::invalidate() {
+	addDirtyRect(Common::Rect(640, 480));
+	_changed = true;
+}
+
+void GraphicsManager::mergeDirty() {
+	mergePlanes();
+	_dirtyRects.clear();
+}
+
+void GraphicsManager::addDirtyRect(const Common::Rect &r) {
+	Common::Rect rect(r);
+	rect.clip(Common::Rect(640, 480));
+
+	if (!rect.isValidRect() || rect.isEmpty())
+		return;
+
+	// Merge with any overlapping rectangle, restarting the scan since the grown
+	// rectangle might now overlap some of the ones already checked
+	Common::List<Common::Rect>::iterator it = _dirtyRects.begin();
+	while (it != _dirtyRects.end()) {
+		if (it->contains(rect))
+			return;
+
+		if (rect.intersects(*it)) {
+			rect.extend(*it);
+			_dirtyRects.erase(it);
+			it = _dirtyRects.begin();
+			continue;
+		}
+
+		++it;
+	}
+
+	if (_dirtyRects.size() >= MAX_DIRTY_RECTS) {
+		_dirtyRects.clear();
+		rect = Common::Rect(640, 480);
+	}
+
+	_dirtyRects.push_back(rect);
+}
+
 void GraphicsManager::clear(BackgroundType type) {
 	clear(type, Common::Rect(640, 480));
 }
@@ -79,6 +146,7 @@ void GraphicsManager::clear(BackgroundType type, const Common::Rect &rect) {
 		case kBackgroundOverlay:
 		case kBackgroundInventory:
 			getSurface(type)->fillRect(rect, COLOR_KEY);
+			addDirtyRect(rect);
 			break;
 
 		case kBackgroundAll:
@@ -86,6 +154,7 @@ void GraphicsManager::clear(BackgroundType type, const Common::Rect &rect) {
 			_backgroundC.fillRect(rect, COLOR_KEY);
 			_overlay.fillRect(rect, COLOR_KEY);
 			_inventory.fillRect(rect, COLOR_KEY);
+			addDirtyRect(rect);
 			break;
 	}
 }
@@ -95,8 +164,8 @@ bool GraphicsManager::draw(Drawable *drawable, BackgroundType type, bool transit
 	if (transition)
 		clear(type);
 
-	// TODO store rect for later use
 	Common::Rect rect = drawable->draw(getSurface(type));
+	addDirtyRect(rect);
 
 	return (!rect.isEmpty());
 }
@@ -125,41 +194,26 @@ Graphics::Surface *GraphicsManager::getSurface(BackgroundType type) {
 	}
 }
 
-// TODO optimize to only merge dirty rects
 void GraphicsManager::mergePlanes() {
-	// Clear screen surface
-	_screen.fillRect(Common::Rect(640, 480), 0);
-
-	uint16 *screen = (uint16 *)_screen.getPixels();
-	uint16 *inventory = (uint16 *)_inventory.getPixels();
-	uint16 *overlay = (uint16 *)_overlay.getPixels();
-	uint16 *backgroundC = (uint16 *)_backgroundC.getPixels();
-	uint16 *backgroundA = (uint16 *)_backgroundA.getPixels();
-
-	for (int i = 0; i < 640 * 480; i++) {
-
-		if (*inventory != COLOR_KEY)
-			*screen = *inventory;
-		else if (*overlay != COLOR_KEY)
-			*screen = *overlay;
-		else if (*backgroundA != COLOR_KEY)
-			*screen = *backgroundA;
-		else if (*backgroundC != COLOR_KEY)
-			*screen = *backgroundC;
-		else
-			*screen = 0;
-
-		inventory++;
-		screen++;
-		overlay++;
-		backgroundA++;
-		backgroundC++;
+	for (Common::List<Common::Rect>::const_iterator it = _dirtyRects.begin(); it != _dirtyRects.end(); ++it) {
+		const Common::Rect &rect = *it;
+
+		for (int y = rect.top; y < rect.bottom; y++) {
+			_mergeRow((uint16 *)_screen.getBasePtr(rect.left, y),
+			          (const uint16 *)_inventory.getBasePtr(rect.left, y),
+			          (const uint16 *)_overlay.getBasePtr(rect.left, y),
+			          (const uint16 *)_backgroundA.getBasePtr(rect.left, y),
+			          (const uint16 *)_backgroundC.getBasePtr(rect.left, y),
+			          rect.width());
+		}
 	}
 }
 
 void GraphicsManager::updateScreen() {
-	g_system->fillScreen(0);
-	g_system->copyRectToScreen(_screen.getPixels(), 640 * 2, 0, 0, 640, 480);
+	for (Common::List<Common::Rect>::const_iterator it = _dirtyRects.begin(); it != _dirtyRects.end(); ++it)
+		g_system->copyRectToScreen(_screen.getBasePtr(it->left, it->top), _screen.pitch, it->left, it->top, it->width(), it->height());
+
+	_dirtyRects.clear();
 }
 
 } // End of namespace LastExpress
@@ -24,8 +24,12 @@
 
 #include "lastexpress/drawable.h"
 
+#include "common/list.h"
+
 namespace LastExpress {
 
+#define COLOR_KEY  0xFFFF
+
 class GraphicsManager {
 public:
 	enum BackgroundType {
@@ -45,6 +49,12 @@ public:
 	// Signal a change to the screen, will cause the planes to be remerged
 	void change();
 
+	// Mark the whole screen as dirty (after something wrote directly to the backend screen)
+	void invalidate();
+
+	// Merge the dirty parts of the planes into the screen surface, without uploading them
+	void mergeDirty();
+
 	// Clear some screen parts
 	void clear(BackgroundType type);
 	void clear(BackgroundType type, const Common::Rect &rect);
@@ -60,13 +70,29 @@ private:
 	Graphics::Surface _overlay;     // Overlay
 	Graphics::Surface _inventory;   // Overlay
 
+	typedef void (*MergeRowProc)(uint16 *screen, const uint16 *inventory, const uint16 *overlay, const uint16 *backgroundA, const uint16 *backgroundC, uint count);
+
 	void mergePlanes();
 	void updateScreen();
 	Graphics::Surface *getSurface(BackgroundType type);
 
+	// Dirty rectangles, shared by all planes
+	void addDirtyRect(const Common::Rect &rect);
+
+	Common::List<Common::Rect> _dirtyRects;
+	MergeRowProc _mergeRow;
+
 	bool _changed;
 };
 
+#ifdef SCUMMVM_SSE2
+void mergeRowSSE2(uint16 *screen, const uint16 *inventory, const uint16 *overlay, const uint16 *backgroundA, const uint16 *backgroundC, uint count);
+#endif
+
+#ifdef SCUMMVM_NEON
+void mergeRowNEON(uint16 *screen, const uint16 *inventory, const uint16 *overlay, const uint16 *backgroundA, const uint16 *backgroundC, uint count);
+#endif
+
 } // End of namespace LastExpress
 
 #endif // LASTEXPRESS_GRAPHICS_H
@@ -0,0 +1,69 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "lastexpress/graphics.h"
+
+#ifdef SCUMMVM_NEON
+
+#include <arm_neon.h>
+
+namespace LastExpress {
+
+void mergeRowNEON(uint16 *screen, const uint16 *inventory, const uint16 *overlay, const uint16 *backgroundA, const uint16 *backgroundC, uint count) {
+	const uint16x8_t key = vdupq_n_u16(COLOR_KEY);
+	const uint16x8_t zero = vdupq_n_u16(0);
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8) {
+		// Start from the bottom plane and overwrite with every non-transparent pixel above it
+		uint16x8_t c = vld1q_u16(backgroundC + i);
+		uint16x8_t pixels = vbslq_u16(vceqq_u16(c, key), zero, c);
+
+		uint16x8_t a = vld1q_u16(backgroundA + i);
+		pixels = vbslq_u16(vceqq_u16(a, key), pixels, a);
+
+		uint16x8_t o = vld1q_u16(overlay + i);
+		pixels = vbslq_u16(vceqq_u16(o, key), pixels, o);
+
+		uint16x8_t inv = vld1q_u16(inventory + i);
+		pixels = vbslq_u16(vceqq_u16(inv, key), pixels, inv);
+
+		vst1q_u16(screen + i, pixels);
+	}
+
+	for (; i < count; i++) {
+		if (inventory[i] != COLOR_KEY)
+			screen[i] = inventory[i];
+		else if (overlay[i] != COLOR_KEY)
+			screen[i] = overlay[i];
+		else if (backgroundA[i] != COLOR_KEY)
+			screen[i] = backgroundA[i];
+		else if (backgroundC[i] != COLOR_KEY)
+			screen[i] = backgroundC[i];
+		else
+			screen[i] = 0;
+	}
+}
+
+} // End of namespace LastExpress
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,68 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "lastexpress/graphics.h"
+
+#ifdef SCUMMVM_SSE2
+
+#include <emmintrin.h>
+
+namespace LastExpress {
+
+static inline __m128i selectPixels(__m128i top, __m128i below, __m128i key) {
+	// Keep the pixels from the top plane unless they are transparent
+	__m128i mask = _mm_cmpeq_epi16(top, key);
+	return _mm_or_si128(_mm_and_si128(mask, below), _mm_andnot_si128(mask, top));
+}
+
+void mergeRowSSE2(uint16 *screen, const uint16 *inventory, const uint16 *overlay, const uint16 *backgroundA, const uint16 *backgroundC, uint count) {
+	const __m128i key = _mm_set1_epi16((int16)COLOR_KEY);
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128i c = _mm_loadu_si128((const __m128i *)(backgroundC + i));
+		__m128i pixels = _mm_andnot_si128(_mm_cmpeq_epi16(c, key), c);
+
+		pixels = selectPixels(_mm_loadu_si128((const __m128i *)(backgroundA + i)), pixels, key);
+		pixels = selectPixels(_mm_loadu_si128((const __m128i *)(overlay + i)), pixels, key);
+		pixels = selectPixels(_mm_loadu_si128((const __m128i *)(inventory + i)), pixels, key);
+
+		_mm_storeu_si128((__m128i *)(screen + i), pixels);
+	}
+
+	for (; i < count; i++) {
+		if (inventory[i] != COLOR_KEY)
+			screen[i] = inventory[i];
+		else if (overlay[i] != COLOR_KEY)
+			screen[i] = overlay[i];
+		else if (backgroundA[i] != COLOR_KEY)
+			screen[i] = backgroundA[i];
+		else if (backgroundC[i] != COLOR_KEY)
+			screen[i] = backgroundC[i];
+		else
+			screen[i] = 0;
+	}
+}
+
+} // End of namespace LastExpress
+
+#endif // SCUMMVM_SSE2
@@ -23,6 +23,7 @@
 
 #include "lastexpress/data/cursor.h"
 #include "lastexpress/data/font.h"
+#include "lastexpress/data/sequence.h"
 
 #include "lastexpress/game/logic.h"
 #include "lastexpress/game/scenes.h"
@@ -57,7 +58,7 @@ LastExpressEngine::LastExpressEngine(OSystem *syst, const ADGameDescription *gd)
 	_font(nullptr), _logic(nullptr), _menu(nullptr),
 	_lastFrameCount(0),
 	_graphicsMan(nullptr), _resMan(nullptr),
-	_sceneMan(nullptr), _soundMan(nullptr),
+	_sceneMan(nullptr), _soundMan(nullptr), _frameCache(nullptr),
 	_eventMouse(nullptr), _eventTick(nullptr),
 	_eventMouseBackup(nullptr), _eventTickBackup(nullptr)
 	{
@@ -79,6 +80,8 @@ LastExpressEngine::~LastExpressEngine() {
 	SAFE_DELETE(_resMan);
 	SAFE_DELETE(_sceneMan);
 	SAFE_DELETE(_soundMan);
+	// Sequences still alive above need the frame cache when they are destroyed
+	SAFE_DELETE(_frameCache);
 	//_debugger is deleted by Engine
 
 	// Cleanup event handlers
@@ -115,6 +118,7 @@ Common::Error LastExpressEngine::run() {
 		return Common::kNoGameDataFoundError;
 
 	_graphicsMan = new GraphicsManager();
+	_frameCache = new FrameCache();
 
 	// Load the cursor data
 	_cursor = _resMan->loadCursor();
@@ -177,7 +181,7 @@ void LastExpressEngine::pollEvents() {
 
 bool LastExpressEngine::handleEvents() {
 	// Make sure all the subsystems have been initialized
-	if (!_debugger || !_graphicsMan)
+	if (!_debugger || !_graphicsMan || !_frameCache)
 		error("[LastExpressEngine::handleEvents] Called before the required subsystems have been initialized");
 
 	// Execute stored commands
@@ -250,7 +254,14 @@ bool LastExpressEngine::handleEvents() {
 	// Update the screen
 	_graphicsMan->update();
 	_system->updateScreen();
-	_system->delayMillis(50);
+
+	// Use the idle time to decode the upcoming sequence frames
+	uint32 idleEnd = _system->getMillis() + 50;
+	_frameCache->predecode(idleEnd);
+
+	uint32 now = _system->getMillis();
+	if (now < idleEnd)
+		_system->delayMillis(idleEnd - now);
 
 	// The event loop may have triggered the quit status. In this case,
 	// stop the execution.
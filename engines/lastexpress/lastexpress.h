@@ -59,6 +59,7 @@ namespace LastExpress {
 
 class Cursor;
 class Font;
+class FrameCache;
 class GraphicsManager;
 class Logic;
 class Menu;
@@ -90,6 +91,7 @@ public:
 	ResourceManager *getResourceManager() const { return _resMan; }
 	SceneManager    *getSceneManager()    const { return _sceneMan; }
 	SoundManager    *getSoundManager()    const { return _soundMan; }
+	FrameCache      *getFrameCache()      const { return _frameCache; }
 
 	// Event handling
 	bool handleEvents();
@@ -129,6 +131,7 @@ private:
 	ResourceManager *_resMan;
 	SceneManager    *_sceneMan;
 	SoundManager    *_soundMan;
+	FrameCache      *_frameCache;
 
 	// Event handlers
 	EventHandler::EventFunction *_eventMouse;
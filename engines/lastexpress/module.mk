@@ -74,6 +74,17 @@ MODULE_OBJS := \
 	metaengine.o \
 	resource.o
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	graphics_neon.o
+$(MODULE)/graphics_neon.o: CXXFLAGS += $(NEON_CXXFLAGS)
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	graphics_sse2.o
+$(MODULE)/graphics_sse2.o: CXXFLAGS += -msse2
+endif
+
 # This module can be built as a plugin
 ifeq ($(ENABLE_LASTEXPRESS), DYNAMIC_PLUGIN)
 PLUGIN := 1
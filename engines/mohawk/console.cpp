@@ -392,6 +392,7 @@ RivenConsole::RivenConsole(MohawkEngine_Riven *vm) : GUI::Debugger(), _vm(vm) {
 	registerCmd("combos",         WRAP_METHOD(RivenConsole, Cmd_Combos));
 	registerCmd("sliderState",    WRAP_METHOD(RivenConsole, Cmd_SliderState));
 	registerCmd("quickTest",      WRAP_METHOD(RivenConsole, Cmd_QuickTest));
+	registerCmd("walkCards",      WRAP_METHOD(RivenConsole, Cmd_WalkCards));
 	registerVar("show_hotspots",  &_vm->_showHotspots);
 }
 
@@ -747,6 +748,67 @@ bool RivenConsole::Cmd_QuickTest(int argc, const char **argv) {
 	return true;
 }
 
+bool RivenConsole::Cmd_WalkCards(int argc, const char **argv) {
+	if (argc < 2) {
+		debugPrintf("Usage: walkCards <prefetch> [<card> ...]\n");
+		debugPrintf("Go through the listed cards, or through all the cards of the current stack,\n");
+		debugPrintf("and record the time spent decoding images for each transition.\n");
+		debugPrintf("When <prefetch> is 1, the prefetch queue is processed between transitions.\n");
+		return true;
+	}
+
+	bool prefetch = atoi(argv[1]) != 0;
+
+	Common::Array<uint16> cardIds;
+	if (argc > 2) {
+		for (int i = 2; i < argc; i++)
+			cardIds.push_back((uint16)atoi(argv[i]));
+	} else {
+		cardIds = _vm->getResourceIDList(ID_CARD);
+	}
+
+	_debugPauseToken.clear();
+
+	uint16 stackId = _vm->getStack()->getId();
+	_vm->_gfx->setTransitionMode(kRivenTransitionModeDisabled);
+
+	uint32 totalTime = 0;
+	uint32 maxTime = 0;
+	uint transitions = 0;
+
+	for (uint i = 0; i < cardIds.size(); i++) {
+		if (_vm->shouldQuit() || _vm->getStack()->getId() != stackId)
+			break;
+
+		uint32 decodeStart = _vm->_gfx->getDecodeTime();
+
+		RivenScriptPtr script = _vm->_scriptMan->createScriptFromData(1, kRivenCommandChangeCard, 1, cardIds[i]);
+		_vm->_scriptMan->runScript(script, true);
+
+		while (_vm->_scriptMan->hasQueuedScripts()) {
+			_vm->doFrame();
+		}
+
+		uint32 decodeTime = _vm->_gfx->getDecodeTime() - decodeStart;
+		debug("Card %d: %d ms decoding", cardIds[i], decodeTime);
+
+		totalTime += decodeTime;
+		maxTime = MAX(maxTime, decodeTime);
+		transitions++;
+
+		// Simulate the player looking at the card for a while
+		if (prefetch) {
+			while (_vm->_gfx->prefetchNext())
+				;
+		}
+	}
+
+	_debugPauseToken = _vm->pauseEngine();
+
+	debugPrintf("%d transitions, %d ms decoding in total, %d ms at most\n", transitions, totalTime, maxTime);
+	return true;
+}
+
 #endif // ENABLE_RIVEN
 
 LivingBooksConsole::LivingBooksConsole(MohawkEngine_LivingBooks *vm) : GUI::Debugger(), _vm(vm) {
@@ -55,6 +55,7 @@ private:
 	bool Cmd_Cache(int argc, const char **argv);
 	bool Cmd_Resources(int argc, const char **argv);
 	bool Cmd_QuickTest(int argc, const char **argv);
+	bool Cmd_WalkCards(int argc, const char **argv);
 };
 
 #endif
@@ -89,6 +90,7 @@ private:
 	bool Cmd_Combos(int argc, const char **argv);
 	bool Cmd_SliderState(int argc, const char **argv);
 	bool Cmd_QuickTest(int argc, const char **argv);
+	bool Cmd_WalkCards(int argc, const char **argv);
 };
 
 #endif
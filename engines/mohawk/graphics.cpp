@@ -75,28 +75,22 @@ GraphicsManager::~GraphicsManager() {
 }
 
 void GraphicsManager::clearCache() {
-	for (Common::HashMap<uint16, MohawkSurface *>::iterator it = _cache.begin(); it != _cache.end(); it++)
-		delete it->_value;
+	_cache.clear();
+
 	for (Common::HashMap<uint16, Common::Array<MohawkSurface *> >::iterator it = _subImageCache.begin(); it != _subImageCache.end(); it++) {
 		Common::Array<MohawkSurface *> &array = it->_value;
 		for (uint i = 0; i < array.size(); i++)
 			delete array[i];
 	}
 
-	_cache.clear();
 	_subImageCache.clear();
 }
 
 MohawkSurface *GraphicsManager::findImage(uint16 id) {
 	if (!_cache.contains(id))
-		_cache[id] = decodeImage(id);
-
-	// TODO: Probably would be nice to limit the size of the cache
-	// Currently, this can't get large because it is freed on every
-	// card/stack change in Myst/Riven so I'm not worried about it.
-	// Doesn't mean this shouldn't be done in the future.
+		_cache.add(id, decodeImage(id));
 
-	return _cache[id];
+	return _cache.search(id);
 }
 
 Common::Array<MohawkSurface *> GraphicsManager::decodeImages(uint16 id) {
@@ -226,7 +220,8 @@ void GraphicsManager::addImageToCache(uint16 id, MohawkSurface *surface) {
 	if (_cache.contains(id))
 		error("Image %d already in cache", id);
 
-	_cache[id] = surface;
+	// Images added by the engine can't be decoded again, so keep them
+	_cache.add(id, surface, true);
 }
 
 } // End of namespace Mohawk
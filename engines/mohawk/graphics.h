@@ -23,6 +23,7 @@
 #define MOHAWK_GRAPHICS_H
 
 #include "mohawk/bitmap.h"
+#include "mohawk/resource_cache.h"
 
 #include "common/hashmap.h"
 #include "common/rect.h"
@@ -75,8 +76,12 @@ public:
 
 	// findImage will search the cache to find the image.
 	// If not found, it will call decodeImage to get a new one.
+	// The image stays valid until the next image is added to the cache.
 	MohawkSurface *findImage(uint16 id);
 
+	// Is the image already decoded?
+	bool isImageCached(uint16 id) const { return _cache.contains(id); }
+
 	void preloadImage(uint16 image);
 	virtual void setPalette(uint16 id);
 	void copyAnimImageToScreen(uint16 image, int left = 0, int top = 0);
@@ -95,9 +100,13 @@ protected:
 	virtual MohawkEngine *getVM() = 0;
 	void addImageToCache(uint16 id, MohawkSurface *surface);
 
+	// Limit the memory used by the decoded images, 0 means unlimited
+	void setCacheBudget(uint32 budget) { _cache.setBudget(budget); }
+
 private:
-	// An image cache that stores images until clearCache() is called
-	Common::HashMap<uint16, MohawkSurface *> _cache;
+	// An image cache that stores images until clearCache() is called,
+	// or until the memory budget is exceeded
+	SurfaceCache _cache;
 	Common::HashMap<uint16, Common::Array<MohawkSurface *> > _subImageCache;
 };
 
@@ -16,6 +16,7 @@ MODULE_OBJS = \
 	myst_metaengine.o \
 	mohawk.o \
 	resource.o \
+	resource_cache.o \
 	sound.o \
 	video.o \
 	view.o
@@ -39,7 +40,6 @@ MODULE_OBJS += \
 	myst_scripts.o \
 	myst_sound.o \
 	myst_state.o \
-	resource_cache.o \
 	myst_stacks/channelwood.o \
 	myst_stacks/credits.o \
 	myst_stacks/demo.o \
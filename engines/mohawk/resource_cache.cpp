@@ -20,6 +20,8 @@
  */
 
 #include "common/debug.h"
+#include "graphics/surface.h"
+#include "mohawk/graphics.h"
 #include "mohawk/myst.h"
 #include "mohawk/resource_cache.h"
 
@@ -81,4 +83,86 @@ Common::SeekableReadStream *ResourceCache::search(uint32 tag, uint16 id) {
 	return nullptr;
 }
 
+SurfaceCache::SurfaceCache() : _budget(0), _size(0), _useCounter(0) {
+}
+
+SurfaceCache::~SurfaceCache() {
+	clear();
+}
+
+void SurfaceCache::setBudget(uint32 budget) {
+	_budget = budget;
+	evict(0xFFFF);
+}
+
+void SurfaceCache::clear() {
+	for (EntryMap::iterator it = _store.begin(); it != _store.end(); it++)
+		delete it->_value.surface;
+
+	_store.clear();
+	_size = 0;
+}
+
+void SurfaceCache::add(uint16 id, MohawkSurface *surface, bool locked) {
+	EntryMap::iterator it = _store.find(id);
+	if (it != _store.end()) {
+		_size -= it->_value.size;
+		delete it->_value.surface;
+	}
+
+	Entry &entry = _store[id];
+	entry.surface = surface;
+	entry.size = 0;
+	entry.lastUse = ++_useCounter;
+	entry.locked = locked;
+
+	if (surface && surface->getSurface()) {
+		Graphics::Surface *pixels = surface->getSurface();
+		entry.size = pixels->pitch * pixels->h + (surface->getPalette() ? 256 * 3 : 0);
+	}
+
+	_size += entry.size;
+
+	evict(id);
+}
+
+bool SurfaceCache::contains(uint16 id) const {
+	return _store.contains(id);
+}
+
+MohawkSurface *SurfaceCache::search(uint16 id) {
+	EntryMap::iterator it = _store.find(id);
+	if (it == _store.end())
+		return nullptr;
+
+	it->_value.lastUse = ++_useCounter;
+	return it->_value.surface;
+}
+
+void SurfaceCache::evict(uint16 keepId) {
+	if (_budget == 0)
+		return;
+
+	while (_size > _budget) {
+		// Find the least recently used image that can be freed
+		EntryMap::iterator oldest = _store.end();
+		for (EntryMap::iterator it = _store.begin(); it != _store.end(); it++) {
+			if (it->_value.locked || it->_key == keepId)
+				continue;
+
+			if (oldest == _store.end() || it->_value.lastUse < oldest->_value.lastUse)
+				oldest = it;
+		}
+
+		if (oldest == _store.end())
+			break;
+
+		debugC(kDebugCache, "Freeing cached image %d", oldest->_key);
+
+		_size -= oldest->_value.size;
+		delete oldest->_value.surface;
+		_store.erase(oldest);
+	}
+}
+
 } // End of namespace Mohawk
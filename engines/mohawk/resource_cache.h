@@ -23,10 +23,13 @@
 #define RESOURCE_CACHE_H
 
 #include "common/array.h"
+#include "common/hashmap.h"
 #include "common/stream.h"
 
 namespace Mohawk {
 
+class MohawkSurface;
+
 class ResourceCache {
 public:
 	ResourceCache();
@@ -50,6 +53,55 @@ private:
 	Common::Array<DataObject> _store;
 };
 
+/**
+ * A cache of decoded images
+ *
+ * When a memory budget is set, the least recently used images are
+ * freed once the decoded images use more memory than the budget.
+ * Locked images are never freed before the cache is cleared.
+ */
+class SurfaceCache {
+public:
+	SurfaceCache();
+	~SurfaceCache();
+
+	/** Set the memory budget in bytes, 0 means unlimited */
+	void setBudget(uint32 budget);
+	uint32 getBudget() const { return _budget; }
+
+	/** Free all the images */
+	void clear();
+
+	/** Add an image, the cache takes ownership of it */
+	void add(uint16 id, MohawkSurface *surface, bool locked = false);
+
+	/** Is the image in the cache? Does not update the usage information */
+	bool contains(uint16 id) const;
+
+	/** Returns NULL if not found */
+	MohawkSurface *search(uint16 id);
+
+	uint32 getSize() const { return _size; }
+	uint32 getCount() const { return _store.size(); }
+
+private:
+	struct Entry {
+		MohawkSurface *surface;
+		uint32 size;
+		uint32 lastUse;
+		bool locked;
+	};
+
+	typedef Common::HashMap<uint16, Entry> EntryMap;
+
+	void evict(uint16 keepId);
+
+	EntryMap _store;
+	uint32 _budget;
+	uint32 _size;
+	uint32 _useCounter;
+};
+
 } // End of namespace Mohawk
 
 #endif
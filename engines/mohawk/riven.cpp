@@ -229,11 +229,22 @@ void MohawkEngine_Riven::doFrame() {
 	_system->updateScreen();
 	uint32 loopElapsed = _system->getMillis() - loopStart;
 
-	// Cut down on CPU usage
-	if (loopElapsed < 10)
+	// Use the spare time to decode the images of the cards the player may go to next,
+	// otherwise cut down on CPU usage
+	if (loopElapsed < 10 && (_scriptMan->hasQueuedScripts() || !_gfx->prefetchNext()))
 		_system->delayMillis(10 - loopElapsed);
 }
 
+void MohawkEngine_Riven::prefetchAdjacentCards() {
+	Common::Array<uint16> cardIds = _card->getAdjacentCards();
+
+	for (uint i = 0; i < cardIds.size(); i++) {
+		uint16 imageId;
+		if (RivenCard::getCardDefaultImage(this, cardIds[i], imageId))
+			_gfx->queuePrefetch(imageId);
+	}
+}
+
 void MohawkEngine_Riven::processInput() {
 	Common::Event event;
 	while (_eventMan->pollEvent(event)) {
@@ -390,6 +401,7 @@ void MohawkEngine_Riven::changeToStack(uint16 stackId) {
 
 	// Clear the graphics cache; images aren't used across stack boundaries
 	_gfx->clearCache();
+	_gfx->clearPrefetchQueue();
 
 	// Clear the old stack files out
 	closeAllArchives();
@@ -613,9 +625,10 @@ static const RivenSpecialChange rivenSpecialChange[] = {
 void MohawkEngine_Riven::changeToCard(uint16 dest) {
 	debug (1, "Changing to card %d", dest);
 
-	// Clear the graphics cache (images typically aren't used
-	// on different cards).
-	_gfx->clearCache();
+	// The graphics cache is kept, it only holds images from the current stack
+	// and frees the least recently used ones by itself. Images prefetched
+	// for the other neighbors of the previous card are no longer needed though.
+	_gfx->clearPrefetchQueue();
 
 	if (!isGameVariant(GF_DEMO)) {
 		for (byte i = 0; i < ARRAYSIZE(rivenSpecialChange); i++)
@@ -636,6 +649,8 @@ void MohawkEngine_Riven::changeToCard(uint16 dest) {
 	_card = new RivenCard(this, dest);
 	_card->enter(true);
 
+	prefetchAdjacentCards();
+
 	// Now we need to redraw the cursor if necessary and handle mouse over scripts
 	_stack->queueMouseCursorRefresh();
 
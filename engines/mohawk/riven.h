@@ -159,6 +159,8 @@ public:
 	void changeToCard(uint16 dest);
 	void changeToStack(uint16 stackId);
 	void reloadCurrentCard();
+	/** Queue the default images of the cards reachable from the current card for decoding */
+	void prefetchAdjacentCards();
 	RivenCard *getCard() const { return _card; }
 	RivenStack *getStack() const { return _stack; }
 
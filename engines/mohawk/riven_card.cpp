@@ -30,6 +30,7 @@
 #include "mohawk/resource.h"
 #include "mohawk/riven.h"
 
+#include "common/algorithm.h"
 #include "common/memstream.h"
 
 namespace Mohawk {
@@ -722,6 +723,52 @@ void RivenCard::drawPicture(uint16 index, bool queue) {
 	}
 }
 
+Common::Array<uint16> RivenCard::getAdjacentCards() const {
+	Common::Array<uint16> cardIds;
+
+	for (uint16 i = 0; i < _scripts.size(); i++)
+		_scripts[i].script->findCardChanges(cardIds);
+
+	for (uint16 i = 0; i < _hotspots.size(); i++)
+		_hotspots[i]->findCardChanges(cardIds);
+
+	// Remove the duplicates and the card itself
+	Common::Array<uint16> adjacent;
+	for (uint16 i = 0; i < cardIds.size(); i++) {
+		if (cardIds[i] != _id && Common::find(adjacent.begin(), adjacent.end(), cardIds[i]) == adjacent.end())
+			adjacent.push_back(cardIds[i]);
+	}
+
+	return adjacent;
+}
+
+bool RivenCard::getCardDefaultImage(MohawkEngine_Riven *vm, uint16 cardId, uint16 &imageId) {
+	if (!vm->hasResource(ID_PLST, cardId))
+		return false;
+
+	Common::SeekableReadStream *plst = vm->getResource(ID_PLST, cardId);
+	uint16 recordCount = plst->readUint16BE();
+
+	// The load script draws the picture with index 1, which usually comes first
+	bool found = false;
+	for (uint16 i = 0; i < recordCount; i++) {
+		uint16 index = plst->readUint16BE();
+		uint16 id = plst->readUint16BE();
+		plst->skip(8); // rect
+
+		if (i == 0 || index == 1) {
+			imageId = id;
+			found = true;
+		}
+
+		if (index == 1)
+			break;
+	}
+
+	delete plst;
+	return found;
+}
+
 RivenCard::Picture RivenCard::getPicture(uint16 index) const {
 	for (uint16 i = 0; i < _pictureList.size(); i++) {
 		if (_pictureList[i].index == index) {
@@ -1339,6 +1386,12 @@ void RivenHotspot::applyScriptPatches(uint32 cardGlobalId) {
 	}
 }
 
+void RivenHotspot::findCardChanges(Common::Array<uint16> &cardIds) const {
+	for (uint16 i = 0; i < _scripts.size(); i++) {
+		_scripts[i].script->findCardChanges(cardIds);
+	}
+}
+
 bool RivenHotspot::isEnabled() const {
 	return (_flags & kFlagEnabled) != 0;
 }
@@ -142,6 +142,12 @@ public:
 	/** Write all of the card's data to standard output */
 	void dump() const;
 
+	/** Get the ids of the cards the card and its hotspots' scripts can switch to */
+	Common::Array<uint16> getAdjacentCards() const;
+
+	/** Get the id of the image drawn by default when entering a card */
+	static bool getCardDefaultImage(MohawkEngine_Riven *vm, uint16 cardId, uint16 &imageId);
+
 private:
 	void loadCardResource(uint16 id);
 	void loadHotspots(uint16 id);
@@ -273,6 +279,9 @@ public:
 	/** Apply patches to the hotspot's scripts to fix bugs in the original game scripts */
 	void applyScriptPatches(uint32 cardGlobalId);
 
+	/** Add the ids of the cards the hotspot's scripts can switch to */
+	void findCardChanges(Common::Array<uint16> &cardIds) const;
+
 	/** Apply patches to the hotspot's properties to fix bugs in the original game scripts */
 	void applyPropertiesPatches(uint32 cardGlobalId);
 
@@ -32,6 +32,7 @@
 
 #include "engines/util.h"
 
+#include "graphics/blit.h"
 #include "graphics/fontman.h"
 #include "graphics/font.h"
 #include "graphics/fonts/ttf.h"
@@ -279,27 +280,12 @@ public:
 		} else {
 			Graphics::Surface *screen = _system->lockScreen();
 
+			assert(_mainScreen->format == _effectScreen->format && _mainScreen->format == screen->format);
+
 			uint alpha = elapsed * 255 / _duration;
-			for (int y = 0; y < _mainScreen->h; y++) {
-				uint16 *src1 = (uint16 *) _mainScreen->getBasePtr(0, y);
-				uint16 *src2 = (uint16 *) _effectScreen->getBasePtr(0, y);
-				uint16 *dst = (uint16 *) screen->getBasePtr(0, y);
-				for (int x = 0; x < _mainScreen->w; x++) {
-					uint8 r1, g1, b1, r2, g2, b2;
-					_mainScreen->format.colorToRGB(*src1++, r1, g1, b1);
-					_effectScreen->format.colorToRGB(*src2++, r2, g2, b2);
-
-					uint r = r1 * alpha + r2 * (255 - alpha);
-					uint g = g1 * alpha + g2 * (255 - alpha);
-					uint b = b1 * alpha + b2 * (255 - alpha);
-
-					r /= 255;
-					g /= 255;
-					b /= 255;
-
-					*dst++ = (uint16) screen->format.RGBToColor(r, g, b);
-				}
-			}
+			Graphics::CrossFade::blend((byte *)screen->getPixels(), (const byte *)_mainScreen->getPixels(), (const byte *)_effectScreen->getPixels(),
+			                           screen->pitch, _mainScreen->pitch, _effectScreen->pitch,
+			                           _mainScreen->w, _mainScreen->h, alpha, screen->format);
 
 			_system->unlockScreen();
 			return false;
@@ -323,9 +309,14 @@ RivenGraphics::RivenGraphics(MohawkEngine_Riven* vm) :
 		_fliesEffect(nullptr),
 		_menuFont(nullptr),
 		_transitionFrames(0),
-		_transitionDuration(0) {
+		_transitionDuration(0),
+		_decodeTime(0) {
 	_bitmapDecoder = new MohawkBitmap();
 
+	// Images are kept when changing cards, so that the ones shared between
+	// cards and the prefetched ones don't need to be decoded again
+	setCacheBudget(16 * 1024 * 1024);
+
 	// Restrict ourselves to a single pixel format to simplify the effects implementation
 	_pixelFormat = Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
 	initGraphics(608, 436, &_pixelFormat);
@@ -355,26 +346,63 @@ RivenGraphics::~RivenGraphics() {
 }
 
 MohawkSurface *RivenGraphics::decodeImage(uint16 id) {
+	uint32 startTime = _vm->_system->getMillis();
+
 	Common::SeekableReadStream *resourceStream = _vm->getResource(ID_TBMP, id);
 	Common::SeekableReadStream *memResourceStream = resourceStream->readStream(resourceStream->size());
 	delete resourceStream;
 
 	MohawkSurface *surface = _bitmapDecoder->decodeImage(memResourceStream);
 	surface->convertToTrueColor();
+
+	_decodeTime += _vm->_system->getMillis() - startTime;
+
 	return surface;
 }
 
+void RivenGraphics::queuePrefetch(uint16 image) {
+	if (isImageCached(image))
+		return;
+
+	for (uint i = 0; i < _prefetchQueue.size(); i++)
+		if (_prefetchQueue[i] == image)
+			return;
+
+	_prefetchQueue.push_back(image);
+}
+
+void RivenGraphics::clearPrefetchQueue() {
+	_prefetchQueue.clear();
+}
+
+bool RivenGraphics::prefetchNext() {
+	while (!_prefetchQueue.empty()) {
+		uint16 image = _prefetchQueue.front();
+		_prefetchQueue.remove_at(0);
+
+		if (!isImageCached(image)) {
+			debug(2, "Prefetching image %d", image);
+			findImage(image);
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void RivenGraphics::copyImageToScreen(uint16 image, uint32 left, uint32 top, uint32 right, uint32 bottom) {
 	Graphics::Surface *surface = findImage(image)->getSurface();
 
 	beginScreenUpdate();
 
 	// Clip the width to fit on the screen. Fixes some images.
-	if (left + surface->w > 608)
-		surface->w = 608 - left;
+	// The cached image itself must not be modified, it may be drawn elsewhere later.
+	uint16 width = surface->w;
+	if (left + width > 608)
+		width = 608 - left;
 
 	for (uint16 i = 0; i < surface->h; i++)
-		memcpy(_mainScreen->getBasePtr(left, i + top), surface->getBasePtr(0, i), surface->w * surface->format.bytesPerPixel);
+		memcpy(_mainScreen->getBasePtr(left, i + top), surface->getBasePtr(0, i), width * surface->format.bytesPerPixel);
 
 	_dirtyScreen = true;
 	applyScreenUpdate();
@@ -435,11 +463,14 @@ WaterEffect::WaterEffect(MohawkEngine_Riven *vm, uint16 sfxeID) :
 	for (uint16 i = 0; i < frameCount; i++)
 		frameOffsets[i] = sfxeStream->readUint32BE();
 
-	// Read in the scripts
+	// Read in the scripts, they are decoded once here rather than on every frame
 	sfxeStream->seek(frameOffsets[0]);
+	_frames.resize(frameCount);
 	for (uint16 i = 0; i < frameCount; i++) {
 		uint scriptLength = (i == frameCount - 1) ? sfxeStream->size() - frameOffsets[i] : frameOffsets[i + 1] - frameOffsets[i];
-		_frameScripts.push_back(sfxeStream->readStream(scriptLength));
+		Common::SeekableReadStream *script = sfxeStream->readStream(scriptLength);
+		parseFrameScript(script, _frames[i]);
+		delete script;
 	}
 
 	// Set it to the first frame
@@ -454,48 +485,46 @@ void WaterEffect::update() {
 		return; // Nothing to do yet
 	}
 
-	// Make sure the script is at the starting point
-	Common::SeekableReadStream *script = _frameScripts[_curFrame];
-	script->seek(0);
-
 	Graphics::Surface *screen = _vm->_system->lockScreen();
 	Graphics::Surface *mainScreen = _vm->_gfx->getBackScreen();
 	assert(screen->format == mainScreen->format);
 
-	// Run script
-	uint16 curRow = 0;
-	for (uint16 op = script->readUint16BE(); op != 4; op = script->readUint16BE()) {
-		if (op == 1) {        // Increment Row
-			curRow++;
-		} else if (op == 3) { // Copy Pixels
-			uint16 dstLeft = script->readUint16BE();
-			uint16 srcLeft = script->readUint16BE();
-			uint16 srcTop = script->readUint16BE();
-			uint16 rowWidth = script->readUint16BE();
-
-			byte *src = (byte *)mainScreen->getBasePtr(srcLeft, srcTop);
-			byte *dst = (byte *)screen->getBasePtr(dstLeft, curRow + _rect.top);
+	const FrameOps &ops = _frames[_curFrame];
+	for (uint i = 0; i < ops.size(); i++) {
+		const CopyOp &op = ops[i];
+		const byte *src = (const byte *)mainScreen->getBasePtr(op.srcLeft, op.srcTop);
+		byte *dst = (byte *)screen->getBasePtr(op.dstLeft, op.dstTop);
 
-			memcpy(dst, src, rowWidth * screen->format.bytesPerPixel);
-		} else if (op != 4) { // End of Script
-			error ("Unknown SFXE opcode %d", op);
-		}
+		memcpy(dst, src, op.width * screen->format.bytesPerPixel);
 	}
 
 	_vm->_system->unlockScreen();
 
 	// Increment frame
 	_curFrame++;
-	if (_curFrame == _frameScripts.size())
+	if (_curFrame == _frames.size())
 		_curFrame = 0;
 
 	// Set the new time
 	_lastFrameTime = _vm->_system->getMillis();
 }
 
-WaterEffect::~WaterEffect() {
-	for (uint i = 0; i < _frameScripts.size(); i++) {
-		delete _frameScripts[i];
+void WaterEffect::parseFrameScript(Common::SeekableReadStream *script, FrameOps &ops) const {
+	uint16 curRow = 0;
+	for (uint16 op = script->readUint16BE(); op != 4; op = script->readUint16BE()) {
+		if (op == 1) {        // Increment Row
+			curRow++;
+		} else if (op == 3) { // Copy Pixels
+			CopyOp copy;
+			copy.dstLeft = script->readUint16BE();
+			copy.dstTop = curRow + _rect.top;
+			copy.srcLeft = script->readUint16BE();
+			copy.srcTop = script->readUint16BE();
+			copy.width = script->readUint16BE();
+			ops.push_back(copy);
+		} else if (op != 4) { // End of Script
+			error ("Unknown SFXE opcode %d", op);
+		}
 	}
 }
 
@@ -107,6 +107,17 @@ public:
 	void updateCredits();
 	uint getCurCreditsImage() const { return _creditsImage; }
 
+	// Prefetching
+	/** Queue an image to be decoded before it is needed */
+	void queuePrefetch(uint16 image);
+	void clearPrefetchQueue();
+	bool hasPrefetchQueued() const { return !_prefetchQueue.empty(); }
+	/** Decode the next queued image, returns false if there was nothing to decode */
+	bool prefetchNext();
+
+	/** Total time spent decoding images, in milliseconds */
+	uint32 getDecodeTime() const { return _decodeTime; }
+
 protected:
 	MohawkSurface *decodeImage(uint16 id) override;
 	MohawkEngine *getVM() override { return (MohawkEngine *)_vm; }
@@ -145,6 +156,10 @@ private:
 
 	// Credits
 	uint _creditsImage, _creditsPos;
+
+	// Prefetching
+	Common::Array<uint16> _prefetchQueue;
+	uint32 _decodeTime;
 };
 
 /**
@@ -153,17 +168,29 @@ private:
 class WaterEffect {
 public:
 	WaterEffect(MohawkEngine_Riven *vm, uint16 sfxeID);
-	~WaterEffect();
 
 	void update();
 
 private:
 	MohawkEngine_Riven *_vm;
 
+	/** A pixel row copy, decoded from the SFXE frame scripts */
+	struct CopyOp {
+		uint16 dstLeft;
+		uint16 dstTop;
+		uint16 srcLeft;
+		uint16 srcTop;
+		uint16 width;
+	};
+
+	typedef Common::Array<CopyOp> FrameOps;
+
+	void parseFrameScript(Common::SeekableReadStream *script, FrameOps &ops) const;
+
 	// Record values
 	Common::Rect _rect;
 	uint16 _speed;
-	Common::Array<Common::SeekableReadStream *> _frameScripts;
+	Common::Array<FrameOps> _frames;
 
 	// Cur frame
 	uint16 _curFrame;
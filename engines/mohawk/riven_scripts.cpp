@@ -217,6 +217,12 @@ void RivenScript::dumpScript(byte tabs) {
 	}
 }
 
+void RivenScript::findCardChanges(Common::Array<uint16> &cardIds) const {
+	for (uint16 i = 0; i < _commands.size(); i++) {
+		_commands[i]->findCardChanges(cardIds);
+	}
+}
+
 void RivenScript::run(RivenScriptManager *scriptManager) {
 	for (uint i = 0; i < _commands.size(); i++) {
 		if (scriptManager->stoppingAllScripts()) {
@@ -830,6 +836,11 @@ RivenCommandType RivenSimpleCommand::getType() const {
 	return _type;
 }
 
+void RivenSimpleCommand::findCardChanges(Common::Array<uint16> &cardIds) const {
+	if (_type == kRivenCommandChangeCard && !_arguments.empty())
+		cardIds.push_back(_arguments[0]);
+}
+
 RivenSwitchCommand::RivenSwitchCommand(MohawkEngine_Riven *vm) :
 		RivenCommand(vm),
 		_variableId(0) {
@@ -917,6 +928,12 @@ void RivenSwitchCommand::applyCardPatches(uint32 globalId, int scriptType, uint1
 	}
 }
 
+void RivenSwitchCommand::findCardChanges(Common::Array<uint16> &cardIds) const {
+	for (uint i = 0; i < _branches.size(); i++) {
+		_branches[i].script->findCardChanges(cardIds);
+	}
+}
+
 RivenStackChangeCommand::RivenStackChangeCommand(MohawkEngine_Riven *vm, uint16 stackId, uint32 globalCardId,
 												 bool byStackId, bool byStackCardId) :
 		RivenCommand(vm),
@@ -33,6 +33,9 @@
 namespace Neverhood {
 
 Console::Console(NeverhoodEngine *vm) : GUI::Debugger(), _vm(vm) {
+#ifndef RELEASE_BUILD
+	registerCmd("benchscreen",	WRAP_METHOD(Console, Cmd_BenchScreen));
+#endif
 	registerCmd("cheat",			WRAP_METHOD(Console, Cmd_Cheat));
 	registerCmd("checkresource",	WRAP_METHOD(Console, Cmd_CheckResource));
 	registerCmd("dumpresource",	WRAP_METHOD(Console, Cmd_DumpResource));
@@ -45,6 +48,22 @@ Console::Console(NeverhoodEngine *vm) : GUI::Debugger(), _vm(vm) {
 Console::~Console() {
 }
 
+#ifndef RELEASE_BUILD
+bool Console::Cmd_BenchScreen(int argc, const char **argv) {
+	uint frames = argc > 1 ? atoi(argv[1]) : 500;
+	if (frames == 0) {
+		debugPrintf("Usage: %s [<frames>]\n", argv[0]);
+		return true;
+	}
+
+	uint32 time, referenceTime;
+	bool identical = _vm->_screen->benchmarkUpdate(frames, time, referenceTime);
+	debugPrintf("%d frames: %d ms, original update %d ms, output %s\n", frames, time, referenceTime,
+		identical ? "identical" : "DIFFERENT");
+	return true;
+}
+#endif
+
 bool Console::Cmd_Scene(int argc, const char **argv) {
 	if (argc != 3) {
 		int currentModule = _vm->_gameModule->getCurrentModuleNum();
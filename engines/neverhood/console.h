@@ -36,6 +36,9 @@ public:
 private:
 	NeverhoodEngine *_vm;
 
+#ifndef RELEASE_BUILD
+	bool Cmd_BenchScreen(int argc, const char **argv);
+#endif
 	bool Cmd_Scene(int argc, const char **argv);
 	bool Cmd_Surfaces(int argc, const char **argv);
 	bool Cmd_Cheat(int argc, const char **argv);
@@ -19,6 +19,7 @@
  *
  */
 
+#include "common/algorithm.h"
 #include "graphics/paletteman.h"
 #include "video/smk_decoder.h"
 #include "neverhood/screen.h"
@@ -28,7 +29,7 @@ namespace Neverhood {
 Screen::Screen(NeverhoodEngine *vm)
 	: _vm(vm), _paletteData(nullptr), _paletteChanged(false), _smackerDecoder(nullptr),
 	_yOffset(0), _fullRefresh(false), _frameDelay(0), _savedSmackerDecoder(nullptr),
-	_savedFrameDelay(0), _savedYOffset(0) {
+	_savedFrameDelay(0), _savedYOffset(0), _itemStamp(0) {
 
 	_ticks = _vm->_system->getMillis();
 
@@ -60,6 +61,57 @@ void Screen::update() {
 		return;
 	}
 
+	RectangleList *updateRects = composeRenderQueue();
+
+	SWAP(_renderQueue, _prevRenderQueue);
+	_renderQueue->clear();
+
+	for (RectangleList::iterator ri = updateRects->begin(); ri != updateRects->end(); ++ri) {
+		Common::Rect &r = *ri;
+		_vm->_system->copyRectToScreen((const byte*)_backScreen->getBasePtr(r.left, r.top), _backScreen->pitch, r.left, r.top, r.width(), r.height());
+	}
+
+	delete updateRects;
+
+}
+
+RectangleList *Screen::composeRenderQueue() {
+	_microTiles->clear();
+
+	// Items which are drawn the same way as in the previous frame don't need a refresh
+	_prevRenderItems.clear();
+	for (RenderQueue::iterator jt = _prevRenderQueue->begin(); jt != _prevRenderQueue->end(); ++jt)
+		_prevRenderItems[*jt] = false;
+
+	for (RenderQueue::iterator it = _renderQueue->begin(); it != _renderQueue->end(); ++it) {
+		RenderItem &renderItem = (*it);
+		RenderItemMap::iterator found = _prevRenderItems.find(renderItem);
+		renderItem._refresh = found == _prevRenderItems.end();
+		if (!renderItem._refresh)
+			found->_value = true;
+	}
+
+	for (RenderQueue::iterator jt = _prevRenderQueue->begin(); jt != _prevRenderQueue->end(); ++jt) {
+		RenderItem &prevRenderItem = (*jt);
+		if (!_prevRenderItems[prevRenderItem])
+			_microTiles->addRect(Common::Rect(prevRenderItem._destX, prevRenderItem._destY, prevRenderItem._destX + prevRenderItem._width, prevRenderItem._destY + prevRenderItem._height));
+	}
+
+	for (RenderQueue::iterator it = _renderQueue->begin(); it != _renderQueue->end(); ++it) {
+		RenderItem &renderItem = (*it);
+		if (renderItem._refresh)
+			_microTiles->addRect(Common::Rect(renderItem._destX, renderItem._destY, renderItem._destX + renderItem._width, renderItem._destY + renderItem._height));
+		renderItem._refresh = true;
+	}
+
+	RectangleList *updateRects = _microTiles->getRectangles();
+	blitRenderQueue(*updateRects);
+	return updateRects;
+}
+
+#ifndef RELEASE_BUILD
+// The original implementation, kept to verify the one above
+RectangleList *Screen::composeRenderQueueReference() {
 	_microTiles->clear();
 
 	for (RenderQueue::iterator it = _renderQueue->begin(); it != _renderQueue->end(); ++it) {
@@ -95,17 +147,116 @@ void Screen::update() {
 			blitRenderItem(renderItem, *ri);
 	}
 
-	SWAP(_renderQueue, _prevRenderQueue);
-	_renderQueue->clear();
+	return updateRects;
+}
+#endif
 
-	for (RectangleList::iterator ri = updateRects->begin(); ri != updateRects->end(); ++ri) {
-		Common::Rect &r = *ri;
-		_vm->_system->copyRectToScreen((const byte*)_backScreen->getBasePtr(r.left, r.top), _backScreen->pitch, r.left, r.top, r.width(), r.height());
+void Screen::blitRenderQueue(const RectangleList &updateRects) {
+	if (updateRects.empty())
+		return;
+
+	// Sort the items into the grid cells they overlap
+	for (uint i = 0; i < ARRAYSIZE(_gridCells); i++)
+		_gridCells[i].clear();
+
+	for (uint i = 0; i < _renderQueue->size(); i++) {
+		const RenderItem &renderItem = (*_renderQueue)[i];
+		const int x0 = CLIP<int>(renderItem._destX, 0, 639) / kGridCellSize;
+		const int y0 = CLIP<int>(renderItem._destY, 0, 479) / kGridCellSize;
+		const int x1 = CLIP<int>(renderItem._destX + renderItem._width - 1, 0, 639) / kGridCellSize;
+		const int y1 = CLIP<int>(renderItem._destY + renderItem._height - 1, 0, 479) / kGridCellSize;
+		for (int y = y0; y <= y1; y++)
+			for (int x = x0; x <= x1; x++)
+				_gridCells[y * kGridWidth + x].push_back(i);
 	}
 
-	delete updateRects;
+	if (_itemStamps.size() < _renderQueue->size())
+		_itemStamps.resize(_renderQueue->size(), _itemStamp);
+
+	// The update rectangles don't overlap, so each one can be drawn on its own,
+	// with the items overlapping it blitted in queue order
+	for (RectangleList::const_iterator ri = updateRects.begin(); ri != updateRects.end(); ++ri) {
+		const Common::Rect &r = *ri;
+		const int x0 = CLIP<int>(r.left, 0, 639) / kGridCellSize;
+		const int y0 = CLIP<int>(r.top, 0, 479) / kGridCellSize;
+		const int x1 = CLIP<int>(r.right - 1, 0, 639) / kGridCellSize;
+		const int y1 = CLIP<int>(r.bottom - 1, 0, 479) / kGridCellSize;
+
+		++_itemStamp;
+		_rectItems.clear();
+		for (int y = y0; y <= y1; y++) {
+			for (int x = x0; x <= x1; x++) {
+				const Common::Array<uint> &cell = _gridCells[y * kGridWidth + x];
+				for (uint i = 0; i < cell.size(); i++) {
+					if (_itemStamps[cell[i]] != _itemStamp) {
+						_itemStamps[cell[i]] = _itemStamp;
+						_rectItems.push_back(cell[i]);
+					}
+				}
+			}
+		}
+
+		if (x0 != x1 || y0 != y1)
+			Common::sort(_rectItems.begin(), _rectItems.end());
+
+		for (uint i = 0; i < _rectItems.size(); i++)
+			blitRenderItem((*_renderQueue)[_rectItems[i]], r);
+	}
+}
+
+#ifndef RELEASE_BUILD
+bool Screen::benchmarkUpdate(uint frames, uint32 &time, uint32 &referenceTime) {
+	// Replay the items of the last frame, some of them moving around, through
+	// both implementations and compare the resulting back screens
+	const RenderQueue baseQueue = *_prevRenderQueue;
+	const RenderQueue pendingQueue = *_renderQueue;
+	if (baseQueue.empty())
+		return true;
+
+	Graphics::Surface savedScreen, referenceScreen;
+	savedScreen.copyFrom(*_backScreen);
+	bool identical = true;
+	time = referenceTime = 0;
+
+	for (int pass = 0; pass < 2; pass++) {
+		const bool reference = pass == 0;
+		_backScreen->copyRectToSurface(savedScreen, 0, 0, Common::Rect(640, 480));
+		*_prevRenderQueue = baseQueue;
+
+		for (uint frame = 0; frame < frames; frame++) {
+			_renderQueue->clear();
+			for (uint i = 0; i < baseQueue.size(); i++) {
+				RenderItem renderItem = baseQueue[i];
+				if (i % 8 == frame % 8) {
+					renderItem._destX = CLIP<int>(renderItem._destX + (int)(frame % 16) - 8, 0, 640 - renderItem._width);
+					renderItem._destY = CLIP<int>(renderItem._destY + (int)(frame % 8) - 4, 0, 480 - renderItem._height);
+				}
+				_renderQueue->push_back(renderItem);
+			}
+
+			const uint32 start = _vm->_system->getMillis();
+			RectangleList *updateRects = reference ? composeRenderQueueReference() : composeRenderQueue();
+			(reference ? referenceTime : time) += _vm->_system->getMillis() - start;
+			delete updateRects;
+
+			SWAP(_renderQueue, _prevRenderQueue);
+		}
+
+		if (reference)
+			referenceScreen.copyFrom(*_backScreen);
+		else
+			identical = memcmp(referenceScreen.getPixels(), _backScreen->getPixels(), _backScreen->pitch * _backScreen->h) == 0;
+	}
 
+	// Leave the screen as it was
+	_backScreen->copyRectToSurface(savedScreen, 0, 0, Common::Rect(640, 480));
+	*_prevRenderQueue = baseQueue;
+	*_renderQueue = pendingQueue;
+	savedScreen.free();
+	referenceScreen.free();
+	return identical;
 }
+#endif
 
 uint32 Screen::getNextFrameTime() {
 	int32 frameDelay = _frameDelay;
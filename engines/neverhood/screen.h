@@ -23,6 +23,7 @@
 #define NEVERHOOD_SCREEN_H
 
 #include "common/array.h"
+#include "common/hashmap.h"
 #include "graphics/surface.h"
 #include "neverhood/neverhood.h"
 #include "neverhood/microtiles.h"
@@ -59,7 +60,18 @@ struct RenderItem {
 	}
 };
 
+struct RenderItemHash {
+	uint operator()(const RenderItem &item) const {
+		uint hash = (uint)(uintptr)item._surface ^ ((uint)(uintptr)item._shadowSurface * 31);
+		hash = hash * 31 + (uint16)item._destX + ((uint16)item._destY << 16);
+		hash = hash * 31 + (uint16)item._srcX + ((uint16)item._srcY << 16);
+		hash = hash * 31 + (uint16)item._width + ((uint16)item._height << 16);
+		return hash * 31 + item._transparent + (item._version << 1) + (item._alphaColor << 9);
+	}
+};
+
 typedef Common::Array<RenderItem> RenderQueue;
+typedef Common::HashMap<RenderItem, bool, RenderItemHash> RenderItemMap;
 
 class Screen {
 public:
@@ -91,7 +103,16 @@ public:
 	void queueBlit(const Graphics::Surface *surface, int16 destX, int16 destY, NRect &ddRect, bool transparent, byte version,
 		       const Graphics::Surface *shadowSurface = NULL, byte alphaColor = 0);
 	void blitRenderItem(const RenderItem &renderItem, const Common::Rect &clipRect);
+#ifndef RELEASE_BUILD
+	bool benchmarkUpdate(uint frames, uint32 &time, uint32 &referenceTime);
+#endif
 protected:
+	enum {
+		kGridCellSize = 64,
+		kGridWidth = (640 + kGridCellSize - 1) / kGridCellSize,
+		kGridHeight = (480 + kGridCellSize - 1) / kGridCellSize
+	};
+
 	NeverhoodEngine *_vm;
 	MicroTileArray *_microTiles;
 	Graphics::Surface *_backScreen;
@@ -103,6 +124,18 @@ protected:
 	int16 _yOffset, _savedYOffset;
 	bool _fullRefresh;
 	RenderQueue *_renderQueue, *_prevRenderQueue;
+	// Items of the previous frame, set to true when found in the current frame
+	RenderItemMap _prevRenderItems;
+	// Indices of the render items overlapping each cell of a coarse screen grid
+	Common::Array<uint> _gridCells[kGridWidth * kGridHeight];
+	Common::Array<uint> _rectItems;
+	Common::Array<uint32> _itemStamps;
+	uint32 _itemStamp;
+	RectangleList *composeRenderQueue();
+#ifndef RELEASE_BUILD
+	RectangleList *composeRenderQueueReference();
+#endif
+	void blitRenderQueue(const RectangleList &updateRects);
 };
 
 } // End of namespace Neverhood
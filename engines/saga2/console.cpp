@@ -26,6 +26,7 @@
 
 #include "saga2/saga2.h"
 #include "saga2/automap.h"
+#include "saga2/imagcach.h"
 #include "saga2/objects.h"
 #include "saga2/player.h"
 #include "saga2/mapfeatr.h"
@@ -69,6 +70,7 @@ Console::Console(Saga2Engine *vm) : GUI::Debugger() {
 	registerCmd("play_voice", WRAP_METHOD(Console, cmdPlayVoice));
 	registerCmd("invis", WRAP_METHOD(Console, cmdInvisibility));
 	registerCmd("map_cheat", WRAP_METHOD(Console, cmdMapCheat));
+	registerCmd("image_cache", WRAP_METHOD(Console, cmdImageCache));
 }
 
 Console::~Console() {
@@ -496,4 +498,26 @@ bool Console::cmdMapCheat(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdImageCache(int argc, const char **argv) {
+	CImageCache *cache = _vm->_imageCache;
+
+	if (argc > 2) {
+		debugPrintf("Usage: %s <Budget in KB>\n", argv[0]);
+		return true;
+	}
+
+	if (argc == 2) {
+		cache->setBudget(atoi(argv[1]) * 1024);
+		cache->resetStats();
+	}
+
+	uint32 requests = cache->getHits() + cache->getReleasedHits() + cache->getMisses();
+	debugPrintf("Images: %d, released: %d (%d of %d KB)\n", cache->getNumImages(), cache->getNumReleased(),
+	            cache->getReleasedSize() / 1024, cache->getBudget() / 1024);
+	debugPrintf("Requests: %d, in use: %d, released: %d, loaded: %d, hit rate: %d%%\n", requests,
+	            cache->getHits(), cache->getReleasedHits(), cache->getMisses(),
+	            requests ? (cache->getHits() + cache->getReleasedHits()) * 100 / requests : 0);
+	return true;
+}
+
 }
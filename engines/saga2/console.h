@@ -94,6 +94,8 @@ private:
 	bool cmdInvisibility(int argc, const char **argv);
 	// Input: <1/0>. Sets state of Automap cheat for testing.
 	bool cmdMapCheat(int argc, const char **argv);
+	// Input: <Budget in KB> (optional). Shows the image cache statistics, or sets its budget.
+	bool cmdImageCache(int argc, const char **argv);
 };
 
 }
@@ -35,11 +35,13 @@ CImageNode::CImageNode(hResContext *con, uint32 resID) {
 		_image           = LoadResource(con, resID, "CImageNode Allocation");
 		_resourceID      = resID;
 		_contextID       = con->getResID();
+		_size            = con->size(resID);
 		_requested       = 0;    // zero request for this node at creation
 	} else {
 		_image = nullptr;
 		_resourceID = 0;
 		_contextID = 0;
+		_size = 0;
 		_requested = 0;
 	}
 }
@@ -95,80 +97,98 @@ void *CImageNode::getImagePtr() {
    ImageCache member functions
  * ===================================================================== */
 
-CImageCache::~CImageCache() {
-
-	/* >>> See notes below
-	    // return if list is empty
-	if( nodes.empty() ) return;
-
-
-	CImageNode *imageNode, *nextImageNode;
-
-
-	    // for some reason, doing a nodes.last() ( or nodes.first() )
-	    // here causes an access viloation.  This might be caused
-	    // by list corruption occuring during runtime,
-	    // I'm going to disable destructor for now to run some tests
-	    // to determine cause.  This should not adversely affect normal runtime
-	    // execution as all nodes should be released DURING runtime.
-	for( imageNode = ( CImageNode * )nodes.last();
-	     imageNode != NULL;
-	     imageNode = nextImageNode )
-	{
+CImageCache::CImageCache(uint32 budget) {
+	_releasedSize = 0;
+	_budget = budget;
+	_hits = 0;
+	_releasedHits = 0;
+	_misses = 0;
+}
 
-	        // keep a copy of the pointer
-	    nextImageNode = ( CImageNode *)imageNode->prev();
+CImageCache::~CImageCache() {
+	// Only free the released images. All the requested ones should have been
+	// released during runtime, and their owners may still point to them.
+	trimReleased(0);
+}
 
-	        // remove and delete it
-	    imageNode->remove();
-	    delete imageNode;
+void CImageCache::removeNode(CImageNode *imageNode) {
+	_nodes.erase(ImageKey(imageNode->_contextID, imageNode->_resourceID));
+	_images.erase(imageNode->_image);
+	delete imageNode;
+}
 
+// free the least recently released images until the rest fits in the budget
+void CImageCache::trimReleased(uint32 budget) {
+	while (_releasedSize > budget) {
+		CImageNode *imageNode = _released.front();
+		_released.pop_front();
+		_releasedSize -= imageNode->_size;
+		removeNode(imageNode);
 	}
-	*/
+}
+
+void CImageCache::setBudget(uint32 budget) {
+	_budget = budget;
+	trimReleased(_budget);
 }
 
 void CImageCache::releaseImage(void *imagePtr) {
 	if (!imagePtr)  return;
 
-	CImageNode *imageNode;
-	Common::List<CImageNode *>::iterator nextIt;
-
-	for (Common::List<CImageNode *>::iterator it = _nodes.begin(); it != _nodes.end(); it = nextIt) {
-		nextIt = it;
-		nextIt++;
-
-		imageNode = *it;
-		if (imageNode->isSameImage(imagePtr)) {
-			// if that was the last request for the imageNode, delete it
-			if (imageNode->releaseRequest()) {
-				// remove and delete it
-				_nodes.remove(imageNode);
-				delete imageNode;
-			}
+	ImageMap::iterator it = _images.find(imagePtr);
+	if (it == _images.end())
+		return;
+
+	CImageNode *imageNode = it->_value;
+
+	// if that was the last request for the imageNode, keep it around while
+	// there is room for it, it is likely to be requested again soon
+	if (imageNode->releaseRequest()) {
+		if (imageNode->_size > _budget) {
+			removeNode(imageNode);
+			return;
 		}
+
+		_released.push_back(imageNode);
+		imageNode->_releasedPos = --_released.end();
+		_releasedSize += imageNode->_size;
+		trimReleased(_budget);
 	}
 }
 
 void *CImageCache::requestImage(hResContext *con, uint32 resID) {
-	CImageNode *imageNode;
+	if (!con)
+		return nullptr;
 
-	// look through all nodes to see if we have that image already
-	for (Common::List<CImageNode *>::iterator it = _nodes.begin(); it != _nodes.end(); it++) {
-		imageNode = *it;
+	CImageNode *imageNode;
 
-		if (imageNode->isSameImage(con, resID)) {
-			// return the image Ptr to the already allocated image resource
-			return imageNode->getImagePtr();
+	// see if we have that image already
+	NodeMap::iterator it = _nodes.find(ImageKey(con->getResID(), resID));
+	if (it != _nodes.end()) {
+		imageNode = it->_value;
+
+		if (imageNode->getNumRequested() == 0) {
+			// the image was released, but not freed yet
+			_released.erase(imageNode->_releasedPos);
+			_releasedSize -= imageNode->_size;
+			_releasedHits++;
+		} else {
+			_hits++;
 		}
+
+		// return the image Ptr to the already allocated image resource
+		return imageNode->getImagePtr();
 	}
 
 	// if no previously allocated image node then make one and return the
 	// ptr to the new image resource
 	// creates node and loads in the resource
 	imageNode = new CImageNode(con, resID);
+	_misses++;
 
-	// add this node to the list
-	_nodes.push_back(imageNode);
+	// add this node to the maps
+	_nodes[ImageKey(imageNode->_contextID, imageNode->_resourceID)] = imageNode;
+	_images[imageNode->_image] = imageNode;
 
 	// return the newly loaded image
 	return imageNode->getImagePtr();
@@ -26,6 +26,10 @@
 #ifndef SAGA2_IMAGCACH_H
 #define SAGA2_IMAGCACH_H
 
+#include "common/hashmap.h"
+#include "common/hash-ptr.h"
+#include "common/list.h"
+
 namespace Saga2 {
 
 /* ===================================================================== *
@@ -33,13 +37,19 @@ namespace Saga2 {
  * ===================================================================== */
 
 class CImageNode {
+	friend class CImageCache;
+
 private:
 	uint32      _contextID;  // ID of context
 	uint32      _resourceID;     // RES_ID of  image
+	uint32      _size;       // size of the image in bytes
 
 	uint16  _requested;  // the number of allocation requests made to node
 	void    *_image;     // the image
 
+	// position in the list of released images, if not requested anymore
+	Common::List<CImageNode *>::iterator _releasedPos;
+
 public:
 	CImageNode(hResContext *con, uint32 resID);
 	~CImageNode();
@@ -60,16 +70,79 @@ public:
 
 class CImageCache {
 private:
-	Common::List<CImageNode *> _nodes;    // list of ImageNode
+	struct ImageKey {
+		uint32 contextID;
+		uint32 resourceID;
+
+		ImageKey(uint32 con, uint32 res) : contextID(con), resourceID(res) {}
+		bool operator==(const ImageKey &other) const {
+			return contextID == other.contextID && resourceID == other.resourceID;
+		}
+	};
+
+	struct ImageKeyHash {
+		uint operator()(const ImageKey &key) const {
+			return key.contextID * 31 + key.resourceID;
+		}
+	};
+
+	typedef Common::HashMap<ImageKey, CImageNode *, ImageKeyHash> NodeMap;
+	typedef Common::HashMap<void *, CImageNode *> ImageMap;
+
+	NodeMap _nodes;     // all the nodes, by context and resource ID
+	ImageMap _images;   // all the nodes, by image pointer
+
+	// Images which are not requested anymore, but kept in memory while
+	// they fit in the budget. Least recently released first.
+	Common::List<CImageNode *> _released;
+	uint32 _releasedSize;
+	uint32 _budget;
+
+	uint32 _hits;           // requests for an image already in use
+	uint32 _releasedHits;   // requests for a released image still in memory
+	uint32 _misses;         // requests which had to load the image
+
+	void removeNode(CImageNode *imageNode);
+	void trimReleased(uint32 budget);
 
 public:
-	CImageCache() {
-		assert(_nodes.empty());
-	}
+	enum {
+		kDefaultBudget = 512 * 1024
+	};
+
+	CImageCache(uint32 budget = kDefaultBudget);
 	~CImageCache();
 
 	void *requestImage(hResContext *con, uint32 resID);
 	void releaseImage(void *);
+
+	// Sets how many bytes of released images may be kept in memory
+	void setBudget(uint32 budget);
+	uint32 getBudget() const {
+		return _budget;
+	}
+
+	uint32 getNumImages() const {
+		return _nodes.size();
+	}
+	uint32 getNumReleased() const {
+		return _released.size();
+	}
+	uint32 getReleasedSize() const {
+		return _releasedSize;
+	}
+	uint32 getHits() const {
+		return _hits;
+	}
+	uint32 getReleasedHits() const {
+		return _releasedHits;
+	}
+	uint32 getMisses() const {
+		return _misses;
+	}
+	void resetStats() {
+		_hits = _releasedHits = _misses = 0;
+	}
 };
 
 } // end of namespace Saga2
@@ -25,6 +25,7 @@
 #include "sherlock/scalpel/scalpel.h"
 #include "sherlock/scalpel/scalpel_debugger.h"
 #include "sherlock/tattoo/tattoo_debugger.h"
+#include "common/file.h"
 #include "common/str-array.h"
 
 namespace Sherlock {
@@ -47,6 +48,9 @@ Debugger::Debugger(SherlockEngine *vm) : GUI::Debugger(), _vm(vm) {
 	registerCmd("dumpfile",      WRAP_METHOD(Debugger, cmdDumpFile));
 	registerCmd("locations",     WRAP_METHOD(Debugger, cmdLocations));
 	registerCmd("flag",          WRAP_METHOD(Debugger, cmdFlag));
+#ifndef RELEASE_BUILD
+	registerCmd("lzbench",       WRAP_METHOD(Debugger, cmdLZBench));
+#endif
 }
 
 void Debugger::postEnter() {
@@ -182,4 +186,31 @@ bool Debugger::cmdFlag(int argc, const char **argv) {
 	return true;
 }
 
+#ifndef RELEASE_BUILD
+bool Debugger::cmdLZBench(int argc, const char **argv) {
+	Common::StringArray libraries;
+	if (argc > 1) {
+		for (int idx = 1; idx < argc; ++idx)
+			libraries.push_back(argv[idx]);
+	} else {
+		_vm->_res->getLibraryNames(libraries);
+	}
+
+	for (uint idx = 0; idx < libraries.size(); ++idx) {
+		if (!Common::File::exists(Common::Path(libraries[idx]))) {
+			debugPrintf("%s: library not found\n", libraries[idx].c_str());
+			continue;
+		}
+
+		uint numFiles;
+		uint32 time, referenceTime;
+		bool identical = _vm->_res->benchmarkDecompression(Common::Path(libraries[idx]), numFiles, time, referenceTime);
+		debugPrintf("%s: %d compressed files, %d ms, original decoder %d ms, output %s\n", libraries[idx].c_str(),
+			numFiles, time, referenceTime, identical ? "identical" : "DIFFERENT");
+	}
+
+	return true;
+}
+#endif
+
 } // End of namespace Sherlock
@@ -73,6 +73,13 @@ private:
 	 * Get or set the value of a flag
 	 */
 	bool cmdFlag(int argc, const char **argv);
+
+#ifndef RELEASE_BUILD
+	/**
+	 * Times the decompression of the resources of libraries
+	 */
+	bool cmdLZBench(int argc, const char **argv);
+#endif
 protected:
 	SherlockEngine *_vm;
 	Common::Path _3doPlayMovieFile;
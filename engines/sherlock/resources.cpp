@@ -24,10 +24,27 @@
 #include "sherlock/sherlock.h"
 #include "common/debug.h"
 #include "common/memstream.h"
+#include "common/system.h"
 
 namespace Sherlock {
 
+/**
+ * A stream over the data of a cache entry, which keeps the data alive
+ * if the entry gets evicted from the cache
+ */
+class CacheEntryStream : public Common::MemoryReadStream {
+private:
+	Common::SharedPtr<CacheEntry> _entry;
+public:
+	CacheEntryStream(const Common::SharedPtr<CacheEntry> &entry) :
+		Common::MemoryReadStream(entry->empty() ? nullptr : &(*entry)[0], entry->size()), _entry(entry) {}
+};
+
+/*----------------------------------------------------------------*/
+
 Cache::Cache(SherlockEngine *vm) : _vm(vm) {
+	_size = 0;
+	_budget = DEFAULT_BUDGET;
 }
 
 bool Cache::isCached(const Common::Path &filename) const {
@@ -44,12 +61,12 @@ void Cache::load(const Common::Path &name) {
 	if (!f.open(name))
 		error("Could not read file - %s", name.toString().c_str());
 
-	load(name, f);
+	load(name, f, true);
 
 	f.close();
 }
 
-void Cache::load(const Common::Path &name, Common::SeekableReadStream &stream) {
+void Cache::load(const Common::Path &name, Common::SeekableReadStream &stream, bool pinned) {
 	// First check if the entry already exists
 	if (_resources.contains(name))
 		return;
@@ -58,8 +75,8 @@ void Cache::load(const Common::Path &name, Common::SeekableReadStream &stream) {
 	stream.seek(0);
 
 	// Allocate a new cache entry
-	_resources[name] = CacheEntry();
-	CacheEntry &cacheEntry = _resources[name];
+	Common::SharedPtr<CacheEntry> data(new CacheEntry());
+	CacheEntry &cacheEntry = *data;
 
 	// Check whether the file is compressed
 	if (signature == MKTAG('L', 'Z', 'V', 26)) {
@@ -74,12 +91,48 @@ void Cache::load(const Common::Path &name, Common::SeekableReadStream &stream) {
 		cacheEntry.resize(stream.size());
 		stream.read(&cacheEntry[0], stream.size());
 	}
+
+	// Evict older entries if needed. The new entry is always kept, as it's about to be used
+	if (!pinned) {
+		makeRoom(cacheEntry.size());
+		_lru.push_back(name);
+		_size += cacheEntry.size();
+	}
+
+	CacheItem &item = _resources[name];
+	item._data = data;
+	item._pinned = pinned;
+	if (!pinned)
+		item._lruPos = --_lru.end();
 }
 
-Common::SeekableReadStream *Cache::get(const Common::Path &filename) const {
+Common::SeekableReadStream *Cache::get(const Common::Path &filename) {
+	CacheItem &item = _resources[filename];
+	assert(item._data);
+
+	// Mark the entry as the most recently used one
+	if (!item._pinned) {
+		_lru.erase(item._lruPos);
+		_lru.push_back(filename);
+		item._lruPos = --_lru.end();
+	}
+
 	// Return a memory stream that encapsulates the data
-	const CacheEntry &cacheEntry = _resources[filename];
-	return new Common::MemoryReadStream(&cacheEntry[0], cacheEntry.size());
+	return new CacheEntryStream(item._data);
+}
+
+void Cache::makeRoom(uint32 size) {
+	while (!_lru.empty() && _size + size > _budget) {
+		CacheHash::iterator i = _resources.find(_lru.front());
+		_size -= i->_value._data->size();
+		_resources.erase(i);
+		_lru.pop_front();
+	}
+}
+
+void Cache::setBudget(uint32 budget) {
+	_budget = budget;
+	makeRoom(0);
 }
 
 /*----------------------------------------------------------------*/
@@ -321,6 +374,76 @@ void Resources::getResourceNames(const Common::Path &libraryFile, Common::String
 	}
 }
 
+#ifndef RELEASE_BUILD
+void Resources::getLibraryNames(Common::StringArray &names) {
+	for (LibraryIndexes::iterator i = _indexes.begin(); i != _indexes.end(); ++i)
+		names.push_back(i->_key.toString('/'));
+}
+
+bool Resources::benchmarkDecompression(const Common::Path &libraryFile, uint &numFiles, uint32 &time, uint32 &referenceTime) {
+	addToCache(libraryFile);
+	numFiles = 0;
+	time = referenceTime = 0;
+	if (!_indexes.contains(libraryFile))
+		return true;
+
+	// Gather the compressed resources of the library
+	Common::Array<Common::SeekableReadStream *> sources;
+	Common::Array<uint32> outSizes;
+	Common::SeekableReadStream *libStream = load(libraryFile);
+	LibraryIndex &libIndex = _indexes[libraryFile];
+	for (LibraryIndex::iterator i = libIndex.begin(); i != libIndex.end(); ++i) {
+		if (i->_value._size < 8)
+			continue;
+
+		libStream->seek(i->_value._offset);
+		if (libStream->readUint32BE() != MKTAG('L', 'Z', 'V', 26))
+			continue;
+
+		outSizes.push_back(libStream->readUint32LE());
+		sources.push_back(libStream->readStream(i->_value._size - 8));
+	}
+	delete libStream;
+	numFiles = sources.size();
+
+	// The original decoder may write a few bytes past the end of the output
+	const uint32 slack = 18;
+	Common::Array<byte *> outputs, referenceOutputs;
+	for (uint idx = 0; idx < numFiles; ++idx) {
+		outputs.push_back((byte *)calloc(outSizes[idx] + slack, 1));
+		referenceOutputs.push_back((byte *)calloc(outSizes[idx] + slack, 1));
+	}
+
+	Common::Array<int32> endPos;
+	uint32 startTime = g_system->getMillis();
+	for (uint idx = 0; idx < numFiles; ++idx) {
+		decompressLZ(*sources[idx], outputs[idx], outSizes[idx], -1);
+		endPos.push_back(sources[idx]->pos());
+	}
+	time = g_system->getMillis() - startTime;
+
+	for (uint idx = 0; idx < numFiles; ++idx)
+		sources[idx]->seek(0);
+
+	startTime = g_system->getMillis();
+	for (uint idx = 0; idx < numFiles; ++idx)
+		decompressLZReference(*sources[idx], referenceOutputs[idx], outSizes[idx], -1);
+	referenceTime = g_system->getMillis() - startTime;
+
+	bool identical = true;
+	for (uint idx = 0; idx < numFiles; ++idx) {
+		if (memcmp(outputs[idx], referenceOutputs[idx], outSizes[idx]) || endPos[idx] != sources[idx]->pos())
+			identical = false;
+
+		free(outputs[idx]);
+		free(referenceOutputs[idx]);
+		delete sources[idx];
+	}
+
+	return identical;
+}
+#endif
+
 Common::SeekableReadStream *Resources::decompress(Common::SeekableReadStream &source) {
 	// This variation can't be used by Rose Tattoo, since compressed resources include the input size,
 	// not the output size. Which means their decompression has to be done via passed buffers
@@ -357,6 +480,66 @@ Common::SeekableReadStream *Resources::decompressLZ(Common::SeekableReadStream &
 }
 
 void Resources::decompressLZ(Common::SeekableReadStream &source, byte *outBuffer, int32 outSize, int32 inSize) {
+	// Read all the compressed data at once, rather than byte by byte. Without an input size,
+	// read as much as the output may need: a command byte for every eight literals. The last
+	// command may go up to three bytes past the end, reads past the end of the source give 0
+	assert(inSize != -1 || outSize != -1);
+	const int32 startPos = source.pos();
+	const int32 bufferSize = (inSize != -1) ? inSize + 3 : outSize + outSize / 8 + 3;
+	const int32 readSize = MAX<int32>(MIN<int32>(bufferSize, source.size() - startPos), 0);
+	byte *inBuffer = (byte *)malloc(bufferSize);
+	source.read(inBuffer, readSize);
+	memset(inBuffer + readSize, 0, bufferSize - readSize);
+
+	const byte *in = inBuffer;
+	const byte *inEnd = (inSize != -1) ? inBuffer + inSize : nullptr;
+	byte *outBufferEnd = outBuffer + outSize;
+
+	byte lzWindow[4096];
+	uint16 lzWindowPos;
+	uint16 cmd;
+
+	memset(lzWindow, 0xFF, 0xFEE);
+	memset(lzWindow + 0xFEE, 0, 0x1000 - 0xFEE);
+	lzWindowPos = 0xFEE;
+	cmd = 0;
+
+	do {
+		cmd >>= 1;
+		if (!(cmd & 0x100))
+			cmd = *in++ | 0xFF00;
+
+		if (cmd & 1) {
+			byte literal = *in++;
+			*outBuffer++ = literal;
+			lzWindow[lzWindowPos] = literal;
+			lzWindowPos = (lzWindowPos + 1) & 0x0FFF;
+		} else {
+			int copyPos, copyLen;
+			copyPos = in[0] | ((in[1] & 0xF0) << 4);
+			copyLen = (in[1] & 0x0F) + 3;
+			in += 2;
+
+			// Don't write past the end of the output
+			if (outSize != -1)
+				copyLen = MIN<int>(copyLen, outBufferEnd - outBuffer);
+
+			while (copyLen--) {
+				byte literal = lzWindow[copyPos];
+				copyPos = (copyPos + 1) & 0x0FFF;
+				*outBuffer++ = literal;
+				lzWindow[lzWindowPos] = literal;
+				lzWindowPos = (lzWindowPos + 1) & 0x0FFF;
+			}
+		}
+	} while ((outSize == -1 || outBuffer < outBufferEnd) && (inSize == -1 || in < inEnd));
+
+	source.seek(startPos + MIN<int32>(in - inBuffer, readSize));
+	free(inBuffer);
+}
+
+#ifndef RELEASE_BUILD
+void Resources::decompressLZReference(Common::SeekableReadStream &source, byte *outBuffer, int32 outSize, int32 inSize) {
 	byte lzWindow[4096];
 	uint16 lzWindowPos;
 	uint16 cmd;
@@ -365,6 +548,7 @@ void Resources::decompressLZ(Common::SeekableReadStream &source, byte *outBuffer
 	int endPos = source.pos() + inSize;
 
 	memset(lzWindow, 0xFF, 0xFEE);
+	memset(lzWindow + 0xFEE, 0, 0x1000 - 0xFEE);
 	lzWindowPos = 0xFEE;
 	cmd = 0;
 
@@ -394,5 +578,6 @@ void Resources::decompressLZ(Common::SeekableReadStream &source, byte *outBuffer
 		}
 	} while ((outSize == -1 || outBuffer < outBufferEnd) && (inSize == -1 || source.pos() < endPos));
 }
+#endif
 
 } // End of namespace Sherlock
@@ -26,6 +26,8 @@
 #include "common/file.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "common/list.h"
+#include "common/ptr.h"
 #include "common/rect.h"
 #include "common/str.h"
 #include "common/str-array.h"
@@ -35,7 +37,20 @@
 namespace Sherlock {
 
 typedef Common::Array<byte> CacheEntry;
-typedef Common::HashMap<Common::Path, CacheEntry, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> CacheHash;
+
+struct CacheItem {
+	// Shared with the streams returned by Cache::get, so that evicting
+	// the item doesn't pull the data from under them
+	Common::SharedPtr<CacheEntry> _data;
+	// Pinned items are never evicted
+	bool _pinned;
+	// Position in the LRU list, for items which aren't pinned
+	Common::List<Common::Path>::iterator _lruPos;
+
+	CacheItem() : _pinned(false) {}
+};
+
+typedef Common::HashMap<Common::Path, CacheItem, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> CacheHash;
 
 struct LibraryEntry {
 	uint32 _offset, _size;
@@ -54,7 +69,17 @@ class Cache {
 private:
 	SherlockEngine *_vm;
 	CacheHash _resources;
+	Common::List<Common::Path> _lru;	// Items which aren't pinned, least recently used first
+	uint32 _size;						// Total size of the items which aren't pinned
+	uint32 _budget;
+
+	/**
+	 * Evicts the least recently used items until there is room for the given size
+	 */
+	void makeRoom(uint32 size);
 public:
+	enum { DEFAULT_BUDGET = 4 * 1024 * 1024 };
+
 	Cache(SherlockEngine *_vm);
 
 	/**
@@ -65,19 +90,31 @@ public:
 	/**
 	 * Loads a file into the cache if it's not already present, and returns it.
 	 * If the file is LZW compressed, automatically decompresses it and loads
-	 * the uncompressed version into memory
+	 * the uncompressed version into memory. Files are pinned in the cache.
 	 */
 	void load(const Common::Path &name);
 
 	/**
-	 * Load a cache entry based on a passed stream
+	 * Load a cache entry based on a passed stream. Unless pinned, the entry may be
+	 * evicted to make room for newer ones once the cache is over its budget
 	 */
-	void load(const Common::Path &name, Common::SeekableReadStream &stream);
+	void load(const Common::Path &name, Common::SeekableReadStream &stream, bool pinned = false);
 
 	/**
 	 * Get a file from the cache
 	 */
-	Common::SeekableReadStream *get(const Common::Path &filename) const;
+	Common::SeekableReadStream *get(const Common::Path &filename);
+
+	/**
+	 * Sets the maximum total size of the entries which aren't pinned
+	 */
+	void setBudget(uint32 budget);
+	uint32 getBudget() const { return _budget; }
+
+	/**
+	 * Returns the total size of the entries which aren't pinned
+	 */
+	uint32 getSize() const { return _size; }
 };
 
 class Resources {
@@ -112,6 +149,11 @@ public:
 
 	bool isInCache(const Common::Path &filename) const { return _cache.isCached(filename); }
 
+	/**
+	 * Returns how many bytes of entries which aren't pinned the cache holds at most
+	 */
+	uint32 cacheBudget() const { return _cache.getBudget(); }
+
 	/**
 	 * Checks the passed stream, and if is compressed, deletes it and replaces it with its uncompressed data
 	 */
@@ -144,6 +186,19 @@ public:
 	 */
 	void getResourceNames(const Common::Path &libraryFile, Common::StringArray &names);
 
+#ifndef RELEASE_BUILD
+	/**
+	 * Produces a list of all the library files whose index has been loaded. Used by the debugger.
+	 */
+	void getLibraryNames(Common::StringArray &names);
+
+	/**
+	 * Decompresses every compressed resource of a library with both LZ decoders, and times them.
+	 * Returns false if the outputs differ. Used by the debugger.
+	 */
+	bool benchmarkDecompression(const Common::Path &libraryFile, uint &numFiles, uint32 &time, uint32 &referenceTime);
+#endif
+
 	/**
 	 * Decompresses LZW compressed data
 	 */
@@ -168,6 +223,13 @@ public:
 	 * Decompresses LZW compressed data
 	 */
 	static void decompressLZ(Common::SeekableReadStream &source, byte *outBuffer, int32 outSize, int32 inSize);
+
+#ifndef RELEASE_BUILD
+	/**
+	 * The original byte by byte LZW decoder, kept to check decompressLZ against
+	 */
+	static void decompressLZReference(Common::SeekableReadStream &source, byte *outBuffer, int32 outSize, int32 inSize);
+#endif
 };
 
 } // End of namespace Sherlock
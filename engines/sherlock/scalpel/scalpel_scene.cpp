@@ -48,6 +48,9 @@ bool ScalpelScene::loadScene(const Common::Path &filename) {
 	ScalpelMap &map = *(ScalpelMap *)_vm->_map;
 	bool result = Scene::loadScene(filename);
 
+	if (result)
+		prefetchCAnims();
+
 	if (!_vm->isDemo()) {
 		// Reset the previous map location and position on overhead map
 		map._oldCharPoint = _currentScene;
@@ -60,6 +63,43 @@ bool ScalpelScene::loadScene(const Common::Path &filename) {
 	return result;
 }
 
+void ScalpelScene::cacheCAnim(Common::SeekableReadStream &roomStream, const CAnim &cAnim) {
+	Resources &res = *_vm->_res;
+
+	roomStream.seek(cAnim._dataOffset);
+	//rrmStream->seek(44 + cAnimNum * 4);
+	//rrmStream->seek(rrmStream->readUint32LE());
+
+	// Load the canimation into the cache
+	Common::SeekableReadStream *imgStream = !_compressed ? roomStream.readStream(cAnim._dataSize) :
+		Resources::decompressLZ(roomStream, cAnim._dataSize);
+	res.addToCache(Common::Path(cAnim._name + ".vgs"), *imgStream);
+
+	delete imgStream;
+}
+
+void ScalpelScene::prefetchCAnims() {
+	Resources &res = *_vm->_res;
+	Common::SeekableReadStream *roomStream = nullptr;
+	uint32 spaceLeft = res.cacheBudget();
+
+	for (uint idx = 0; idx < _cAnim.size(); ++idx) {
+		const CAnim &cAnim = _cAnim[idx];
+		if (cAnim._name.empty() || cAnim._type == NO_SHAPE || (uint32)cAnim._dataSize > spaceLeft)
+			continue;
+
+		if (res.isInCache(Common::Path(cAnim._name + ".vgs")))
+			continue;
+
+		if (!roomStream)
+			roomStream = res.load(_roomFilename);
+		cacheCAnim(*roomStream, cAnim);
+		spaceLeft -= cAnim._dataSize;
+	}
+
+	delete roomStream;
+}
+
 void ScalpelScene::drawAllShapes() {
 	People &people = *_vm->_people;
 	Screen &screen = *_vm->_screen;
@@ -576,16 +616,7 @@ int ScalpelScene::startCAnim(int cAnimNum, int playRate) {
 		if (!res.isInCache(fname)) {
 			// Set up RRM scene data
 			Common::SeekableReadStream *roomStream = res.load(_roomFilename);
-			roomStream->seek(cAnim._dataOffset);
-			//rrmStream->seek(44 + cAnimNum * 4);
-			//rrmStream->seek(rrmStream->readUint32LE());
-
-			// Load the canimation into the cache
-			Common::SeekableReadStream *imgStream = !_compressed ? roomStream->readStream(cAnim._dataSize) :
-				Resources::decompressLZ(*roomStream, cAnim._dataSize);
-			res.addToCache(fname, *imgStream);
-
-			delete imgStream;
+			cacheCAnim(*roomStream, cAnim);
 			delete roomStream;
 		}
 
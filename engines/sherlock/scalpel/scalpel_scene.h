@@ -43,6 +43,17 @@ enum { BLACKWOOD_CAPTURE = 2, BAKER_STREET = 4, DRAWING_ROOM = 12, STATION = 17,
 class ScalpelScene : public Scene {
 private:
 	void doBgAnimCheckCursor();
+
+	/**
+	 * Extracts the data of a canimation from the room file, and adds it to the cache
+	 */
+	void cacheCAnim(Common::SeekableReadStream &roomStream, const CAnim &cAnim);
+
+	/**
+	 * Adds the canimations of the scene to the cache, so they don't have to be
+	 * decompressed when they get started. Stops when the cache budget is reached
+	 */
+	void prefetchCAnims();
 protected:
 	/**
 	 * Loads the data associated for a given scene. The room resource file's format is:
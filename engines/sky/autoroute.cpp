@@ -20,7 +20,10 @@
  */
 
 
+#include "common/array.h"
 #include "common/endian.h"
+#include "common/random.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
@@ -35,6 +38,7 @@ namespace Sky {
 #define ROUTE_GRID_WIDTH ((GAME_SCREEN_WIDTH/8)+2)
 #define ROUTE_GRID_HEIGHT ((GAME_SCREEN_HEIGHT/8)+2)
 #define ROUTE_GRID_SIZE (ROUTE_GRID_WIDTH*ROUTE_GRID_HEIGHT*2)
+#define ROUTE_GRID_BLOCKS (ROUTE_GRID_WIDTH*ROUTE_GRID_HEIGHT)
 #define WALK_JUMP 8      // walk in blocks of 8
 
 const int16 AutoRoute::_routeDirections[4] = {    -1,     1, -ROUTE_GRID_WIDTH, ROUTE_GRID_WIDTH };
@@ -43,13 +47,28 @@ const uint16 AutoRoute::_logicCommands[4] = { RIGHTY, LEFTY,             DOWNY,
 AutoRoute::AutoRoute(Grid *pGrid, SkyCompact *compact) {
 	_grid = pGrid;
 	_skyCompact = compact;
-	_routeGrid = (uint16 *)malloc(ROUTE_GRID_SIZE);
+	// routes starting in the top rows scan the bottom border row, and look one
+	// row past the grid from there. Keep an empty row there, so it's ignored.
+	_routeGrid = (uint16 *)calloc(ROUTE_GRID_SIZE + ROUTE_GRID_WIDTH * 2, 1);
 	_routeBuf = (uint16 *)malloc(ROUTE_SPACE);
+	_walkHeap = (uint16 *)malloc(ROUTE_GRID_SIZE);
+	_walkFrontier = (uint16 *)malloc(ROUTE_GRID_SIZE);
+	_walkHeapMark = (uint16 *)malloc(ROUTE_GRID_SIZE);
+	_walkFrontierMark = (uint16 *)malloc(ROUTE_GRID_SIZE);
+	_walkDirX = _walkDirY = 0;
+	_walkPass = 0;
+	_walkHeapSize = _walkFrontierSize = 0;
+	memset(_walkHeapMark, 0, ROUTE_GRID_SIZE);
+	memset(_walkFrontierMark, 0, ROUTE_GRID_SIZE);
 }
 
 AutoRoute::~AutoRoute() {
 	free(_routeGrid);
 	free(_routeBuf);
+	free(_walkHeap);
+	free(_walkFrontier);
+	free(_walkHeapMark);
+	free(_walkFrontierMark);
 }
 
 uint16 AutoRoute::checkBlock(uint16 *blockPos) {
@@ -121,7 +140,185 @@ void AutoRoute::initWalkGrid(uint8 screen, uint8 width) {
 	}
 }
 
+uint16 AutoRoute::walkKey(uint16 pos) {
+	// Index of a block in the order calcWalkGridReference() scans the grid.
+	// The mapping is its own inverse, so it also turns keys back into blocks.
+	uint16 row = pos / ROUTE_GRID_WIDTH;
+	uint16 col = pos % ROUTE_GRID_WIDTH;
+	if (_walkDirY < 0)
+		row = (ROUTE_GRID_HEIGHT - 1) - row;
+	if (_walkDirX < 0)
+		col = (ROUTE_GRID_WIDTH - 1) - col;
+	return row * ROUTE_GRID_WIDTH + col;
+}
+
+bool AutoRoute::inWalkRoi(uint16 pos, uint16 roiStart, uint8 roiX, uint8 roiY) {
+	int16 rowDist = pos / ROUTE_GRID_WIDTH - roiStart / ROUTE_GRID_WIDTH;
+	int16 colDist = pos % ROUTE_GRID_WIDTH - roiStart % ROUTE_GRID_WIDTH;
+	if (_walkDirY < 0)
+		rowDist = -rowDist;
+	if (_walkDirX < 0)
+		colDist = -colDist;
+	return (rowDist >= 0) && (rowDist < roiY) && (colDist >= 0) && (colDist < roiX);
+}
+
+void AutoRoute::pushWalkKey(uint16 key) {
+	uint16 cnt = _walkHeapSize++;
+	while (cnt) {
+		uint16 parent = (cnt - 1) >> 1;
+		if (_walkHeap[parent] <= key)
+			break;
+		_walkHeap[cnt] = _walkHeap[parent];
+		cnt = parent;
+	}
+	_walkHeap[cnt] = key;
+}
+
+uint16 AutoRoute::popWalkKey() {
+	uint16 top = _walkHeap[0];
+	uint16 key = _walkHeap[--_walkHeapSize];
+	uint16 cnt = 0;
+	while (true) {
+		uint16 child = 2 * cnt + 1;
+		if (child >= _walkHeapSize)
+			break;
+		if ((child + 1 < _walkHeapSize) && (_walkHeap[child + 1] < _walkHeap[child]))
+			child++;
+		if (key <= _walkHeap[child])
+			break;
+		_walkHeap[cnt] = _walkHeap[child];
+		cnt = child;
+	}
+	_walkHeap[cnt] = key;
+	return top;
+}
+
 bool AutoRoute::calcWalkGrid(uint8 startX, uint8 startY, uint8 destX, uint8 destY) {
+	// Fills the walk grid exactly like calcWalkGridReference(), without
+	// rescanning the whole rectangle of interest until nothing changes.
+	// The scan gives a block the lowest value of its neighbours at the time
+	// it's visited, which isn't always the shortest distance, and the route
+	// depends on those values. So instead of a plain breadth first search,
+	// the wavefront replays the scan: within a pass, blocks next to filled
+	// ones are taken in scan order, and a block behind the one that was just
+	// filled has to wait for the next pass, just like in the scan.
+	int16 directionX, directionY;
+	uint8 roiX, roiY; // Rectangle Of Interest in the walk grid
+	if (startY > destY) {
+		directionY = -ROUTE_GRID_WIDTH;
+		roiY = startY;
+	} else {
+		directionY = ROUTE_GRID_WIDTH;
+		roiY = (ROUTE_GRID_HEIGHT-1) - startY;
+	}
+	if (startX > destX) {
+		directionX = -1;
+		roiX = startX + 2;
+	} else {
+		directionX = 1;
+		roiX = (ROUTE_GRID_WIDTH - 1) - startX;
+	}
+	_walkDirX = directionX;
+	_walkDirY = directionY;
+
+	uint16 walkDest  = (destY + 1) * ROUTE_GRID_WIDTH + destX + 1;
+	uint16 walkStart = (startY + 1) * ROUTE_GRID_WIDTH + startX + 1;
+	_routeGrid[walkStart] = 1;
+
+	// the pass numbers keep counting up between calls, so the marks only
+	// have to be cleared when they wrap around
+	if (_walkPass > 0xFFFF - ROUTE_GRID_BLOCKS) {
+		memset(_walkHeapMark, 0, ROUTE_GRID_SIZE);
+		memset(_walkFrontierMark, 0, ROUTE_GRID_SIZE);
+		_walkPass = 0;
+	}
+	_walkHeapSize = _walkFrontierSize = 0;
+	for (uint8 cnt = 0; cnt < 4; cnt++) {
+		int32 nextPos = walkStart + _routeDirections[cnt];
+		if ((nextPos >= 0) && (nextPos < ROUTE_GRID_BLOCKS) && !_routeGrid[nextPos]) {
+			_walkFrontierMark[nextPos] = _walkPass + 1;
+			_walkFrontier[_walkFrontierSize++] = nextPos;
+		}
+	}
+
+	// if we are on the edge, move diagonally from start
+	if (roiY < ROUTE_GRID_HEIGHT-3)
+		walkStart -= directionY;
+
+	if (roiX < ROUTE_GRID_WIDTH-2)
+		walkStart -= directionX;
+
+	bool gridChanged = true;
+	bool foundRoute = false;
+
+	while ((!foundRoute) && gridChanged) {
+		gridChanged = false;
+		_walkPass++;
+
+		// blocks waiting from the last pass join the queue if they're inside the ROI now
+		uint16 waiting = _walkFrontierSize;
+		_walkFrontierSize = 0;
+		for (uint16 cnt = 0; cnt < waiting; cnt++) {
+			uint16 pos = _walkFrontier[cnt];
+			if (_routeGrid[pos])
+				continue;
+			if (inWalkRoi(pos, walkStart, roiX, roiY)) {
+				if (_walkHeapMark[pos] != _walkPass) {
+					_walkHeapMark[pos] = _walkPass;
+					pushWalkKey(walkKey(pos));
+				}
+			} else {
+				_walkFrontierMark[pos] = _walkPass + 1;
+				_walkFrontier[_walkFrontierSize++] = pos;
+			}
+		}
+
+		while (_walkHeapSize) {
+			uint16 key = popWalkKey();
+			uint16 pos = walkKey(key);
+			if (_routeGrid[pos])
+				continue;
+			uint16 blockRet = checkBlock(_routeGrid + pos);
+			if (blockRet == 0xFFFF)
+				continue;
+			_routeGrid[pos] = blockRet + 1;
+			gridChanged = true;
+
+			for (uint8 cnt = 0; cnt < 4; cnt++) {
+				int32 nextPos = pos + _routeDirections[cnt];
+				if ((nextPos < 0) || (nextPos >= ROUTE_GRID_BLOCKS) || _routeGrid[nextPos])
+					continue;
+				if ((walkKey(nextPos) > key) && inWalkRoi(nextPos, walkStart, roiX, roiY)) {
+					// still ahead of the scan in this pass
+					if (_walkHeapMark[nextPos] != _walkPass) {
+						_walkHeapMark[nextPos] = _walkPass;
+						pushWalkKey(walkKey(nextPos));
+					}
+				} else if (_walkFrontierMark[nextPos] != _walkPass + 1) {
+					_walkFrontierMark[nextPos] = _walkPass + 1;
+					_walkFrontier[_walkFrontierSize++] = nextPos;
+				}
+			}
+		}
+
+		if (_routeGrid[walkDest]) { // okay, finished
+			foundRoute = true;
+		} else { // we couldn't find the route, let's extend the ROI
+			if (roiY < ROUTE_GRID_HEIGHT - 4) {
+				walkStart -= directionY;
+				roiY++;
+			}
+			if (roiX < ROUTE_GRID_WIDTH - 4) {
+				walkStart -= directionX;
+				roiX++;
+			}
+		}
+	}
+	return foundRoute;
+}
+
+#ifndef RELEASE_BUILD
+bool AutoRoute::calcWalkGridReference(uint8 startX, uint8 startY, uint8 destX, uint8 destY) {
 	int16 directionX, directionY;
 	uint8 roiX, roiY; // Rectangle Of Interest in the walk grid
 	if (startY > destY) {
@@ -185,6 +382,7 @@ bool AutoRoute::calcWalkGrid(uint8 startX, uint8 startY, uint8 destX, uint8 dest
 	}
 	return foundRoute;
 }
+#endif
 
 uint16 *AutoRoute::makeRouteData(uint8 startX, uint8 startY, uint8 destX, uint8 destY) {
 	memset(_routeBuf, 0, ROUTE_SPACE);
@@ -194,6 +392,8 @@ uint16 *AutoRoute::makeRouteData(uint8 startX, uint8 startY, uint8 destX, uint8
 
 	uint16 lastVal = (*routePos) - 1;
 	while (lastVal) { // lastVal == 0 means route is done.
+		if (dataTrg == _routeBuf)
+			return nullptr; // too many turns for the route buffer
 		dataTrg -= 2;
 
 		int16 walkDirection = 0;
@@ -264,6 +464,8 @@ uint16 AutoRoute::autoRoute(Compact *cpt) {
 		return 1; // can't find route to block
 
 	uint16 *routeData = makeRouteData(startX, startY, destX, destY);
+	if (!routeData || ((routeData == _routeBuf) && initStaX))
+		return 1; // route doesn't fit into the route buffer
 	// the route is done.
 	// if there was an initial x movement (due to clipping) tag it onto the start
 	routeData = checkInitMove(routeData, initStaX);
@@ -277,4 +479,81 @@ uint16 AutoRoute::autoRoute(Compact *cpt) {
 	return 0;
 }
 
+#ifndef RELEASE_BUILD
+struct WalkTest {
+	uint8 width, startX, startY, destX, destY;
+	bool found;
+};
+
+bool AutoRoute::checkRoutes(uint32 routesPerScreen, uint32 &numRoutes, uint32 &referenceTime, uint32 &time) {
+	// Finds random routes on every screen with both calcWalkGrid() and
+	// calcWalkGridReference(), and compares the walk grids and route data.
+	Common::RandomSource rnd("skyautoroute");
+	uint8 *refGrids = (uint8 *)malloc(routesPerScreen * ROUTE_GRID_SIZE);
+	uint8 *refRoutes = (uint8 *)malloc(routesPerScreen * ROUTE_SPACE);
+	bool identical = true;
+	numRoutes = referenceTime = time = 0;
+
+	for (uint32 screen = 0; screen < _grid->giveNoScreens(); screen++) {
+		if (!_grid->giveGrid(screen))
+			continue;
+
+		Common::Array<WalkTest> tests;
+		for (uint32 tries = 0; (tries < 4 * routesPerScreen) && (tests.size() < routesPerScreen); tries++) {
+			WalkTest test;
+			test.width = rnd.getRandomNumber(3);
+			test.startX = rnd.getRandomNumber((GAME_SCREEN_WIDTH - 1) >> 3);
+			test.startY = rnd.getRandomNumber((GAME_SCREEN_HEIGHT - 1) >> 3);
+			test.destX = rnd.getRandomNumber((GAME_SCREEN_WIDTH - 1) >> 3);
+			test.destY = rnd.getRandomNumber((GAME_SCREEN_HEIGHT - 1) >> 3);
+			test.found = false;
+			if ((test.startX == test.destX) && (test.startY == test.destY))
+				continue;
+			initWalkGrid(screen, test.width);
+			if (!_routeGrid[(test.destY + 1) * ROUTE_GRID_WIDTH + test.destX + 1])
+				tests.push_back(test);
+		}
+
+		uint32 startTime = g_system->getMillis();
+		for (uint cnt = 0; cnt < tests.size(); cnt++) {
+			WalkTest &test = tests[cnt];
+			initWalkGrid(screen, test.width);
+			test.found = calcWalkGridReference(test.startX, test.startY, test.destX, test.destY);
+			memcpy(refGrids + cnt * ROUTE_GRID_SIZE, _routeGrid, ROUTE_GRID_SIZE);
+			if (test.found) {
+				if (makeRouteData(test.startX, test.startY, test.destX, test.destY))
+					memcpy(refRoutes + cnt * ROUTE_SPACE, _routeBuf, ROUTE_SPACE);
+				else
+					memset(refRoutes + cnt * ROUTE_SPACE, 0xFF, ROUTE_SPACE);
+			}
+		}
+		referenceTime += g_system->getMillis() - startTime;
+
+		startTime = g_system->getMillis();
+		for (uint cnt = 0; cnt < tests.size(); cnt++) {
+			const WalkTest &test = tests[cnt];
+			initWalkGrid(screen, test.width);
+			bool found = calcWalkGrid(test.startX, test.startY, test.destX, test.destY);
+			bool same = (found == test.found) && !memcmp(refGrids + cnt * ROUTE_GRID_SIZE, _routeGrid, ROUTE_GRID_SIZE);
+			if (same && found) {
+				if (!makeRouteData(test.startX, test.startY, test.destX, test.destY))
+					memset(_routeBuf, 0xFF, ROUTE_SPACE);
+				same = !memcmp(refRoutes + cnt * ROUTE_SPACE, _routeBuf, ROUTE_SPACE);
+			}
+			if (!same) {
+				warning("AutoRoute::checkRoutes: screen %d, width %d: route %d/%d -> %d/%d differs",
+				        screen, test.width, test.startX, test.startY, test.destX, test.destY);
+				identical = false;
+			}
+		}
+		time += g_system->getMillis() - startTime;
+		numRoutes += tests.size();
+	}
+
+	free(refGrids);
+	free(refRoutes);
+	return identical;
+}
+#endif
+
 } // End of namespace Sky
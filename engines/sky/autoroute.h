@@ -36,18 +36,37 @@ public:
 	AutoRoute(Grid *pGrid, SkyCompact *compact);
 	~AutoRoute();
 	uint16 autoRoute(Compact *cpt);
+#ifndef RELEASE_BUILD
+	bool checkRoutes(uint32 routesPerScreen, uint32 &numRoutes, uint32 &referenceTime, uint32 &time);
+#endif
 private:
 	uint16 checkBlock(uint16 *blockPos);
 	void clipCoordX(uint16 x, uint8 &blkX, int16 &initX);
 	void clipCoordY(uint16 y, uint8 &blkY, int16 &initY);
 	void initWalkGrid(uint8 screen, uint8 width);
 	bool calcWalkGrid(uint8 startX, uint8 startY, uint8 destX, uint8 destY);
+#ifndef RELEASE_BUILD
+	bool calcWalkGridReference(uint8 startX, uint8 startY, uint8 destX, uint8 destY);
+#endif
+	uint16 walkKey(uint16 pos);
+	bool inWalkRoi(uint16 pos, uint16 roiStart, uint8 roiX, uint8 roiY);
+	void pushWalkKey(uint16 key);
+	uint16 popWalkKey();
 	uint16 *makeRouteData(uint8 startX, uint8 startY, uint8 destX, uint8 destY);
 	uint16 *checkInitMove(uint16 *data, int16 initStaX);
 	Grid *_grid;
 	SkyCompact *_skyCompact;
 	uint16 *_routeGrid;
 	uint16 *_routeBuf;
+
+	// state of the calcWalkGrid() wavefront
+	int16 _walkDirX, _walkDirY;
+	uint16 _walkPass;
+	uint16 *_walkHeap;      // blocks to fill in this pass, ordered by walkKey()
+	uint16 _walkHeapSize;
+	uint16 *_walkFrontier;  // blocks that can only be filled in the next pass
+	uint16 _walkFrontierSize;
+	uint16 *_walkHeapMark, *_walkFrontierMark; // pass in which a block was queued
 	static const int16 _routeDirections[4];
 	static const uint16 _logicCommands[4];
 };
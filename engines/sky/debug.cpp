@@ -23,6 +23,7 @@
 #include "common/debug.h"
 #include "common/util.h"
 
+#include "sky/autoroute.h"
 #include "sky/debug.h"
 #include "sky/grid.h"
 #include "sky/logic.h"
@@ -1094,6 +1095,9 @@ Debugger::Debugger(Logic *logic, Mouse *mouse, Screen *screen, SkyCompact *skyCo
 	registerCmd("scriptvar",  WRAP_METHOD(Debugger, Cmd_ScriptVar));
 	registerCmd("section",    WRAP_METHOD(Debugger, Cmd_Section));
 	registerCmd("logiclist",  WRAP_METHOD(Debugger, Cmd_LogicList));
+#ifndef RELEASE_BUILD
+	registerCmd("routecheck", WRAP_METHOD(Debugger, Cmd_RouteCheck));
+#endif
 }
 
 void Debugger::preEnter() {
@@ -1350,4 +1354,24 @@ bool Debugger::Cmd_LogicList(int argc, const char **argv) {
 	return true;
 }
 
+#ifndef RELEASE_BUILD
+bool Debugger::Cmd_RouteCheck(int argc, const char **argv) {
+	uint32 routesPerScreen = 200;
+	if (argc > 1) {
+		if (argc > 2 || !isNumeric(argv[1]) || !atoi(argv[1])) {
+			debugPrintf("Example: %s 200\n", argv[0]);
+			debugPrintf("compares the autoroute wavefront with the original grid scan for 200 routes per screen\n");
+			return true;
+		}
+		routesPerScreen = atoi(argv[1]);
+	}
+
+	uint32 numRoutes, referenceTime, time;
+	bool identical = _logic->_skyAutoRoute->checkRoutes(routesPerScreen, numRoutes, referenceTime, time);
+	debugPrintf("%d routes, grid scan %d ms, wavefront %d ms, routes %s\n",
+	            numRoutes, referenceTime, time, identical ? "identical" : "DIFFERENT");
+	return true;
+}
+#endif
+
 } // End of namespace Sky
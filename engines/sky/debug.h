@@ -51,6 +51,9 @@ private:
 	bool Cmd_ScriptVar(int argc, const char **argv);
 	bool Cmd_Section(int argc, const char **argv);
 	bool Cmd_LogicList(int argc, const char **argv);
+#ifndef RELEASE_BUILD
+	bool Cmd_RouteCheck(int argc, const char **argv);
+#endif
 
 	void dumpCompact(uint16 cptId);
 
@@ -257,4 +257,8 @@ uint8 *Grid::giveGrid(uint32 pScreen) {
 	return 0;
 }
 
+uint32 Grid::giveNoScreens() {
+	return ARRAYSIZE(_gridConvertTable);
+}
+
 } // End of namespace Sky
@@ -49,6 +49,7 @@ public:
 	// same here, it's basically the same as removeObjectFromWalk
 	void removeGrid(uint32 x, uint32 y, uint32 width, Compact *cpt);
 	uint8 *giveGrid(uint32 pScreen);
+	uint32 giveNoScreens();
 
 private:
 	void objectToWalk(uint8 gridIdx, uint32 bitNum, uint32 width);
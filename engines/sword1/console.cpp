@@ -22,6 +22,10 @@
 #include "sword1/console.h"
 #include "sword1/sword1.h"
 #include "sword1/sound.h"
+#include "sword1/logic.h"
+#include "sword1/router.h"
+#include "sword1/resman.h"
+#include "sword1/screen.h"
 #include "common/config-manager.h"
 #include "common/str.h"
 
@@ -31,6 +35,9 @@ SwordConsole::SwordConsole(SwordEngine *vm) : GUI::Debugger(), _vm(vm) {
 	assert(_vm);
 	if (_vm->isMac())
 		registerCmd("speechEndianness",    WRAP_METHOD(SwordConsole, Cmd_SpeechEndianness));
+	registerCmd("routeCheck",    WRAP_METHOD(SwordConsole, Cmd_RouteCheck));
+	registerCmd("resCache",      WRAP_METHOD(SwordConsole, Cmd_ResCache));
+	registerCmd("roomWalk",      WRAP_METHOD(SwordConsole, Cmd_RoomWalk));
 }
 
 SwordConsole::~SwordConsole() {
@@ -54,4 +61,72 @@ bool SwordConsole::Cmd_SpeechEndianness(int argc, const char **argv) {
 	return true;
 }
 
+bool SwordConsole::Cmd_RouteCheck(int argc, const char **argv) {
+	Router *router = _vm->_logic->_router;
+
+	if (argc == 2 && (!strcmp(argv[1], "on") || !strcmp(argv[1], "off"))) {
+		router->setRecordRoutes(!strcmp(argv[1], "on"));
+		debugPrintf("Route recording %s\n", router->getRecordRoutes() ? "on" : "off");
+		return true;
+	}
+
+	if (argc > 2) {
+		debugPrintf("Replays the recorded routes of every location, plus <targets> random ones\n");
+		debugPrintf("with and without the walk grid caches and compares the walks\n");
+		debugPrintf("Routes are only recorded after \"%s on\"\n", argv[0]);
+		debugPrintf("Usage: %s [on | off | <targets>]\n", argv[0]);
+		return true;
+	}
+
+	if (!router->getRecordRoutes()) {
+		debugPrintf("Route recording is off, use \"%s on\" and walk around first\n", argv[0]);
+		return true;
+	}
+
+	uint extraTargets = (argc == 2) ? atoi(argv[1]) : 20;
+	uint numRoutes;
+	uint32 referenceTime, cachedTime;
+	bool identical = router->checkRecordedRoutes(extraTargets, numRoutes, referenceTime, cachedTime);
+
+	debugPrintf("%d routes, original router %d ms, cached walk grid %d ms, walks %s\n",
+	            numRoutes, referenceTime, cachedTime, identical ? "identical" : "DIFFERENT");
+	return true;
+}
+
+bool SwordConsole::Cmd_ResCache(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Shows the resource cache usage, or sets its budget\n");
+		debugPrintf("Usage: %s [<budget KB>]\n", argv[0]);
+		return true;
+	}
+
+	if (argc == 2)
+		_vm->_resMan->setCacheBudget(atoi(argv[1]) * 1024);
+
+	debugPrintf("Resource cache: %d KB of %d KB used, %d hits, %d misses\n",
+	            _vm->_resMan->getCacheUsage() / 1024, _vm->_resMan->getCacheBudget() / 1024,
+	            _vm->_resMan->getCacheHits(), _vm->_resMan->getCacheMisses());
+	return true;
+}
+
+bool SwordConsole::Cmd_RoomWalk(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Walks through all rooms and back, loading their backgrounds, once with the\n");
+		debugPrintf("original 6 MB cache and once with <budget KB> (default: the current budget)\n");
+		debugPrintf("and the next room prefetched, and reports the load stalls\n");
+		debugPrintf("Usage: %s [<budget KB>]\n", argv[0]);
+		return true;
+	}
+
+	const uint32 budgets[2] = { 6 * 1024 * 1024, (argc == 2) ? (uint32)atoi(argv[1]) * 1024 : _vm->_resMan->getCacheBudget() };
+	for (int pass = 0; pass < 2; pass++) {
+		uint32 rooms, stallTime, maxStall, prefetchTime;
+		_vm->_screen->benchmarkRoomWalk(budgets[pass], pass == 1, rooms, stallTime, maxStall, prefetchTime);
+		debugPrintf("%s, %d KB: %d rooms, stalls %d ms (max %d ms), prefetch %d ms, %d hits, %d misses\n",
+		            pass ? "Prefetch" : "Original", budgets[pass] / 1024, rooms, stallTime, maxStall, prefetchTime,
+		            _vm->_resMan->getCacheHits(), _vm->_resMan->getCacheMisses());
+	}
+	return true;
+}
+
 } // End of namespace Sword
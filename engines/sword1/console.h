@@ -36,6 +36,9 @@ public:
 private:
 	SwordEngine *_vm;
 	bool Cmd_SpeechEndianness(int argc, const char **argv);
+	bool Cmd_RouteCheck(int argc, const char **argv);
+	bool Cmd_ResCache(int argc, const char **argv);
+	bool Cmd_RoomWalk(int argc, const char **argv);
 };
 
 } // End of namespace Sword1
@@ -28,7 +28,9 @@ namespace Sword1 {
 
 MemMan::MemMan() {
 	_alloced = 0;
+	_budget = MAX_ALLOC;
 	_memListFree = _memListFreeEnd = nullptr;
+	_memListConverted = _memListConvertedEnd = nullptr;
 }
 
 MemMan::~MemMan() {
@@ -53,12 +55,8 @@ void MemMan::alloc(MemHandle *bsMem, uint32 pSize, uint16 pCond) {
 }
 
 void MemMan::freeNow(MemHandle *bsMem) {
-	if (bsMem->cond != MEM_FREED) {
-		_alloced -= bsMem->size;
-		removeFromFreeList(bsMem);
-		free(bsMem->data);
-		bsMem->cond = MEM_FREED;
-	}
+	if (bsMem->cond != MEM_FREED)
+		freeBlock(bsMem);
 }
 
 void MemMan::setCondition(MemHandle *bsMem, uint16 pCond) {
@@ -74,55 +72,67 @@ void MemMan::setCondition(MemHandle *bsMem, uint16 pCond) {
 }
 
 void MemMan::flush() {
-	while (_memListFree) {
-		if (_memListFreeEnd == nullptr) {
-			warning("MemMan::flush(): _memListFreeEnd is nullptr");
-			break;
-		}
-		free(_memListFreeEnd->data);
-		_memListFreeEnd->data = nullptr;
-		_memListFreeEnd->cond = MEM_FREED;
-		_alloced -= _memListFreeEnd->size;
-		removeFromFreeList(_memListFreeEnd);
-	}
-
+	purge();
 	if (_alloced)
 		warning("MemMan::flush: Something's wrong: still %d bytes alloced", _alloced);
 }
 
+void MemMan::purge() {
+	while (MemHandle *bsMem = leastRecentlyUsed())
+		freeBlock(bsMem);
+}
+
+void MemMan::setBudget(uint32 budget) {
+	_budget = MAX<uint32>(budget, MIN_ALLOC);
+	checkMemoryUsage();
+}
+
 void MemMan::checkMemoryUsage() {
-	while ((_alloced > MAX_ALLOC) && _memListFree) {
-		if (_memListFreeEnd == nullptr) {
-			warning("MemMan::checkMemoryUsage(): _memListFreeEnd is nullptr");
+	while (_alloced > _budget) {
+		MemHandle *bsMem = leastRecentlyUsed();
+		if (!bsMem)
 			break;
-		}
-		free(_memListFreeEnd->data);
-		_memListFreeEnd->data = nullptr;
-		_memListFreeEnd->cond = MEM_FREED;
-		_alloced -= _memListFreeEnd->size;
-		removeFromFreeList(_memListFreeEnd);
+		freeBlock(bsMem);
 	}
 }
 
+MemHandle *MemMan::leastRecentlyUsed() {
+	// byte swapped resources are more expensive to reload, so they go last
+	return _memListFreeEnd ? _memListFreeEnd : _memListConvertedEnd;
+}
+
+void MemMan::freeBlock(MemHandle *bsMem) {
+	removeFromFreeList(bsMem);
+	free(bsMem->data);
+	bsMem->data = nullptr;
+	bsMem->cond = MEM_FREED;
+	bsMem->converted = false;
+	_alloced -= bsMem->size;
+}
+
 void MemMan::addToFreeList(MemHandle *bsMem) {
 	if (bsMem->next || bsMem->prev) {
 		warning("addToFreeList: mem block is already in freeList");
 		return;
 	}
+	MemHandle *&start = bsMem->converted ? _memListConverted : _memListFree;
+	MemHandle *&end = bsMem->converted ? _memListConvertedEnd : _memListFreeEnd;
 	bsMem->prev = nullptr;
-	bsMem->next = _memListFree;
+	bsMem->next = start;
 	if (bsMem->next)
 		bsMem->next->prev = bsMem;
-	_memListFree = bsMem;
-	if (!_memListFreeEnd)
-		_memListFreeEnd = _memListFree;
+	start = bsMem;
+	if (!end)
+		end = start;
 }
 
 void MemMan::removeFromFreeList(MemHandle *bsMem) {
-	if (_memListFree == bsMem)
-		_memListFree = bsMem->next;
-	if (_memListFreeEnd == bsMem)
-		_memListFreeEnd = bsMem->prev;
+	MemHandle *&start = bsMem->converted ? _memListConverted : _memListFree;
+	MemHandle *&end = bsMem->converted ? _memListConvertedEnd : _memListFreeEnd;
+	if (start == bsMem)
+		start = bsMem->next;
+	if (end == bsMem)
+		end = bsMem->prev;
 
 	if (bsMem->next)
 		bsMem->next->prev = bsMem->prev;
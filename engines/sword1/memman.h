@@ -31,6 +31,7 @@ struct MemHandle {
 	uint32 size;
 	uint32 refCount;
 	uint16 cond;
+	bool converted; // data was byte swapped after loading, reloading it is more expensive
 	MemHandle *next, *prev;
 };
 // mem conditions:
@@ -38,7 +39,13 @@ struct MemHandle {
 #define MEM_CAN_FREE    1
 #define MEM_DONT_FREE   2
 
-#define MAX_ALLOC (6*1024*1024) // max amount of mem we want to alloc().
+// default amount of mem we want to alloc(), the resource_cache_kb setting overrides it
+#if defined(__LP64__) || defined(_WIN64)
+#define MAX_ALLOC (32*1024*1024) // 64 bit hosts can keep a few rooms cached
+#else
+#define MAX_ALLOC (6*1024*1024)
+#endif
+#define MIN_ALLOC (2*1024*1024)
 
 class MemMan {
 public:
@@ -49,13 +56,26 @@ public:
 	void freeNow(MemHandle *bsMem);
 	void initHandle(MemHandle *bsMem);
 	void flush();
+	void purge();
+	void setBudget(uint32 budget);
+	uint32 getBudget() const { return _budget; }
+	uint32 getAlloced() const { return _alloced; }
+	bool canCache(uint32 pSize) const { return _alloced + pSize <= _budget; }
 private:
 	void addToFreeList(MemHandle *bsMem);
 	void removeFromFreeList(MemHandle *bsMem);
+	MemHandle *leastRecentlyUsed();
+	void freeBlock(MemHandle *bsMem);
 	void checkMemoryUsage();
 	uint32 _alloced;  //currently allocated memory
+	uint32 _budget;   //amount of memory we keep before freeing MEM_CAN_FREE blocks
+	// Both lists are kept in least recently released order, the tail being the
+	// block that was closed first. Converted blocks are only freed once the
+	// plain list is empty.
 	MemHandle *_memListFree;
 	MemHandle *_memListFreeEnd;
+	MemHandle *_memListConverted;
+	MemHandle *_memListConvertedEnd;
 };
 
 } // End of namespace Sword1
@@ -274,6 +274,7 @@ void ResMan::resOpen(uint32 id) {  // load resource ID into memory
 	if (!memHandle)
 		return;
 	if (memHandle->cond == MEM_FREED) { // memory has been freed
+		_cacheMisses++;
 		if (id == GAME_FONT && _isKorTrs) {
 			// Load Korean Font
 			uint32 size = resLength(id);
@@ -307,8 +308,10 @@ void ResMan::resOpen(uint32 id) {  // load resource ID into memory
 				error("Can't read %d bytes from offset %d from cluster file %s\nResource ID: %d (%08X)", size, resOffset(id), _prj.clu[(id >> 24) - 1].label, id, id);
 			}
 		}
-	} else
+	} else {
+		_cacheHits++;
 		_memMan->setCondition(memHandle, MEM_DONT_FREE);
+	}
 
 	memHandle->refCount++;
 	if (memHandle->refCount > 20) {
@@ -330,6 +333,33 @@ void ResMan::resClose(uint32 id) {
 	}
 }
 
+bool ResMan::prefetchRes(uint32 id) {
+	// Loads a resource and releases it right away, so it's waiting in the
+	// cache when it's really needed. Nothing is read if that would push
+	// other cached resources out.
+	// Compacts and scripts must not be prefetched: they're byte swapped by
+	// cptResOpen() and lockScript() only when they're read from disk.
+	MemHandle *memHandle = resHandle(id);
+	if (!memHandle || memHandle->cond == MEM_DONT_FREE)
+		return false;
+	bool load = (memHandle->cond == MEM_FREED);
+	if (load && !_memMan->canCache(resLength(id)))
+		return false;
+	resOpen(id); // also moves an already cached resource to the front of the LRU list
+	resClose(id);
+	return load;
+}
+
+void ResMan::purgeCache() {
+	Common::StackLock lock(_resourceAccessMutex);
+	_memMan->purge();
+}
+
+void ResMan::setCacheBudget(uint32 budget) {
+	Common::StackLock lock(_resourceAccessMutex);
+	_memMan->setBudget(budget);
+}
+
 FrameHeader *ResMan::fetchFrame(void *resourceData, uint32 frameNo) {
 	uint8 *frameFile = (uint8 *)resourceData;
 	uint8 *idxData = frameFile + sizeof(Header);
@@ -450,6 +480,7 @@ void ResMan::openCptResourceBigEndian(uint32 id) {
 			*data = READ_LE_UINT32(data);
 			data++;
 		}
+		handle->converted = true;
 	}
 }
 
@@ -478,6 +509,7 @@ void ResMan::openCptResourceLittleEndian(uint32 id) {
 			*data = READ_BE_UINT32(data);
 			data++;
 		}
+		handle->converted = true;
 	}
 }
 
@@ -510,6 +542,7 @@ void ResMan::openScriptResourceBigEndian(uint32 id) {
 			*data = READ_LE_UINT32(data);
 			data++;
 		}
+		handle->converted = true;
 	}
 }
 
@@ -542,6 +575,7 @@ void ResMan::openScriptResourceLittleEndian(uint32 id) {
 			*data = READ_BE_UINT32(data);
 			data++;
 		}
+		handle->converted = true;
 	}
 }
 
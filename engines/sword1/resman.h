@@ -77,6 +77,15 @@ public:
 	void unlockScript(uint32 scrID);
 	FrameHeader *fetchFrame(void *resourceData, uint32 frameNo);
 
+	bool prefetchRes(uint32 id);
+	void purgeCache();
+	void setCacheBudget(uint32 budget);
+	uint32 getCacheBudget() { return _memMan->getBudget(); }
+	uint32 getCacheUsage() { return _memMan->getAlloced(); }
+	void resetCacheStats() { _cacheHits = _cacheMisses = 0; }
+	uint32 getCacheHits() { return _cacheHits; }
+	uint32 getCacheMisses() { return _cacheMisses; }
+
 	uint16 getUint16(uint16 value) {
 		return (_isBigEndian) ? FROM_BE_16(value) : FROM_LE_16(value);
 	}
@@ -127,6 +136,8 @@ private:
 	int  _openClus;
 	bool _isBigEndian;
 	bool _isKorTrs = false;
+	uint32 _cacheHits = 0;   // resOpen() calls that found the resource in memory
+	uint32 _cacheMisses = 0; // resOpen() calls that had to read from the cluster file
 
 	Common::Mutex _resourceAccessMutex;
 
@@ -22,6 +22,8 @@
 #ifndef SWORD1_ROUTER_H
 #define SWORD1_ROUTER_H
 
+#include "common/array.h"
+
 #include "sword1/object.h"
 
 namespace Sword1 {
@@ -100,6 +102,11 @@ public:
 	int32 _nBars;
 	int32 _nNodes;
 
+	// Route recording for checkRecordedRoutes(), off by default
+	void setRecordRoutes(bool record);
+	bool getRecordRoutes() const { return _recordRoutes; }
+	bool checkRecordedRoutes(uint extraTargets, uint &numRoutes, uint32 &referenceTime, uint32 &cachedTime);
+
 private:
 	// when the player collides with another mega, we'll receive a ReRouteRequest here.
 	// that's why we need to remember the player's target coordinates
@@ -133,10 +140,63 @@ private:
 
 	bool        _slidyWalkAnimatorState;
 
+	// The walk grid the caches below were made for
+	bool        _gridCacheValid;
+	BarData     _gridBars[O_GRID_SIZE];
+	int16       _gridNodeX[O_GRID_SIZE];
+	int16       _gridNodeY[O_GRID_SIZE];
+	int32       _gridNBars, _gridNNodes;
+	int32       _gridDiagonalX, _gridDiagonalY;
+
+	// Result of newCheck() between the fixed nodes of the walk grid,
+	// filled in as the routes ask for it
+	enum {
+		kVisibilityUnknown = 0,
+		kVisibilityBlocked = 1,
+		kVisibilityClear = 2
+	};
+	uint8       _nodeVisibility[O_GRID_SIZE * O_GRID_SIZE];
+
+	// Uniform grid of the bars, so the line checks only test nearby bars
+	enum {
+		kBarCellShift = 6
+	};
+	int32       _barGridX, _barGridY, _barGridW, _barGridH;
+	Common::Array<uint32> _barCellStart;
+	Common::Array<uint8> _barCellBars;
+	uint16      _barStamp[O_GRID_SIZE];
+	uint16      _barStampValue;
+	uint8       _barCandidates[O_GRID_SIZE];
+	int32       _numBarCandidates;
+
+	// Disables both caches, to compare against the original router
+	bool        _useGridCache;
+
+	// Inputs of the latest routes of every location, for checkRecordedRoutes().
+	// Only the mega fields LoadWalkResources() reads are kept.
+	struct RouteRecord {
+		int32 id;
+		int32 place, megaResource;
+		int32 startX, startY, startDir;
+		int32 scaleA, scaleB;
+		int32 x, y, dir;
+	};
+	enum {
+		kMaxRouteRecords = 32
+	};
+	bool        _recordRoutes;
+	RouteRecord _routeRecords[kMaxRouteRecords];
+	uint        _numRouteRecords, _nextRouteRecord;
+
 	int32 LoadWalkResources(Object *mega, int32 x, int32 y, int32 dir);
 	int32 getRoute();
 	int32 checkTarget(int32 x, int32 y);
 
+	void prepareGridCache();
+	void findBars(int32 xmin, int32 ymin, int32 xmax, int32 ymax);
+	bool nodesVisible(int32 i, int32 j);
+	void recordRoute(int32 id, Object *mega, int32 x, int32 y, int32 dir);
+
 	bool scan(int32 level);
 	int32 newCheck(int32 status, int32 x1, int32 x2, int32 y1, int32 y2);
 	bool check(int32 x1, int32 y1, int32 x2, int32 y2);
@@ -20,6 +20,7 @@
  */
 
 
+#include "common/array.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "common/util.h"
@@ -547,6 +548,92 @@ void Screen::quitScreen() {
 	_currentScreen = 0xFFFF;
 }
 
+uint Screen::getRoomResources(uint32 screen, uint32 *ids) {
+	// everything newScreen() and the palette fade load for a room
+	const RoomDef &room = _roomDefTable[screen];
+	uint numIds = 0;
+	for (int cnt = 0; cnt < room.totalLayers; cnt++)
+		ids[numIds++] = room.layers[cnt];
+	for (int cnt = 0; cnt < room.totalLayers - 1; cnt++)
+		ids[numIds++] = room.grids[cnt];
+	for (int cnt = 0; cnt < 2; cnt++)
+		if (room.palettes[cnt])
+			ids[numIds++] = room.palettes[cnt];
+	for (int cnt = 0; cnt < 2; cnt++)
+		if (room.parallax[cnt])
+			ids[numIds++] = room.parallax[cnt];
+	return numIds;
+}
+
+void Screen::prefetchScreen(uint32 screen) {
+	// Called while the current room fades down: reads the next room's
+	// backgrounds and the sprites of the objects waiting there into the
+	// resource cache, so newScreen() and the first frames don't stall on disk.
+	if (screen >= TOTAL_ROOMS || screen == _currentScreen)
+		return;
+
+	uint32 ids[11];
+	uint numIds = getRoomResources(screen, ids);
+	for (uint cnt = 0; cnt < numIds; cnt++)
+		_resMan->prefetchRes(ids[cnt]);
+
+	for (uint16 sectCnt = 0; sectCnt < TOTAL_SECTIONS; sectCnt++) {
+		if (!_objMan->sectionAlive(sectCnt))
+			continue;
+		uint32 numCpts = _objMan->fetchNoObjects(sectCnt);
+		for (uint32 cptCnt = 0; cptCnt < numCpts; cptCnt++) {
+			Object *compact = _objMan->fetchObject(sectCnt * ITM_PER_SEC + cptCnt);
+			if ((uint32)compact->o_screen == screen && (compact->o_status & (STAT_FORE | STAT_SORT | STAT_BACK)) &&
+			    compact->o_type != TYPE_TEXT && compact->o_resource)
+				_resMan->prefetchRes(compact->o_resource);
+		}
+	}
+}
+
+void Screen::benchmarkRoomWalk(uint32 budget, bool prefetch, uint32 &rooms, uint32 &stallTime, uint32 &maxStall, uint32 &prefetchTime) {
+	// Walks through all rooms and back again, starting with an empty cache,
+	// and measures how long opening each room's resources takes. With
+	// prefetch, the next room is read while the current one is still open,
+	// as it happens during the fade down in the main loop.
+	Common::Array<uint32> walk;
+	for (uint32 screen = 1; screen < TOTAL_ROOMS; screen++)
+		if (_roomDefTable[screen].totalLayers)
+			walk.push_back(screen);
+	for (int cnt = (int)walk.size() - 2; cnt >= 0; cnt--)
+		walk.push_back(walk[cnt]);
+
+	uint32 oldBudget = _resMan->getCacheBudget();
+	_resMan->setCacheBudget(budget);
+	_resMan->purgeCache();
+	_resMan->resetCacheStats();
+
+	uint32 ids[11], nextIds[11];
+	rooms = walk.size();
+	stallTime = maxStall = prefetchTime = 0;
+	for (uint cnt = 0; cnt < walk.size(); cnt++) {
+		uint32 startTime = _system->getMillis();
+		uint numIds = getRoomResources(walk[cnt], ids);
+		for (uint idCnt = 0; idCnt < numIds; idCnt++)
+			_resMan->resOpen(ids[idCnt]);
+		uint32 stall = _system->getMillis() - startTime;
+		stallTime += stall;
+		maxStall = MAX(maxStall, stall);
+
+		if (prefetch && cnt + 1 < walk.size()) {
+			startTime = _system->getMillis();
+			uint numNextIds = getRoomResources(walk[cnt + 1], nextIds);
+			for (uint idCnt = 0; idCnt < numNextIds; idCnt++)
+				_resMan->prefetchRes(nextIds[idCnt]);
+			prefetchTime += _system->getMillis() - startTime;
+		}
+
+		for (uint idCnt = 0; idCnt < numIds; idCnt++)
+			_resMan->resClose(ids[idCnt]);
+	}
+
+	_resMan->setCacheBudget(oldBudget);
+}
+
 void Screen::draw() {
 	uint8 cnt;
 
@@ -84,6 +84,8 @@ public:
 
 	void quitScreen();
 	void newScreen(uint32 screen);
+	void prefetchScreen(uint32 screen);
+	void benchmarkRoomWalk(uint32 budget, bool prefetch, uint32 &rooms, uint32 &stallTime, uint32 &maxStall, uint32 &prefetchTime);
 
 	void setScrolling(int16 offsetX, int16 offsetY);
 	void addToGraphicList(uint8 listId, uint32 objId);
@@ -116,6 +118,8 @@ public:
 	Common::Mutex _screenAccessMutex; // To coordinate actions between the main thread and the palette fade thread
 
 private:
+	uint getRoomResources(uint32 screen, uint32 *ids);
+
 	// The original values are 6-bit RGB numbers, so they have to be shifted,
 	// except for white, which for some reason has to stay unshifted in order
 	// to work correctly.
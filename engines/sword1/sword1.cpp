@@ -95,6 +95,9 @@ Common::Error SwordEngine::init() {
 	debug(5, "Starting resource manager");
 	_resMan = new ResMan("swordres.rif", _systemVars.platform == Common::kPlatformMacintosh,
 		Common::parseLanguage(ConfMan.get("language")) == Common::KO_KOR);
+	// The default budget depends on the host, see MAX_ALLOC
+	if (ConfMan.hasKey("resource_cache_kb"))
+		_resMan->setCacheBudget(ConfMan.getInt("resource_cache_kb") * 1024);
 	debug(5, "Starting object manager");
 	_objectMan = new ObjectMan(_resMan);
 	_mouse = new Mouse(_system, _resMan, _objectMan);
@@ -1043,6 +1046,8 @@ uint8 SwordEngine::mainLoop() {
 			startFadePaletteDown(1);
 		}
 
+		if ((_systemVars.saveGameFlag == SGF_DONE || _systemVars.saveGameFlag == SGF_SAVE) && !shouldQuit())
+			_screen->prefetchScreen(Logic::_scriptVars[NEW_SCREEN]); // read the next room while fading down
 		_screen->quitScreen(); // Close graphic resources
 		waitForFade();
 
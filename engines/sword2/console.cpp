@@ -35,6 +35,7 @@
 #include "sword2/memory.h"
 #include "sword2/mouse.h"
 #include "sword2/resman.h"
+#include "sword2/router.h"
 #include "sword2/screen.h"
 #include "sword2/sound.h"
 
@@ -120,6 +121,11 @@ Debugger::Debugger(Sword2Engine *vm)
 	registerCmd("finnish",  WRAP_METHOD(Debugger, Cmd_Finnish));
 	registerCmd("polish",   WRAP_METHOD(Debugger, Cmd_Polish));
 	registerCmd("fxq",      WRAP_METHOD(Debugger, Cmd_FxQueue));
+	registerCmd("routecheck", WRAP_METHOD(Debugger, Cmd_RouteCheck));
+#ifndef RELEASE_BUILD
+	registerCmd("scalecheck", WRAP_METHOD(Debugger, Cmd_ScaleCheck));
+#endif
+	registerCmd("spritecache", WRAP_METHOD(Debugger, Cmd_SpriteCache));
 }
 
 void Debugger::varGet(int var) {
@@ -800,4 +806,77 @@ bool Debugger::Cmd_FxQueue(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::Cmd_RouteCheck(int argc, const char **argv) {
+	Router *router = _vm->_logic->_router;
+
+	if (argc == 2 && (!strcmp(argv[1], "on") || !strcmp(argv[1], "off"))) {
+		router->setRecordRoutes(!strcmp(argv[1], "on"));
+		debugPrintf("Route recording %s\n", router->getRecordRoutes() ? "on" : "off");
+		return true;
+	}
+
+	if (argc > 2) {
+		debugPrintf("Replays the recorded routes of every location, plus <targets> random ones\n");
+		debugPrintf("with and without the walk grid caches and compares the walks\n");
+		debugPrintf("Routes are only recorded after \"%s on\"\n", argv[0]);
+		debugPrintf("Usage: %s [on | off | <targets>]\n", argv[0]);
+		return true;
+	}
+
+	if (!router->getRecordRoutes()) {
+		debugPrintf("Route recording is off, use \"%s on\" and walk around first\n", argv[0]);
+		return true;
+	}
+
+	uint extraTargets = (argc == 2) ? atoi(argv[1]) : 20;
+	uint numRoutes;
+	uint32 referenceTime, cachedTime;
+	bool identical = router->checkRecordedRoutes(extraTargets, numRoutes, referenceTime, cachedTime);
+
+	debugPrintf("%d routes, original router %d ms, cached walk grid %d ms, walks %s\n",
+	            numRoutes, referenceTime, cachedTime, identical ? "identical" : "DIFFERENT");
+	return true;
+}
+
+#ifndef RELEASE_BUILD
+bool Debugger::Cmd_ScaleCheck(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Scales <sprites> random sprites with the original and the current scaler\n");
+		debugPrintf("and compares them\n");
+		debugPrintf("Usage: %s [<sprites>]\n", argv[0]);
+		return true;
+	}
+
+	uint tests = (argc == 2) ? atoi(argv[1]) : 200;
+	uint32 referenceTime, genericTime, time;
+	bool identical = _vm->_screen->checkScaler(tests, referenceTime, genericTime, time);
+
+	debugPrintf("%d sprites, original scaler %d ms, blend table %d ms, vectorized %d ms, results %s\n",
+	            tests, referenceTime, genericTime, time, identical ? "identical" : "DIFFERENT");
+	debugPrintf("Scaled sprite cache: %d hits, %d misses\n", _vm->_screen->getScaledFrameHits(), _vm->_screen->getScaledFrameMisses());
+	return true;
+}
+#endif
+
+bool Debugger::Cmd_SpriteCache(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Shows the decoded sprite cache, and times decoding its sprites again\n");
+		debugPrintf("Usage: %s [<budget KB>]\n", argv[0]);
+		return true;
+	}
+
+	if (argc == 2)
+		_vm->_screen->setDecodedSpritesBudget(atoi(argv[1]) * 1024);
+
+	uint numSprites;
+	uint32 decodeTime, cachedTime;
+	bool identical = _vm->_screen->benchmarkSpriteDecoding(numSprites, decodeTime, cachedTime);
+
+	debugPrintf("Decoded sprites: %d, %d KB of %d KB used\n", numSprites,
+	            _vm->_screen->getDecodedSpritesSize() / 1024, _vm->_screen->getDecodedSpritesBudget() / 1024);
+	debugPrintf("%d hits, %d misses\n", _vm->_screen->getDecodedSpriteHits(), _vm->_screen->getDecodedSpriteMisses());
+	debugPrintf("Decode: %d ms, cache: %d ms, sprites %s\n", decodeTime, cachedTime, identical ? "identical" : "DIFFERENT");
+	return true;
+}
+
 } // End of namespace Sword2
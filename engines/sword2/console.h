@@ -122,6 +122,11 @@ private:
 	bool Cmd_Finnish(int argc, const char **argv);
 	bool Cmd_Polish(int argc, const char **argv);
 	bool Cmd_FxQueue(int argc, const char **argv);
+	bool Cmd_RouteCheck(int argc, const char **argv);
+#ifndef RELEASE_BUILD
+	bool Cmd_ScaleCheck(int argc, const char **argv);
+#endif
+	bool Cmd_SpriteCache(int argc, const char **argv);
 };
 
 } // End of namespace Sword2
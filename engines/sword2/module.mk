@@ -35,6 +35,17 @@ MODULE_OBJS := \
 	sync.o \
 	walker.o
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	render_neon.o
+$(MODULE)/render_neon.o: CXXFLAGS += $(NEON_CXXFLAGS)
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	render_sse2.o
+$(MODULE)/render_sse2.o: CXXFLAGS += -msse2
+endif
+
 # This module can be built as a plugin
 ifeq ($(ENABLE_SWORD2), DYNAMIC_PLUGIN)
 PLUGIN := 1
@@ -49,8 +49,10 @@ void Screen::startNewPalette() {
 
 	// Don't fetch palette match table while using PSX version,
 	// because it is not present.
-	if (!Sword2Engine::isPsx())
+	if (!Sword2Engine::isPsx()) {
 		memcpy(_paletteMatch, _vm->fetchPaletteMatchTable(screenFile), PALTABLESIZE);
+		invalidateScaledFrames();
+	}
 
 	_vm->fetchPalette(screenFile, _palette);
 	setPalette(0, 256, _palette, RDPAL_FADE);
@@ -128,8 +130,10 @@ void Screen::setFullPalette(int32 palRes) {
 
 			// Do not fetch palette match table when using PSX version,
 			// because it is not present.
-			if (!Sword2Engine::isPsx())
+			if (!Sword2Engine::isPsx()) {
 				memcpy(_paletteMatch, _vm->fetchPaletteMatchTable(data), PALTABLESIZE);
+				invalidateScaledFrames();
+			}
 
 			_vm->fetchPalette(data, _palette);
 			setPalette(0, 256, _palette, RDPAL_INSTANT);
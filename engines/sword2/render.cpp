@@ -23,6 +23,7 @@
 
 
 #include "common/endian.h"
+#include "common/random.h"
 #include "common/system.h"
 
 #include "graphics/primitives.h"
@@ -108,6 +109,127 @@ void Screen::scaleImageFast(byte *dst, uint16 dstPitch, uint16 dstWidth, uint16
 }
 
 void Screen::scaleImageGood(byte *dst, uint16 dstPitch, uint16 dstWidth, uint16 dstHeight, byte *src, uint16 srcPitch, uint16 srcWidth, uint16 srcHeight, byte *backBuf, int16 bbXPos, int16 bbYPos) {
+	// Each pixel is a blend of the four source pixels around it, or the
+	// back buffer where they are transparent. The colors of the four
+	// pixels are gathered for a whole row, from a table of the palette,
+	// and then blended together.
+
+	for (int i = 0; i < 256; i++)
+		_paletteBlend[i] = _palette[i * 3 + 0] | (_palette[i * 3 + 1] << 8) | (_palette[i * 3 + 2] << 16);
+
+	for (int x = 0; x < dstWidth; x++) {
+		_xScale[x] = (x * srcWidth) / dstWidth;
+		_xFrac[x] = dstWidth - (x * srcWidth) % dstWidth;
+	}
+
+	uint32 *row1 = _blendRows[0];
+	uint32 *row2 = _blendRows[1];
+	uint32 *row3 = _blendRows[2];
+	uint32 *row4 = _blendRows[3];
+
+	for (int y = 0; y < dstHeight; y++) {
+		uint32 yPos = (y * srcHeight) / dstHeight;
+		uint16 yFrac = dstHeight - (y * srcHeight) % dstHeight;
+
+		byte *srcRow = src + yPos * srcPitch;
+		int bbY = bbYPos + y;
+
+		bool lastRow = (y == dstHeight - 1);
+		bool rowVisible = (bbY >= MENUDEEP && bbY < MENUDEEP + RENDERDEEP);
+		bool nextRowVisible = (bbY + 1 >= MENUDEEP && bbY + 1 < MENUDEEP + RENDERDEEP);
+		// The original checks this for the pixel to the right
+		bool rightRowVisible = (bbY >= MENUDEEP && bbY + 1 < MENUDEEP + RENDERDEEP);
+
+		for (int x = 0; x < dstWidth; x++) {
+			byte *srcPtr = srcRow + _xScale[x];
+			int bbX = bbXPos + x;
+
+			bool lastColumn = (x == dstWidth - 1);
+			bool columnVisible = (bbX >= 0 && bbX < RENDERWIDE);
+			bool nextColumnVisible = (bbX + 1 >= 0 && bbX + 1 < RENDERWIDE);
+			bool opaque = false;
+			uint8 c1, c2, c3, c4;
+
+			if (*srcPtr) {
+				c1 = *srcPtr;
+				opaque = true;
+			} else if (columnVisible && rowVisible)
+				c1 = backBuf[_screenWide * bbY + bbX];
+			else
+				c1 = 0;
+
+			if (lastColumn)
+				c2 = c1;
+			else if (*(srcPtr + 1)) {
+				c2 = *(srcPtr + 1);
+				opaque = true;
+			} else if (nextColumnVisible && rightRowVisible)
+				c2 = backBuf[_screenWide * bbY + bbX + 1];
+			else
+				c2 = c1;
+
+			// Note that the original reads the back buffer at the
+			// left edge of the sprite here.
+
+			if (lastRow)
+				c3 = c1;
+			else if (*(srcPtr + srcPitch)) {
+				c3 = *(srcPtr + srcPitch);
+				opaque = true;
+			} else if (columnVisible && nextRowVisible)
+				c3 = backBuf[_screenWide * (bbY + 1) + bbXPos];
+			else
+				c3 = c1;
+
+			if (lastColumn || lastRow)
+				c4 = c3;
+			else if (*(srcPtr + srcPitch + 1)) {
+				c4 = *(srcPtr + srcPitch + 1);
+				opaque = true;
+			} else if (nextColumnVisible && nextRowVisible)
+				c4 = backBuf[_screenWide * (bbY + 1) + bbX + 1];
+			else
+				c4 = c3;
+
+			row1[x] = _paletteBlend[c1];
+			row2[x] = _paletteBlend[c2];
+			row3[x] = _paletteBlend[c3];
+			row4[x] = _paletteBlend[c4];
+			_blendOpaque[x] = opaque;
+		}
+
+		_blendScaledRow(_blendMatch, row1, row2, row3, row4, _xFrac, dstWidth, yFrac, dstHeight, dstWidth);
+
+		for (int x = 0; x < dstWidth; x++)
+			dst[y * dstWidth + x] = _blendOpaque[x] ? _paletteMatch[_blendMatch[x]] : 0;
+	}
+}
+
+void blendScaledRow(uint32 *dst, const uint32 *c1, const uint32 *c2, const uint32 *c3, const uint32 *c4, const uint16 *xFrac, uint16 width, uint16 yFrac, uint16 height, uint count) {
+	for (uint x = 0; x < count; x++) {
+		uint32 r5 = ((c1[x] & 0xff) * xFrac[x] + (c2[x] & 0xff) * (width - xFrac[x])) / width;
+		uint32 g5 = (((c1[x] >> 8) & 0xff) * xFrac[x] + ((c2[x] >> 8) & 0xff) * (width - xFrac[x])) / width;
+		uint32 b5 = ((c1[x] >> 16) * xFrac[x] + (c2[x] >> 16) * (width - xFrac[x])) / width;
+
+		uint32 r6 = ((c3[x] & 0xff) * xFrac[x] + (c4[x] & 0xff) * (width - xFrac[x])) / width;
+		uint32 g6 = (((c3[x] >> 8) & 0xff) * xFrac[x] + ((c4[x] >> 8) & 0xff) * (width - xFrac[x])) / width;
+		uint32 b6 = ((c3[x] >> 16) * xFrac[x] + (c4[x] >> 16) * (width - xFrac[x])) / width;
+
+		uint32 r = (r5 * yFrac + r6 * (height - yFrac)) / height;
+		uint32 g = (g5 * yFrac + g6 * (height - yFrac)) / height;
+		uint32 b = (b5 * yFrac + b6 * (height - yFrac)) / height;
+
+		dst[x] = ((r >> 2) << 12) + ((g >> 2) << 6) + (b >> 2);
+	}
+}
+
+#ifndef RELEASE_BUILD
+/**
+ * The original, pixel by pixel, version of scaleImageGood(). It is only used
+ * to check the faster one against.
+ */
+
+void Screen::scaleImageGoodReference(byte *dst, uint16 dstWidth, uint16 dstHeight, byte *src, uint16 srcPitch, uint16 srcWidth, uint16 srcHeight, byte *backBuf, int16 bbXPos, int16 bbYPos) {
 	for (int y = 0; y < dstHeight; y++) {
 		for (int x = 0; x < dstWidth; x++) {
 			uint8 c1, c2, c3, c4;
@@ -224,6 +346,180 @@ void Screen::scaleImageGood(byte *dst, uint16 dstPitch, uint16 dstWidth, uint16
 		}
 	}
 }
+#endif
+
+/**
+ * The back buffer area that the "good" scaler reads for a scaled sprite.
+ */
+
+Common::Rect Screen::scaledFrameBackground(const ScaledFrame &frame) {
+	Common::Rect r(frame.bbXPos, frame.bbYPos, frame.bbXPos + frame.scaledWidth, frame.bbYPos + frame.scaledHeight);
+	r.clip(Common::Rect(0, MENUDEEP, RENDERWIDE, MENUDEEP + RENDERDEEP));
+	return r;
+}
+
+/**
+ * Looks for a sprite that was scaled from the same frame, at the same size
+ * and position, over the same background and with the same palette. This is
+ * mostly the case for megas standing still.
+ * @return true if it was found and copied to dst
+ */
+
+bool Screen::findScaledFrame(byte *dst, byte *sprite, uint16 w, uint16 h, uint16 scaledWidth, uint16 scaledHeight, int16 bbXPos, int16 bbYPos) {
+	for (int i = 0; i < MAX_SCALED_FRAMES; i++) {
+		ScaledFrame &frame = _scaledFrames[i];
+
+		if (!frame.scaled || frame.w != w || frame.h != h || frame.scaledWidth != scaledWidth || frame.scaledHeight != scaledHeight || frame.bbXPos != bbXPos || frame.bbYPos != bbYPos)
+			continue;
+
+		if (memcmp(frame.palette, _palette, sizeof(frame.palette)) || memcmp(frame.sprite, sprite, w * h))
+			continue;
+
+		Common::Rect r = scaledFrameBackground(frame);
+		byte *background = frame.background;
+		bool sameBackground = true;
+
+		for (int y = r.top; y < r.bottom && sameBackground; y++) {
+			sameBackground = !memcmp(background, _buffer + _screenWide * y + r.left, r.width());
+			background += r.width();
+		}
+
+		if (!sameBackground)
+			continue;
+
+		memcpy(dst, frame.scaled, scaledWidth * scaledHeight);
+		frame.lastUse = ++_scaledFrameUse;
+		_scaledFrameHits++;
+		return true;
+	}
+
+	_scaledFrameMisses++;
+	return false;
+}
+
+/**
+ * Keeps a scaled sprite in place of the one that was used least recently.
+ */
+
+void Screen::storeScaledFrame(byte *scaled, byte *sprite, uint16 w, uint16 h, uint16 scaledWidth, uint16 scaledHeight, int16 bbXPos, int16 bbYPos) {
+	ScaledFrame *frame = &_scaledFrames[0];
+
+	for (int i = 1; i < MAX_SCALED_FRAMES; i++) {
+		if (_scaledFrames[i].lastUse < frame->lastUse)
+			frame = &_scaledFrames[i];
+	}
+
+	frame->w = w;
+	frame->h = h;
+	frame->scaledWidth = scaledWidth;
+	frame->scaledHeight = scaledHeight;
+	frame->bbXPos = bbXPos;
+	frame->bbYPos = bbYPos;
+	frame->lastUse = ++_scaledFrameUse;
+
+	Common::Rect r = scaledFrameBackground(*frame);
+
+	frame->sprite = (byte *)realloc(frame->sprite, w * h);
+	frame->background = (byte *)realloc(frame->background, MAX<int>(r.width() * r.height(), 1));
+	frame->scaled = (byte *)realloc(frame->scaled, scaledWidth * scaledHeight);
+
+	if (!frame->sprite || !frame->background || !frame->scaled) {
+		invalidateScaledFrames();
+		return;
+	}
+
+	memcpy(frame->sprite, sprite, w * h);
+	memcpy(frame->scaled, scaled, scaledWidth * scaledHeight);
+	memcpy(frame->palette, _palette, sizeof(frame->palette));
+
+	byte *background = frame->background;
+
+	for (int y = r.top; y < r.bottom; y++) {
+		memcpy(background, _buffer + _screenWide * y + r.left, r.width());
+		background += r.width();
+	}
+}
+
+void Screen::invalidateScaledFrames() {
+	for (int i = 0; i < MAX_SCALED_FRAMES; i++) {
+		free(_scaledFrames[i].sprite);
+		free(_scaledFrames[i].background);
+		free(_scaledFrames[i].scaled);
+		_scaledFrames[i].sprite = nullptr;
+		_scaledFrames[i].background = nullptr;
+		_scaledFrames[i].scaled = nullptr;
+		_scaledFrames[i].lastUse = 0;
+	}
+}
+
+#ifndef RELEASE_BUILD
+/**
+ * Scales random sprites over a random back buffer with the original "good"
+ * scaler, the generic row blending and the one used on this CPU, and
+ * compares the results.
+ * @return true if all the scaled sprites are identical
+ */
+
+bool Screen::checkScaler(uint tests, uint32 &referenceTime, uint32 &genericTime, uint32 &time) {
+	Common::RandomSource rnd("sword2scaler");
+	BlendScaledRowProc blendProc = _blendScaledRow;
+	bool identical = true;
+
+	byte *backBuf = (byte *)malloc(_screenWide * _screenDeep);
+	byte *src = (byte *)malloc(SCALE_MAXWIDTH * (SCALE_MAXHEIGHT + 1) + 1);
+	byte *dst[3];
+
+	for (int i = 0; i < 3; i++)
+		dst[i] = (byte *)malloc(SCALE_MAXWIDTH * SCALE_MAXHEIGHT);
+
+	for (int i = 0; i < _screenWide * _screenDeep; i++)
+		backBuf[i] = rnd.getRandomNumber(255);
+
+	referenceTime = genericTime = time = 0;
+
+	for (uint test = 0; test < tests; test++) {
+		uint16 w = 1 + rnd.getRandomNumber(299);
+		uint16 h = 1 + rnd.getRandomNumber(299);
+		uint16 scale = 16 + rnd.getRandomNumber(496);
+		uint16 scaledWidth = CLIP<int>(w * scale / 256, 1, SCALE_MAXWIDTH);
+		uint16 scaledHeight = CLIP<int>(h * scale / 256, 1, SCALE_MAXHEIGHT);
+		int16 bbXPos = rnd.getRandomNumber(RENDERWIDE + scaledWidth) - scaledWidth;
+		int16 bbYPos = MENUDEEP + rnd.getRandomNumber(RENDERDEEP + scaledHeight) - scaledHeight;
+
+		// Sprites have runs of transparent pixels
+		memset(src, 0, SCALE_MAXWIDTH * (SCALE_MAXHEIGHT + 1) + 1);
+		for (int i = 0; i < w * h; i++) {
+			if (rnd.getRandomNumber(7) < 5)
+				src[i] = (i > 0 && rnd.getRandomBit()) ? src[i - 1] : rnd.getRandomNumber(255);
+		}
+
+		uint32 startTime = _vm->_system->getMillis();
+		scaleImageGoodReference(dst[0], scaledWidth, scaledHeight, src, w, w, h, backBuf, bbXPos, bbYPos);
+		referenceTime += _vm->_system->getMillis() - startTime;
+
+		_blendScaledRow = blendScaledRow;
+		startTime = _vm->_system->getMillis();
+		scaleImageGood(dst[1], scaledWidth, scaledWidth, scaledHeight, src, w, w, h, backBuf, bbXPos, bbYPos);
+		genericTime += _vm->_system->getMillis() - startTime;
+
+		_blendScaledRow = blendProc;
+		startTime = _vm->_system->getMillis();
+		scaleImageGood(dst[2], scaledWidth, scaledWidth, scaledHeight, src, w, w, h, backBuf, bbXPos, bbYPos);
+		time += _vm->_system->getMillis() - startTime;
+
+		if (memcmp(dst[0], dst[1], scaledWidth * scaledHeight) || memcmp(dst[0], dst[2], scaledWidth * scaledHeight)) {
+			debug(1, "Screen::checkScaler(): %dx%d sprite scaled to %dx%d at %d, %d differs", w, h, scaledWidth, scaledHeight, bbXPos, bbYPos);
+			identical = false;
+		}
+	}
+
+	for (int i = 0; i < 3; i++)
+		free(dst[i]);
+	free(src);
+	free(backBuf);
+	return identical;
+}
+#endif
 
 /**
  * Plots a point relative to the top left corner of the screen. This is only
@@ -0,0 +1,79 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "sword2/screen.h"
+
+#ifdef SCUMMVM_NEON
+
+#include <arm_neon.h>
+
+namespace Sword2 {
+
+// See render_sse2.cpp for why the blends are exact in single precision.
+
+static inline float32x4_t blendPair(float32x4_t a, float32x4_t b, float32x4_t aWeight, float32x4_t bWeight, float32x4_t half, float32x4_t scale) {
+	float32x4_t sum = vaddq_f32(vaddq_f32(vmulq_f32(a, aWeight), vmulq_f32(b, bWeight)), half);
+	return vcvtq_f32_u32(vcvtq_u32_f32(vmulq_f32(sum, scale)));
+}
+
+static inline float32x4_t channel(uint32x4_t c, int shift) {
+	return vcvtq_f32_u32(vandq_u32(vshlq_u32(c, vdupq_n_s32(-shift)), vdupq_n_u32(0xff)));
+}
+
+void blendScaledRowNEON(uint32 *dst, const uint32 *c1, const uint32 *c2, const uint32 *c3, const uint32 *c4, const uint16 *xFrac, uint16 width, uint16 yFrac, uint16 height, uint count) {
+	const uint32x4_t widthVec = vdupq_n_u32(width);
+	const float32x4_t half = vdupq_n_f32(0.5f);
+	const float32x4_t xScale = vdupq_n_f32(1.0f / width);
+	const float32x4_t yScale = vdupq_n_f32(1.0f / height);
+	const float32x4_t yWeight1 = vdupq_n_f32(yFrac);
+	const float32x4_t yWeight2 = vdupq_n_f32(height - yFrac);
+
+	uint x = 0;
+	for (; x + 4 <= count; x += 4) {
+		uint32x4_t frac = vmovl_u16(vld1_u16(xFrac + x));
+		float32x4_t xWeight1 = vcvtq_f32_u32(frac);
+		float32x4_t xWeight2 = vcvtq_f32_u32(vsubq_u32(widthVec, frac));
+
+		uint32x4_t p1 = vld1q_u32(c1 + x);
+		uint32x4_t p2 = vld1q_u32(c2 + x);
+		uint32x4_t p3 = vld1q_u32(c3 + x);
+		uint32x4_t p4 = vld1q_u32(c4 + x);
+
+		uint32x4_t match = vdupq_n_u32(0);
+		for (int shift = 0; shift < 24; shift += 8) {
+			float32x4_t top = blendPair(channel(p1, shift), channel(p2, shift), xWeight1, xWeight2, half, xScale);
+			float32x4_t bottom = blendPair(channel(p3, shift), channel(p4, shift), xWeight1, xWeight2, half, xScale);
+			uint32x4_t c = vcvtq_u32_f32(vmulq_f32(vaddq_f32(vaddq_f32(vmulq_f32(top, yWeight1), vmulq_f32(bottom, yWeight2)), half), yScale));
+
+			// The index takes the top six bits of red, green and blue
+			match = vorrq_u32(vshlq_n_u32(match, 6), vshrq_n_u32(c, 2));
+		}
+
+		vst1q_u32(dst + x, match);
+	}
+
+	blendScaledRow(dst + x, c1 + x, c2 + x, c3 + x, c4 + x, xFrac + x, width, yFrac, height, count - x);
+}
+
+} // End of namespace Sword2
+
+#endif // SCUMMVM_NEON
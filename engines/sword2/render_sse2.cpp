@@ -0,0 +1,82 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "sword2/screen.h"
+
+#ifdef SCUMMVM_SSE2
+
+#include <emmintrin.h>
+
+namespace Sword2 {
+
+// The blends are done in single precision floats. All the products and sums
+// are exact, and adding a half before multiplying by the reciprocal keeps the
+// truncated quotient the same as the integer division.
+
+static inline __m128 blendPair(__m128 a, __m128 b, __m128 aWeight, __m128 bWeight, __m128 half, __m128 scale) {
+	__m128 sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, aWeight), _mm_mul_ps(b, bWeight)), half);
+	return _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(sum, scale)));
+}
+
+static inline __m128 channel(__m128i c, int shift) {
+	return _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(c, shift), _mm_set1_epi32(0xff)));
+}
+
+void blendScaledRowSSE2(uint32 *dst, const uint32 *c1, const uint32 *c2, const uint32 *c3, const uint32 *c4, const uint16 *xFrac, uint16 width, uint16 yFrac, uint16 height, uint count) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i widthVec = _mm_set1_epi32(width);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 xScale = _mm_set1_ps(1.0f / width);
+	const __m128 yScale = _mm_set1_ps(1.0f / height);
+	const __m128 yWeight1 = _mm_set1_ps(yFrac);
+	const __m128 yWeight2 = _mm_set1_ps(height - yFrac);
+
+	uint x = 0;
+	for (; x + 4 <= count; x += 4) {
+		__m128i frac = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)(xFrac + x)), zero);
+		__m128 xWeight1 = _mm_cvtepi32_ps(frac);
+		__m128 xWeight2 = _mm_cvtepi32_ps(_mm_sub_epi32(widthVec, frac));
+
+		__m128i p1 = _mm_loadu_si128((const __m128i *)(c1 + x));
+		__m128i p2 = _mm_loadu_si128((const __m128i *)(c2 + x));
+		__m128i p3 = _mm_loadu_si128((const __m128i *)(c3 + x));
+		__m128i p4 = _mm_loadu_si128((const __m128i *)(c4 + x));
+
+		__m128i match = zero;
+		for (int shift = 0; shift < 24; shift += 8) {
+			__m128 top = blendPair(channel(p1, shift), channel(p2, shift), xWeight1, xWeight2, half, xScale);
+			__m128 bottom = blendPair(channel(p3, shift), channel(p4, shift), xWeight1, xWeight2, half, xScale);
+			__m128i c = _mm_cvttps_epi32(_mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(top, yWeight1), _mm_mul_ps(bottom, yWeight2)), half), yScale));
+
+			// The index takes the top six bits of red, green and blue
+			match = _mm_or_si128(_mm_slli_epi32(match, 6), _mm_srli_epi32(c, 2));
+		}
+
+		_mm_storeu_si128((__m128i *)(dst + x), match);
+	}
+
+	blendScaledRow(dst + x, c1 + x, c2 + x, c3 + x, c4 + x, xFrac + x, width, yFrac, height, count - x);
+}
+
+} // End of namespace Sword2
+
+#endif // SCUMMVM_SSE2
@@ -592,6 +592,7 @@ void ResourceManager::checkMemUsage() {
 			assert((tmp->refCount == 0) && (tmp->ptr) && (tmp->next == nullptr));
 			removeFromCacheList(tmp);
 
+			_vm->_screen->forgetDecodedSprites(tmp - _resList);
 			_vm->_memory->memFree(tmp->ptr);
 			tmp->ptr = nullptr;
 			_usedMem -= tmp->size;
@@ -606,6 +607,7 @@ void ResourceManager::remove(int res) {
 	if (_resList[res].ptr) {
 		removeFromCacheList(_resList + res);
 
+		_vm->_screen->forgetDecodedSprites(res);
 		_vm->_memory->memFree(_resList[res].ptr);
 		_resList[res].ptr = nullptr;
 		_resList[res].refCount = 0;
@@ -23,6 +23,7 @@
 
 
 #include "common/memstream.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 
 #include "sword2/sword2.h"
@@ -199,6 +200,8 @@ int32 Router::routeFinder(byte *ob_mega, byte *ob_walkdata, int32 x, int32 y, in
 
 	// megaId = id;
 
+	if (_recordRoutes)
+		recordRoute(ob_mega, ob_walkdata, x, y, dir);
 	setUpWalkGrid(ob_mega, x, y, dir);
 	loadWalkData(ob_walkdata);
 
@@ -303,6 +306,8 @@ int32 Router::getRoute() {
 
 	int32 routeGot = 0;
 
+	prepareGridCache();
+
 	if (_startX == _targetX && _startY == _targetY)
 		routeGot = 2;
 	else {
@@ -1688,7 +1693,7 @@ bool Router::scan(int32 level) {
 						distance = (6 * ABS(x2 - x1) + 36 * ABS(y2 - y1)) / (36 * 14) + 1;
 
 					if (distance + _node[i].dist < _node[_nNodes].dist && distance + _node[i].dist < _node[j].dist) {
-						if (newCheck(0, x1, y1, x2, y2)) {
+						if (nodesVisible(i, j)) {
 							_node[j].level = level + 1;
 							_node[j].dist = distance + _node[i].dist;
 							_node[j].prev = i;
@@ -1915,30 +1920,33 @@ bool Router::lineCheck(int32 x1, int32 y1, int32 x2, int32 y2) {
 
 	int32 co = (y1 * dirx) - (x1 * diry);		// new line equation
 
-	for (int i = 0; i < _nBars && linesCrossed; i++) {
+	findBars(xmin, ymin, xmax, ymax);
+	for (int n = 0; n < _numBarCandidates && linesCrossed; n++) {
+		const BarData &bar = _bars[_barCandidates[n]];
+
 		// skip if not on module
-		if (xmax >= _bars[i].xmin && xmin <= _bars[i].xmax && ymax >= _bars[i].ymin && ymin <= _bars[i].ymax) {
+		if (xmax >= bar.xmin && xmin <= bar.xmax && ymax >= bar.ymin && ymin <= bar.ymax) {
 			// Okay, it's a valid line. Calculate an intercept. Wow
 			// but all this arithmetic we must have loads of time
 
 			// slope it he slope between the two lines
-			int32 slope = (_bars[i].dx * diry) - (_bars[i].dy *dirx);
+			int32 slope = (bar.dx * diry) - (bar.dy *dirx);
 			// assuming parallel lines don't cross
 			if (slope != 0) {
 				// calculate x intercept and check its on both
 				// lines
-				int32 xc = ((_bars[i].co * dirx) - (co * _bars[i].dx)) / slope;
+				int32 xc = ((bar.co * dirx) - (co * bar.dx)) / slope;
 
 				// skip if not on module
 				if (xc >= xmin - 1 && xc <= xmax + 1) {
 					// skip if not on line
-					if (xc >= _bars[i].xmin - 1 && xc <= _bars[i].xmax + 1) {
-						int32 yc = ((_bars[i].co * diry) - (co * _bars[i].dy)) / slope;
+					if (xc >= bar.xmin - 1 && xc <= bar.xmax + 1) {
+						int32 yc = ((bar.co * diry) - (co * bar.dy)) / slope;
 
 						// skip if not on module
 						if (yc >= ymin - 1 && yc <= ymax + 1) {
 							// skip if not on line
-							if (yc >= _bars[i].ymin - 1 && yc <= _bars[i].ymax + 1) {
+							if (yc >= bar.ymin - 1 && yc <= bar.ymax + 1) {
 								linesCrossed = false;
 							}
 						}
@@ -1960,17 +1968,20 @@ bool Router::horizCheck(int32 x1, int32 y, int32 x2) {
 	// line set to go one step in chosen direction so ignore if it hits
 	// anything
 
-	for (int i = 0; i < _nBars && linesCrossed; i++) {
+	findBars(xmin, y, xmax, y);
+	for (int n = 0; n < _numBarCandidates && linesCrossed; n++) {
+		const BarData &bar = _bars[_barCandidates[n]];
+
 		// skip if not on module
-		if (xmax >= _bars[i].xmin && xmin <= _bars[i].xmax && y >= _bars[i].ymin && y <= _bars[i].ymax) {
+		if (xmax >= bar.xmin && xmin <= bar.xmax && y >= bar.ymin && y <= bar.ymax) {
 			// Okay, it's a valid line calculate an intercept. Wow
 			// but all this arithmetic we must have loads of time
 
-			if (_bars[i].dy == 0)
+			if (bar.dy == 0)
 				linesCrossed = false;
 			else {
-				int32 ldy = y - _bars[i].y1;
-				int32 xc = _bars[i].x1 + (_bars[i].dx * ldy) / _bars[i].dy;
+				int32 ldy = y - bar.y1;
+				int32 xc = bar.x1 + (bar.dx * ldy) / bar.dy;
 				// skip if not on module
 				if (xc >= xmin - 1 && xc <= xmax + 1)
 					linesCrossed = false;
@@ -1990,20 +2001,23 @@ bool Router::vertCheck(int32 x, int32 y1, int32 y2) {
 	// Line set to go one step in chosen direction so ignore if it hits
 	// anything
 
-	for (int i = 0; i < _nBars && linesCrossed; i++) {
+	findBars(x, ymin, x, ymax);
+	for (int n = 0; n < _numBarCandidates && linesCrossed; n++) {
+		const BarData &bar = _bars[_barCandidates[n]];
+
 		// skip if not on module
-		if (x >= _bars[i].xmin && x <= _bars[i].xmax && ymax >= _bars[i].ymin && ymin <= _bars[i].ymax) {
+		if (x >= bar.xmin && x <= bar.xmax && ymax >= bar.ymin && ymin <= bar.ymax) {
 			// Okay, it's a valid line calculate an intercept. Wow
 			// but all this arithmetic we must have loads of time
 
 			// both lines vertical and overlap in x and y so they
 			// cross
 
-			if (_bars[i].dx == 0)
+			if (bar.dx == 0)
 				linesCrossed = false;
 			else {
-				int32 ldx = x - _bars[i].x1;
-				int32 yc = _bars[i].y1 + (_bars[i].dy * ldx) / _bars[i].dx;
+				int32 ldx = x - bar.x1;
+				int32 yc = bar.y1 + (bar.dy * ldx) / bar.dx;
 				// the intercept overlaps
 				if (yc >= ymin - 1 && yc <= ymax + 1)
 					linesCrossed = false;
@@ -2025,19 +2039,22 @@ int32 Router::checkTarget(int32 x, int32 y) {
 	// check if point +- 1 is on the line
 	// so ignore if it hits anything
 
-	for (int i = 0; i < _nBars && onLine == 0; i++) {
+	findBars(xmin, ymin, xmax, ymax);
+	for (int n = 0; n < _numBarCandidates && onLine == 0; n++) {
+		const BarData &bar = _bars[_barCandidates[n]];
+
 		// overlapping line
-		if (xmax >= _bars[i].xmin && xmin <= _bars[i].xmax && ymax >= _bars[i].ymin && ymin <= _bars[i].ymax) {
+		if (xmax >= bar.xmin && xmin <= bar.xmax && ymax >= bar.ymin && ymin <= bar.ymax) {
 			int32 xc, yc;
 
 			// okay this line overlaps the target calculate an y intercept for x
 
 			// vertical line so we know it overlaps y
-			if (_bars[i].dx == 0)
+			if (bar.dx == 0)
 				yc = 0;
 			else {
-				int ldx = x - _bars[i].x1;
-				yc = _bars[i].y1 + (_bars[i].dy * ldx) / _bars[i].dx;
+				int ldx = x - bar.x1;
+				yc = bar.y1 + (bar.dy * ldx) / bar.dx;
 			}
 
 			// overlapping point for y
@@ -2047,11 +2064,11 @@ int32 Router::checkTarget(int32 x, int32 y) {
 				debug(5, "RouteFail due to target on a line %d %d", x, y);
 			} else {
 				// vertical line so we know it overlaps y
-				if (_bars[i].dy == 0)
+				if (bar.dy == 0)
 					xc = 0;
 				else {
-					int32 ldy = y - _bars[i].y1;
-					xc = _bars[i].x1 + (_bars[i].dx * ldy) / _bars[i].dy;
+					int32 ldy = y - bar.y1;
+					xc = bar.x1 + (bar.dx * ldy) / bar.dy;
 				}
 
 				// skip if not on module
@@ -2069,6 +2086,273 @@ int32 Router::checkTarget(int32 x, int32 y) {
 
 // THE SETUP ROUTINES
 
+void Router::prepareGridCache() {
+	// The walk grid is loaded for every route, the caches stay valid
+	// as long as the same grid comes back
+	bool sameGrid = _gridCacheValid && _gridNBars == _nBars && _gridNNodes == _nNodes &&
+		!memcmp(_gridBars, _bars, _nBars * sizeof(BarData));
+
+	for (int i = 1; sameGrid && i < _nNodes; i++)
+		sameGrid = (_gridNodeX[i] == _node[i].x && _gridNodeY[i] == _node[i].y);
+
+	if (!sameGrid) {
+		_gridCacheValid = true;
+		_gridNBars = _nBars;
+		_gridNNodes = _nNodes;
+		memcpy(_gridBars, _bars, _nBars * sizeof(BarData));
+		for (int i = 1; i < _nNodes; i++) {
+			_gridNodeX[i] = _node[i].x;
+			_gridNodeY[i] = _node[i].y;
+		}
+
+		// Sort the bars into cells by their bounding box
+		_barGridW = _barGridH = 0;
+		_barCellStart.clear();
+		_barCellBars.clear();
+
+		if (_nBars > 0) {
+			int32 xmin = _bars[0].xmin, ymin = _bars[0].ymin;
+			int32 xmax = _bars[0].xmax, ymax = _bars[0].ymax;
+			for (int i = 1; i < _nBars; i++) {
+				xmin = MIN<int32>(xmin, _bars[i].xmin);
+				ymin = MIN<int32>(ymin, _bars[i].ymin);
+				xmax = MAX<int32>(xmax, _bars[i].xmax);
+				ymax = MAX<int32>(ymax, _bars[i].ymax);
+			}
+
+			_barGridX = xmin;
+			_barGridY = ymin;
+			_barGridW = ((xmax - xmin) >> kBarCellShift) + 1;
+			_barGridH = ((ymax - ymin) >> kBarCellShift) + 1;
+			_barCellStart.resize(_barGridW * _barGridH + 1);
+			for (uint i = 0; i < _barCellStart.size(); i++)
+				_barCellStart[i] = 0;
+
+			for (int pass = 0; pass < 2; pass++) {
+				for (int i = 0; i < _nBars; i++) {
+					int32 cx0 = (_bars[i].xmin - _barGridX) >> kBarCellShift;
+					int32 cx1 = (_bars[i].xmax - _barGridX) >> kBarCellShift;
+					int32 cy0 = (_bars[i].ymin - _barGridY) >> kBarCellShift;
+					int32 cy1 = (_bars[i].ymax - _barGridY) >> kBarCellShift;
+
+					for (int32 cy = cy0; cy <= cy1; cy++) {
+						for (int32 cx = cx0; cx <= cx1; cx++) {
+							if (pass == 0)
+								_barCellStart[cy * _barGridW + cx + 1]++;
+							else
+								_barCellBars[_barCellStart[cy * _barGridW + cx]++] = i;
+						}
+					}
+				}
+
+				if (pass == 0) {
+					for (uint c = 1; c < _barCellStart.size(); c++)
+						_barCellStart[c] += _barCellStart[c - 1];
+					_barCellBars.resize(_barCellStart.back());
+				} else {
+					// The fill moved every start to the next cell
+					for (uint c = _barCellStart.size() - 1; c > 0; c--)
+						_barCellStart[c] = _barCellStart[c - 1];
+					_barCellStart[0] = 0;
+				}
+			}
+		}
+	}
+
+	if (!sameGrid || _gridDiagonalX != _diagonalx || _gridDiagonalY != _diagonaly) {
+		// The walked route options depend on the diagonal of the mega
+		_gridDiagonalX = _diagonalx;
+		_gridDiagonalY = _diagonaly;
+		memset(_nodeVisibility, kVisibilityUnknown, sizeof(_nodeVisibility));
+	}
+}
+
+void Router::findBars(int32 xmin, int32 ymin, int32 xmax, int32 ymax) {
+	// Collect every bar, whose bounding box may overlap the given one.
+	// With the cache the bars come in cell order, not in the original bar
+	// order, so the callers must not depend on which bar they test first.
+	// lineCheck, horizCheck, vertCheck and checkTarget only report whether
+	// any bar is hit, which keeps their results unchanged.
+	_numBarCandidates = 0;
+
+	if (!_useGridCache) {
+		for (int i = 0; i < _nBars; i++)
+			_barCandidates[_numBarCandidates++] = i;
+		return;
+	}
+
+	if (_barGridW == 0 || xmax < _barGridX || ymax < _barGridY)
+		return;
+
+	int32 cx0 = MAX<int32>(xmin - _barGridX, 0) >> kBarCellShift;
+	int32 cy0 = MAX<int32>(ymin - _barGridY, 0) >> kBarCellShift;
+	int32 cx1 = MIN<int32>((xmax - _barGridX) >> kBarCellShift, _barGridW - 1);
+	int32 cy1 = MIN<int32>((ymax - _barGridY) >> kBarCellShift, _barGridH - 1);
+
+	if (++_barStampValue == 0) {
+		memset(_barStamp, 0, sizeof(_barStamp));
+		_barStampValue = 1;
+	}
+
+	for (int32 cy = cy0; cy <= cy1; cy++) {
+		for (int32 cx = cx0; cx <= cx1; cx++) {
+			uint cell = cy * _barGridW + cx;
+			for (uint n = _barCellStart[cell]; n < _barCellStart[cell + 1]; n++) {
+				uint8 bar = _barCellBars[n];
+				if (_barStamp[bar] != _barStampValue) {
+					_barStamp[bar] = _barStampValue;
+					_barCandidates[_numBarCandidates++] = bar;
+				}
+			}
+		}
+	}
+}
+
+bool Router::nodesVisible(int32 i, int32 j) {
+	// The start and the target node change with every route
+	if (!_useGridCache || i == 0 || j == _nNodes)
+		return newCheck(0, _node[i].x, _node[i].y, _node[j].x, _node[j].y) != 0;
+
+	uint8 &visibility = _nodeVisibility[i * O_GRID_SIZE + j];
+	if (visibility == kVisibilityUnknown)
+		visibility = newCheck(0, _node[i].x, _node[i].y, _node[j].x, _node[j].y) ? kVisibilityClear : kVisibilityBlocked;
+
+	return visibility == kVisibilityClear;
+}
+
+void Router::setRecordRoutes(bool record) {
+	_recordRoutes = record;
+	if (!record)
+		_numRouteRecords = _nextRouteRecord = 0;
+}
+
+void Router::recordRoute(byte *ob_mega, byte *ob_walkdata, int32 x, int32 y, int32 dir) {
+	// Keep the latest route of every mega in every location, once all the
+	// slots are used the oldest location is replaced
+	uint8 slotNo = returnSlotNo(_vm->_logic->readVar(ID));
+	uint i;
+
+	for (i = 0; i < _numRouteRecords; i++) {
+		if (_routeRecords[i].slotNo == slotNo && !memcmp(_routeRecords[i].walkGridList, _walkGridList, sizeof(_walkGridList)))
+			break;
+	}
+
+	if (i == _numRouteRecords) {
+		i = _nextRouteRecord;
+		_nextRouteRecord = (_nextRouteRecord + 1) % kMaxRouteRecords;
+		if (_numRouteRecords < kMaxRouteRecords)
+			_numRouteRecords++;
+	}
+
+	ObjectMega obMega(ob_mega);
+	RouteRecord &record = _routeRecords[i];
+	record.feetX = obMega.getFeetX();
+	record.feetY = obMega.getFeetY();
+	record.curDir = obMega.getCurDir();
+	record.scaleA = obMega.getScaleA();
+	record.scaleB = obMega.getScaleB();
+	memcpy(record.walkData, ob_walkdata, ObjectWalkdata::size());
+	memcpy(record.walkGridList, _walkGridList, sizeof(_walkGridList));
+	record.slotNo = slotNo;
+	record.x = x;
+	record.y = y;
+	record.dir = dir;
+}
+
+/**
+ * Run the recorded routes and some more targets in the same locations with
+ * and without the walk grid caches and compare the walks.
+ */
+bool Router::checkRecordedRoutes(uint extraTargets, uint &numRoutes, uint32 &referenceTime, uint32 &cachedTime) {
+	int32 walkGridList[MAX_WALKGRIDS];
+	WalkData *routeSlots[TOTAL_ROUTE_SLOTS];
+	WalkData *referenceWalk = (WalkData *)malloc(sizeof(WalkData) * O_WALKANIM_SIZE);
+	WalkData *walk = (WalkData *)malloc(sizeof(WalkData) * O_WALKANIM_SIZE);
+	byte megaData[56];
+	ObjectMega obMega(megaData);
+	uint32 seed = 1;
+	bool identical = true;
+	// Replaying must not replace the records
+	bool recordRoutes = _recordRoutes;
+	_recordRoutes = false;
+
+	memcpy(walkGridList, _walkGridList, sizeof(_walkGridList));
+	memcpy(routeSlots, _routeSlots, sizeof(_routeSlots));
+
+	numRoutes = 0;
+	referenceTime = cachedTime = 0;
+
+	for (uint r = 0; r < _numRouteRecords; r++) {
+		RouteRecord &record = _routeRecords[r];
+		int32 x = record.x, y = record.y, dir = record.dir;
+		int32 xmin = 0, ymin = 0, xmax = 0, ymax = 0;
+
+		memcpy(_walkGridList, record.walkGridList, sizeof(_walkGridList));
+		memset(megaData, 0, sizeof(megaData));
+		obMega.setFeetX(record.feetX);
+		obMega.setFeetY(record.feetY);
+		obMega.setCurDir(record.curDir);
+		obMega.setScaleA(record.scaleA);
+		obMega.setScaleB(record.scaleB);
+
+		for (uint t = 0; t <= extraTargets; t++) {
+			if (t > 0) {
+				// Random targets around the walk grid of this location
+				seed = seed * 1103515245 + 12345;
+				x = xmin + (seed >> 8) % (xmax - xmin + 1);
+				seed = seed * 1103515245 + 12345;
+				y = ymin + (seed >> 8) % (ymax - ymin + 1);
+				seed = seed * 1103515245 + 12345;
+				dir = (seed >> 8) % (NO_DIRECTIONS + 1);
+			}
+
+			// The walk goes to the route slot of the current ID, which
+			// need not be the recorded mega
+			memset(referenceWalk, 0, sizeof(WalkData) * O_WALKANIM_SIZE);
+			for (int i = 0; i < TOTAL_ROUTE_SLOTS; i++)
+				_routeSlots[i] = referenceWalk;
+			_useGridCache = false;
+			uint32 startTime = _vm->_system->getMillis();
+			int32 referenceResult = routeFinder(megaData, record.walkData, x, y, dir);
+			referenceTime += _vm->_system->getMillis() - startTime;
+
+			memset(walk, 0, sizeof(WalkData) * O_WALKANIM_SIZE);
+			for (int i = 0; i < TOTAL_ROUTE_SLOTS; i++)
+				_routeSlots[i] = walk;
+			_useGridCache = true;
+			startTime = _vm->_system->getMillis();
+			int32 result = routeFinder(megaData, record.walkData, x, y, dir);
+			cachedTime += _vm->_system->getMillis() - startTime;
+
+			if (result != referenceResult || memcmp(referenceWalk, walk, sizeof(WalkData) * O_WALKANIM_SIZE)) {
+				debug(1, "Router::checkRecordedRoutes(): route of mega %d to %d, %d differs", record.slotNo, x, y);
+				identical = false;
+			}
+			numRoutes++;
+
+			if (t == 0) {
+				for (int i = 0; i < _nNodes; i++) {
+					if (i == 0 || _node[i].x < xmin)
+						xmin = _node[i].x;
+					if (i == 0 || _node[i].y < ymin)
+						ymin = _node[i].y;
+					if (i == 0 || _node[i].x > xmax)
+						xmax = _node[i].x;
+					if (i == 0 || _node[i].y > ymax)
+						ymax = _node[i].y;
+				}
+			}
+		}
+	}
+
+	memcpy(_walkGridList, walkGridList, sizeof(_walkGridList));
+	memcpy(_routeSlots, routeSlots, sizeof(_routeSlots));
+	_recordRoutes = recordRoutes;
+	free(referenceWalk);
+	free(walk);
+	return identical;
+}
+
 void Router::loadWalkData(byte *ob_walkdata) {
 	uint16 firstFrameOfDirection;
 	uint16 walkFrameNo;
@@ -32,6 +32,8 @@
 //
 // #define FORCE_SLIDY
 
+#include "common/array.h"
+
 #include "sword2/object.h"
 
 namespace Sword2 {
@@ -159,6 +161,55 @@ private:
 	int32 _lastCount;
 	int32 _frame;
 
+	// The walk grid the caches below were made for
+	bool _gridCacheValid;
+	BarData _gridBars[O_GRID_SIZE];
+	int16 _gridNodeX[O_GRID_SIZE];
+	int16 _gridNodeY[O_GRID_SIZE];
+	int32 _gridNBars, _gridNNodes;
+	int32 _gridDiagonalX, _gridDiagonalY;
+
+	// Result of newCheck() between the fixed nodes of the walk grid,
+	// filled in as the routes ask for it
+	enum {
+		kVisibilityUnknown = 0,
+		kVisibilityBlocked = 1,
+		kVisibilityClear = 2
+	};
+	uint8 _nodeVisibility[O_GRID_SIZE * O_GRID_SIZE];
+
+	// Uniform grid of the bars, so the line checks only test nearby bars
+	enum {
+		kBarCellShift = 6
+	};
+	int32 _barGridX, _barGridY, _barGridW, _barGridH;
+	Common::Array<uint32> _barCellStart;
+	Common::Array<uint8> _barCellBars;
+	uint16 _barStamp[O_GRID_SIZE];
+	uint16 _barStampValue;
+	uint8 _barCandidates[O_GRID_SIZE];
+	int32 _numBarCandidates;
+
+	// Disables both caches, to compare against the original router
+	bool _useGridCache;
+
+	// Inputs of the latest routes of every location, for checkRecordedRoutes().
+	// Only the mega fields setUpWalkGrid() reads are kept.
+	struct RouteRecord {
+		int32 feetX, feetY, curDir;
+		int32 scaleA, scaleB;
+		byte walkData[916];
+		int32 walkGridList[MAX_WALKGRIDS];
+		uint8 slotNo;
+		int32 x, y, dir;
+	};
+	enum {
+		kMaxRouteRecords = 32
+	};
+	bool _recordRoutes;
+	RouteRecord _routeRecords[kMaxRouteRecords];
+	uint _numRouteRecords, _nextRouteRecord;
+
 	uint8 returnSlotNo(uint32 megaId);
 
 	int32 getRoute();
@@ -166,6 +217,12 @@ private:
 	void loadWalkGrid();
 	void setUpWalkGrid(byte *ob_mega, int32 x, int32 y, int32 dir);
 	void loadWalkData(byte *ob_walkdata);
+
+	void prepareGridCache();
+	void findBars(int32 xmin, int32 ymin, int32 xmax, int32 ymax);
+	bool nodesVisible(int32 i, int32 j);
+	void recordRoute(byte *ob_mega, byte *ob_walkdata, int32 x, int32 y, int32 dir);
+
 	bool scan(int32 level);
 
 	int32 newCheck(int32 status, int32 x1, int32 y1, int32 x2, int32 y2);
@@ -192,7 +249,10 @@ private:
 	void plotCross(int16 x, int16 y, uint8 color);
 
 public:
-	Router(Sword2Engine *vm) : _vm(vm), _diagonalx(0), _diagonaly(0) {
+	Router(Sword2Engine *vm) : _vm(vm), _diagonalx(0), _diagonaly(0), _gridCacheValid(false),
+		_gridNBars(0), _gridNNodes(0), _gridDiagonalX(0), _gridDiagonalY(0), _barGridX(0), _barGridY(0),
+		_barGridW(0), _barGridH(0), _barStampValue(0), _numBarCandidates(0), _useGridCache(true),
+		_recordRoutes(false), _numRouteRecords(0), _nextRouteRecord(0) {
 		memset(_routeSlots, 0, sizeof(_routeSlots));
 		memset(_bars, 0, sizeof(_bars));
 		memset(_node, 0, sizeof(_node));
@@ -203,6 +263,7 @@ public:
 		memset(_modX, 0, sizeof(_modX));
 		memset(_modY, 0, sizeof(_modY));
 		memset(_firstSlowInFrame, 0, sizeof(_firstSlowInFrame));
+		memset(_barStamp, 0, sizeof(_barStamp));
 	}
 
 	void setStandbyCoords(int16 x, int16 y, uint8 dir);
@@ -244,6 +305,11 @@ public:
 	void clearWalkGridList();
 
 	void plotWalkGrid();
+
+	// Route recording for checkRecordedRoutes(), off by default
+	void setRecordRoutes(bool record);
+	bool getRecordRoutes() const { return _recordRoutes; }
+	bool checkRecordedRoutes(uint extraTargets, uint &numRoutes, uint32 &referenceTime, uint32 &cachedTime);
 };
 
 } // End of namespace Sword2
@@ -105,10 +105,32 @@ Screen::Screen(Sword2Engine *vm, int16 width, int16 height) {
 	_psxCacheEnabled[0] = true;
 	_psxCacheEnabled[1] = true;
 	_psxCacheEnabled[2] = true;
+
+	_blendScaledRow = blendScaledRow;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		_blendScaledRow = blendScaledRowNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		_blendScaledRow = blendScaledRowSSE2;
+#endif
+
+	_decodedSpritesSize = 0;
+	_decodedSpritesBudget = DECODED_SPRITES_BUDGET;
+	_decodedSpriteHits = 0;
+	_decodedSpriteMisses = 0;
+
+	memset(_scaledFrames, 0, sizeof(_scaledFrames));
+	_scaledFrameUse = 0;
+	_scaledFrameHits = 0;
+	_scaledFrameMisses = 0;
 }
 
 Screen::~Screen() {
 	flushPsxScrCache();
+	invalidateScaledFrames();
+	forgetDecodedSprites(-1);
 	free(_buffer);
 	free(_dirtyGrid);
 	closeBackgroundLayer();
@@ -543,7 +565,7 @@ void Screen::processLayer(byte *file, uint32 layer_number) {
 			layer_number, layer_head.width, layer_head.height);
 	}
 
-	uint32 rv = drawSprite(&spriteInfo);
+	uint32 rv = drawSprite(&spriteInfo, _thisScreen.background_layer_id, layer_number);
 	if (rv)
 		error("Driver Error %.8x in processLayer(%d)", rv, layer_number);
 }
@@ -672,7 +694,7 @@ void Screen::processImage(BuildUnit *build_unit) {
 		_vm->_debugger->_rectY2 = spriteInfo.y + spriteInfo.scaledHeight;
 	}
 
-	uint32 rv = drawSprite(&spriteInfo);
+	uint32 rv = drawSprite(&spriteInfo, build_unit->anim_resource, build_unit->anim_pc);
 	if (rv) {
 		error("Driver Error %.8x with sprite %s (%d, %d) in processImage",
 			rv,
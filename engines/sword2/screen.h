@@ -24,6 +24,8 @@
 #ifndef	SWORD2_SCREEN_H
 #define	SWORD2_SCREEN_H
 
+#include "common/hashmap.h"
+#include "common/list.h"
 #include "common/rect.h"
 #include "common/stream.h"
 
@@ -49,6 +51,12 @@
 #define SCALE_MAXWIDTH   512
 #define SCALE_MAXHEIGHT  512
 
+// Number of scaled sprites kept for megas that stand still
+#define MAX_SCALED_FRAMES 8
+
+// Memory for the sprites kept decoded
+#define DECODED_SPRITES_BUDGET (2 * 1024 * 1024)
+
 // Dirty grid cell size
 #define CELLWIDE         10
 #define CELLDEEP         20
@@ -192,6 +200,51 @@ struct Parallax {
 	void write(byte *addr);
 };
 
+// A scaled sprite, along with everything the "good" scaler read to make it
+
+struct ScaledFrame {
+	byte *sprite;		// the sprite before scaling
+	byte *background;	// the back buffer under the scaled sprite
+	byte *scaled;		// the scaled sprite
+	uint16 w;
+	uint16 h;
+	uint16 scaledWidth;
+	uint16 scaledHeight;
+	int16 bbXPos;
+	int16 bbYPos;
+	byte palette[256 * 3];
+	uint32 lastUse;
+};
+
+// A sprite of an animation or layer resource, kept decompressed and mirrored
+
+struct DecodedSprite {
+	uint32 res;
+	uint32 frame;
+	bool flipped;
+	SpriteInfo source;	// the sprite before decoding
+	uint16 w;		// dimensions of the decoded sprite
+	uint16 h;
+	byte *data;
+};
+
+typedef Common::List<DecodedSprite> DecodedSpriteList;
+typedef Common::HashMap<uint32, DecodedSpriteList::iterator> DecodedSpriteIndex;
+
+// Blends the four source colors around each pixel of a scaled sprite row and
+// returns the palette match table index of each pixel. The colors are
+// 0x00BBGGRR values.
+
+typedef void (*BlendScaledRowProc)(uint32 *dst, const uint32 *c1, const uint32 *c2, const uint32 *c3, const uint32 *c4, const uint16 *xFrac, uint16 width, uint16 yFrac, uint16 height, uint count);
+
+void blendScaledRow(uint32 *dst, const uint32 *c1, const uint32 *c2, const uint32 *c3, const uint32 *c4, const uint16 *xFrac, uint16 width, uint16 yFrac, uint16 height, uint count);
+#ifdef SCUMMVM_SSE2
+void blendScaledRowSSE2(uint32 *dst, const uint32 *c1, const uint32 *c2, const uint32 *c3, const uint32 *c4, const uint16 *xFrac, uint16 width, uint16 yFrac, uint16 height, uint count);
+#endif
+#ifdef SCUMMVM_NEON
+void blendScaledRowNEON(uint32 *dst, const uint32 *c1, const uint32 *c2, const uint32 *c3, const uint32 *c4, const uint16 *xFrac, uint16 width, uint16 yFrac, uint16 height, uint count);
+#endif
+
 class Screen {
 private:
 	Sword2Engine *_vm;
@@ -340,6 +393,39 @@ private:
 	uint16 _xScale[SCALE_MAXWIDTH];
 	uint16 _yScale[SCALE_MAXHEIGHT];
 
+	// Work space of the "good" scaler
+	uint16 _xFrac[SCALE_MAXWIDTH];
+	uint32 _paletteBlend[256];
+	uint32 _blendRows[4][SCALE_MAXWIDTH];
+	uint32 _blendMatch[SCALE_MAXWIDTH];
+	bool _blendOpaque[SCALE_MAXWIDTH];
+	BlendScaledRowProc _blendScaledRow;
+
+	ScaledFrame _scaledFrames[MAX_SCALED_FRAMES];
+	uint32 _scaledFrameUse;
+	uint32 _scaledFrameHits;
+	uint32 _scaledFrameMisses;
+
+	// Most recently used first
+	DecodedSpriteList _decodedSprites;
+	DecodedSpriteIndex _decodedSpriteIndex;
+	uint32 _decodedSpritesSize;
+	uint32 _decodedSpritesBudget;
+	uint32 _decodedSpriteHits;
+	uint32 _decodedSpriteMisses;
+
+	static uint32 decodedSpriteKey(uint32 res, uint32 frame, bool flipped) {
+		return (res << 16) | (frame << 1) | (flipped ? 1 : 0);
+	}
+
+	int32 decodeSprite(SpriteInfo *s, byte *&sprite, bool &freeSprite);
+	DecodedSprite *findDecodedSprite(uint32 res, uint32 frame, bool flipped);
+	bool addDecodedSprite(uint32 res, uint32 frame, const SpriteInfo &source, uint16 w, uint16 h, byte *data);
+
+	Common::Rect scaledFrameBackground(const ScaledFrame &frame);
+	bool findScaledFrame(byte *dst, byte *sprite, uint16 w, uint16 h, uint16 scaledWidth, uint16 scaledHeight, int16 bbXPos, int16 bbYPos);
+	void storeScaledFrame(byte *scaled, byte *sprite, uint16 w, uint16 h, uint16 scaledWidth, uint16 scaledHeight, int16 bbXPos, int16 bbYPos);
+
 	void blitBlockSurface(BlockSurface *s, Common::Rect *r, Common::Rect *clipRect);
 
 	uint16 _layer;
@@ -422,7 +508,16 @@ public:
 	int32 createSurface(SpriteInfo *s, byte **surface);
 	void drawSurface(SpriteInfo *s, byte *surface, Common::Rect *clipRect = nullptr);
 	void deleteSurface(byte *surface);
-	int32 drawSprite(SpriteInfo *s);
+	int32 drawSprite(SpriteInfo *s, uint32 res = 0, uint32 frame = 0);
+
+	void forgetDecodedSprites(int32 res);
+	void setDecodedSpritesBudget(uint32 budget);
+	bool benchmarkSpriteDecoding(uint &numSprites, uint32 &decodeTime, uint32 &cachedTime);
+	uint getNumDecodedSprites() { return _decodedSprites.size(); }
+	uint32 getDecodedSpritesSize() { return _decodedSpritesSize; }
+	uint32 getDecodedSpritesBudget() { return _decodedSpritesBudget; }
+	uint32 getDecodedSpriteHits() { return _decodedSpriteHits; }
+	uint32 getDecodedSpriteMisses() { return _decodedSpriteMisses; }
 
 	void scaleImageFast(byte *dst, uint16 dstPitch, uint16 dstWidth,
 		uint16 dstHeight, byte *src, uint16 srcPitch, uint16 srcWidth,
@@ -430,6 +525,15 @@ public:
 	void scaleImageGood(byte *dst, uint16 dstPitch, uint16 dstWidth,
 		uint16 dstHeight, byte *src, uint16 srcPitch, uint16 srcWidth,
 		uint16 srcHeight, byte *backBuf, int16 bbXPos, int16 bbYPos);
+#ifndef RELEASE_BUILD
+	void scaleImageGoodReference(byte *dst, uint16 dstWidth, uint16 dstHeight,
+		byte *src, uint16 srcPitch, uint16 srcWidth, uint16 srcHeight,
+		byte *backBuf, int16 bbXPos, int16 bbYPos);
+	bool checkScaler(uint tests, uint32 &referenceTime, uint32 &genericTime, uint32 &time);
+#endif
+	void invalidateScaledFrames();
+	uint32 getScaledFrameHits() { return _scaledFrameHits; }
+	uint32 getScaledFrameMisses() { return _scaledFrameMisses; }
 
 	void updateRect(Common::Rect *r);
 
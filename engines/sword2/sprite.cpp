@@ -22,6 +22,7 @@
  */
 
 #include "common/endian.h"
+#include "common/system.h"
 
 #include "sword2/sword2.h"
 #include "sword2/defs.h"
@@ -461,38 +462,20 @@ void Screen::deleteSurface(byte *surface) {
 }
 
 /**
- * Draws a sprite onto the screen. The type of the sprite can be a combination
- * of the following flags, some of which are mutually exclusive:
- * RDSPR_DISPLAYALIGN	The sprite is drawn relative to the top left corner
- *			of the screen
- * RDSPR_FLIP		The sprite is mirrored
- * RDSPR_TRANS		The sprite has a transparent color zero
- * RDSPR_BLEND		The sprite is translucent
- * RDSPR_SHADOW		The sprite is affected by the light mask. (Scaled
- *			sprites always are.)
- * RDSPR_NOCOMPRESSION	The sprite data is not compressed
- * RDSPR_RLE16		The sprite data is a 16-color compressed sprite
- * RDSPR_RLE256		The sprite data is a 256-color compressed sprite
- * @param s all the information needed to draw the sprite
- * @warning Sprites will only be drawn onto the background, not over menubar
- * areas.
+ * Decompresses and, if needed, mirrors a sprite. PSX sprites may change their
+ * dimensions in the process.
+ * @param s the sprite
+ * @param sprite set to the decoded sprite
+ * @param freeSprite set to true if the decoded sprite has to be freed, or to
+ * false if it is the sprite data itself
+ * @return RD_OK or an error code
  */
 
-// FIXME: I'm sure this could be optimized. There's plenty of data copying and
-// mallocing here.
+int32 Screen::decodeSprite(SpriteInfo *s, byte *&sprite, bool &freeSprite) {
+	byte *newSprite;
 
-int32 Screen::drawSprite(SpriteInfo *s) {
-	byte *src, *dst;
-	byte *sprite, *newSprite;
-	uint16 scale;
-	int16 i, j;
-	uint16 srcPitch;
-	bool freeSprite = false;
-	Common::Rect rd, rs;
+	freeSprite = false;
 
-	// -----------------------------------------------------------------
-	// Decompression and mirroring
-	// -----------------------------------------------------------------
 	if (s->type & RDSPR_NOCOMPRESSION) {
 		if (Sword2Engine::isPsx()) { // PSX Uncompressed sprites
 			if (s->w > 254 && !s->isText) { // We need to recompose these frames
@@ -626,6 +609,220 @@ int32 Screen::drawSprite(SpriteInfo *s) {
 		freeSprite = true;
 	}
 
+	return RD_OK;
+}
+
+/**
+ * Looks for a decoded sprite, and makes it the most recently used one.
+ */
+
+DecodedSprite *Screen::findDecodedSprite(uint32 res, uint32 frame, bool flipped) {
+	DecodedSpriteIndex::iterator it = _decodedSpriteIndex.find(decodedSpriteKey(res, frame, flipped));
+
+	if (it == _decodedSpriteIndex.end()) {
+		_decodedSpriteMisses++;
+		return nullptr;
+	}
+
+	if (it->_value != _decodedSprites.begin()) {
+		_decodedSprites.push_front(*it->_value);
+		_decodedSprites.erase(it->_value);
+		it->_value = _decodedSprites.begin();
+	}
+
+	_decodedSpriteHits++;
+	return &_decodedSprites.front();
+}
+
+/**
+ * Keeps a decoded sprite, dropping the least recently used ones to stay within
+ * the budget.
+ * @param res the resource of the sprite
+ * @param frame the frame or layer number of the sprite in the resource
+ * @param source the sprite before decoding
+ * @param w the width of the decoded sprite
+ * @param h the height of the decoded sprite
+ * @param data the decoded sprite, which is freed along with the cache entry
+ * @return true if the sprite was kept
+ */
+
+bool Screen::addDecodedSprite(uint32 res, uint32 frame, const SpriteInfo &source, uint16 w, uint16 h, byte *data) {
+	uint32 size = w * h;
+
+	if (size > _decodedSpritesBudget || res >= 0x10000 || frame >= 0x8000)
+		return false;
+
+	while (_decodedSpritesSize + size > _decodedSpritesBudget) {
+		DecodedSprite &last = _decodedSprites.back();
+
+		_decodedSpriteIndex.erase(decodedSpriteKey(last.res, last.frame, last.flipped));
+		_decodedSpritesSize -= last.w * last.h;
+		free(last.data);
+		_decodedSprites.pop_back();
+	}
+
+	DecodedSprite decoded;
+
+	decoded.res = res;
+	decoded.frame = frame;
+	decoded.flipped = (source.type & RDSPR_FLIP) != 0;
+	decoded.source = source;
+	decoded.w = w;
+	decoded.h = h;
+	decoded.data = data;
+
+	_decodedSprites.push_front(decoded);
+	_decodedSpriteIndex[decodedSpriteKey(res, frame, decoded.flipped)] = _decodedSprites.begin();
+	_decodedSpritesSize += size;
+	return true;
+}
+
+/**
+ * Drops the decoded sprites of a resource. This has to be done when the
+ * resource is removed from memory, since the decoded sprites keep pointers to
+ * its data. Merely closing a resource does not remove it.
+ * @param res the resource, or -1 to drop all decoded sprites
+ */
+
+void Screen::forgetDecodedSprites(int32 res) {
+	DecodedSpriteList::iterator it = _decodedSprites.begin();
+
+	while (it != _decodedSprites.end()) {
+		if (res == -1 || it->res == (uint32)res) {
+			_decodedSpriteIndex.erase(decodedSpriteKey(it->res, it->frame, it->flipped));
+			_decodedSpritesSize -= it->w * it->h;
+			free(it->data);
+			it = _decodedSprites.erase(it);
+		} else
+			++it;
+	}
+}
+
+void Screen::setDecodedSpritesBudget(uint32 budget) {
+	_decodedSpritesBudget = budget;
+
+	while (_decodedSpritesSize > _decodedSpritesBudget) {
+		DecodedSprite &last = _decodedSprites.back();
+
+		_decodedSpriteIndex.erase(decodedSpriteKey(last.res, last.frame, last.flipped));
+		_decodedSpritesSize -= last.w * last.h;
+		free(last.data);
+		_decodedSprites.pop_back();
+	}
+}
+
+/**
+ * Decodes all the sprites in the cache again, and compares the time that
+ * takes with the time of finding them in the cache.
+ * @return true if all the sprites decode to the cached data
+ */
+
+bool Screen::benchmarkSpriteDecoding(uint &numSprites, uint32 &decodeTime, uint32 &cachedTime) {
+	bool identical = true;
+
+	numSprites = _decodedSprites.size();
+	decodeTime = cachedTime = 0;
+
+	// Work on a copy of the list, since finding the sprites reorders it
+	Common::Array<DecodedSprite> sprites;
+
+	for (DecodedSpriteList::iterator it = _decodedSprites.begin(); it != _decodedSprites.end(); ++it)
+		sprites.push_back(*it);
+
+	uint32 hits = _decodedSpriteHits;
+	uint32 misses = _decodedSpriteMisses;
+
+	for (uint i = 0; i < sprites.size(); i++) {
+		SpriteInfo s = sprites[i].source;
+		byte *sprite;
+		bool freeSprite;
+
+		uint32 startTime = _vm->_system->getMillis();
+		int32 rv = decodeSprite(&s, sprite, freeSprite);
+		decodeTime += _vm->_system->getMillis() - startTime;
+
+		if (rv) {
+			identical = false;
+			continue;
+		}
+
+		startTime = _vm->_system->getMillis();
+		DecodedSprite *decoded = findDecodedSprite(sprites[i].res, sprites[i].frame, sprites[i].flipped);
+		cachedTime += _vm->_system->getMillis() - startTime;
+
+		if (!decoded || s.w != decoded->w || s.h != decoded->h || memcmp(sprite, decoded->data, s.w * s.h)) {
+			debug(1, "Screen::benchmarkSpriteDecoding(): frame %d of resource %d differs", sprites[i].frame, sprites[i].res);
+			identical = false;
+		}
+
+		if (freeSprite)
+			free(sprite);
+	}
+
+	// Restore the order of the sprites, and the statistics
+	for (uint i = sprites.size(); i > 0; i--)
+		findDecodedSprite(sprites[i - 1].res, sprites[i - 1].frame, sprites[i - 1].flipped);
+
+	_decodedSpriteHits = hits;
+	_decodedSpriteMisses = misses;
+	return identical;
+}
+
+/**
+ * Draws a sprite onto the screen. The type of the sprite can be a combination
+ * of the following flags, some of which are mutually exclusive:
+ * RDSPR_DISPLAYALIGN	The sprite is drawn relative to the top left corner
+ *			of the screen
+ * RDSPR_FLIP		The sprite is mirrored
+ * RDSPR_TRANS		The sprite has a transparent color zero
+ * RDSPR_BLEND		The sprite is translucent
+ * RDSPR_SHADOW		The sprite is affected by the light mask. (Scaled
+ *			sprites always are.)
+ * RDSPR_NOCOMPRESSION	The sprite data is not compressed
+ * RDSPR_RLE16		The sprite data is a 16-color compressed sprite
+ * RDSPR_RLE256		The sprite data is a 256-color compressed sprite
+ * @param s all the information needed to draw the sprite
+ * @param res the resource of the sprite, or 0 if it is not to be kept decoded
+ * @param frame the frame or layer number of the sprite in the resource
+ * @warning Sprites will only be drawn onto the background, not over menubar
+ * areas.
+ */
+
+// FIXME: I'm sure this could be optimized. There's plenty of data copying and
+// mallocing here.
+
+int32 Screen::drawSprite(SpriteInfo *s, uint32 res, uint32 frame) {
+	byte *src, *dst;
+	byte *sprite, *newSprite;
+	uint16 scale;
+	int16 i, j;
+	uint16 srcPitch;
+	bool freeSprite = false;
+	Common::Rect rd, rs;
+
+	// -----------------------------------------------------------------
+	// Decompression and mirroring
+	// -----------------------------------------------------------------
+	// Sprites of animation and layer resources are only decoded the first
+	// time they are drawn.
+
+	DecodedSprite *decoded = res ? findDecodedSprite(res, frame, (s->type & RDSPR_FLIP) != 0) : nullptr;
+
+	if (decoded) {
+		sprite = decoded->data;
+		s->w = decoded->w;
+		s->h = decoded->h;
+	} else {
+		SpriteInfo source = *s;
+		int32 rv = decodeSprite(s, sprite, freeSprite);
+
+		if (rv)
+			return rv;
+
+		if (res && freeSprite && addDecodedSprite(res, frame, source, s->w, s->h, sprite))
+			freeSprite = false;
+	}
+
 	// -----------------------------------------------------------------
 	// Positioning and clipping.
 	// -----------------------------------------------------------------
@@ -715,9 +912,14 @@ int32 Screen::drawSprite(SpriteInfo *s) {
 
 		// We cannot use good scaling for PSX version, as we are missing
 		// some required data.
-		if (_renderCaps & RDBLTFX_EDGEBLEND && !Sword2Engine::isPsx())
-			scaleImageGood(newSprite, s->scaledWidth, s->scaledWidth, s->scaledHeight, sprite, s->w, s->w, s->h, _buffer, rd.left, rd.top);
-		else
+		if (_renderCaps & RDBLTFX_EDGEBLEND && !Sword2Engine::isPsx()) {
+			// Megas standing still are scaled the same way every
+			// frame, so keep the last few scaled sprites around.
+			if (!findScaledFrame(newSprite, sprite, s->w, s->h, s->scaledWidth, s->scaledHeight, rd.left, rd.top)) {
+				scaleImageGood(newSprite, s->scaledWidth, s->scaledWidth, s->scaledHeight, sprite, s->w, s->w, s->h, _buffer, rd.left, rd.top);
+				storeScaledFrame(newSprite, sprite, s->w, s->h, s->scaledWidth, s->scaledHeight, rd.left, rd.top);
+			}
+		} else
 			scaleImageFast(newSprite, s->scaledWidth, s->scaledWidth, s->scaledHeight, sprite, s->w, s->w, s->h);
 
 		if (freeSprite)
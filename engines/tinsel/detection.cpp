@@ -40,6 +40,7 @@ static const DebugChannelDef debugFlagList[] = {
 	{Tinsel::kTinselDebugActions, "actions", "Actions debugging"},
 	{Tinsel::kTinselDebugSound, "sound", "Sound debugging"},
 	{Tinsel::kTinselDebugMusic, "music", "Music debugging"},
+	{Tinsel::kTinselDebugScripts, "scripts", "Cross-check pre-decoded scripts against the raw PCODE"},
 	DEBUG_CHANNEL_END
 };
 
@@ -32,6 +32,8 @@
 #include "tinsel/tinlib.h"	// Library routines
 #include "tinsel/tinsel.h"
 
+#include "common/debug-channels.h"
+#include "common/hashmap.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
@@ -114,6 +116,31 @@ static INT_CONTEXT *g_icList = 0;
 
 static uint32 g_hMasterScript;
 
+//----------------- PRE-DECODED SCRIPTS --------------------
+
+/**
+ * A single pre-decoded instruction. The opcode has already been adjusted for
+ * the engine version, and its operand (if any) fetched and sign extended.
+ */
+struct DecodedInstruction {
+	int32 operand;
+	int nextIp;		///< ip of the following instruction, 0 if not decoded yet
+	byte opcode;
+};
+
+/**
+ * The pre-decoded instructions of a single code handle, indexed by ip.
+ * Instructions are decoded the first time they are executed.
+ */
+struct DecodedScript {
+	Common::Array<DecodedInstruction> instructions;
+	bool hasWorkarounds;	///< whether any workaround fragment targets this code
+};
+
+typedef Common::HashMap<SCNHANDLE, DecodedScript *> DecodedScriptMap;
+
+static DecodedScriptMap *g_decodedScripts = nullptr;
+
 //----------------- SCRIPT BUGS WORKAROUNDS --------------
 
 /**
@@ -233,9 +260,13 @@ const WorkaroundEntry workaroundList[] = {
 	{TINSEL_V0, false, false, Common::kPlatformUnknown, 0, 0, 0, NULL}
 };
 
+static void FreeDecodedScripts();
+
 void ResetVarsPCode() {
 	g_bNoPause = false;
 
+	FreeDecodedScripts();
+
 	free(g_pGlobals);
 	g_pGlobals = nullptr;
 
@@ -247,6 +278,53 @@ void ResetVarsPCode() {
 	g_hMasterScript = 0;
 }
 
+/**
+ * Returns whether the given workaround applies to the running game and code handle.
+ */
+static bool IsWorkaroundFor(const WorkaroundEntry *wkEntry, SCNHANDLE hCode) {
+	return (wkEntry->version == TinselVersion) &&
+		(wkEntry->hCode == hCode) &&
+		(wkEntry->isDemo == _vm->getIsADGFDemo()) &&
+		((wkEntry->platform == Common::kPlatformUnknown) || (wkEntry->platform == _vm->getPlatform())) &&
+		((TinselVersion != 1) || (wkEntry->scnFlag == ((_vm->getFeatures() & GF_SCNFILES) != 0)));
+}
+
+/**
+ * Returns the decoded instruction cache for the given code handle,
+ * creating an empty one if necessary.
+ */
+static DecodedScript *GetDecodedScript(SCNHANDLE hCode) {
+	if (g_decodedScripts == nullptr)
+		g_decodedScripts = new DecodedScriptMap();
+
+	DecodedScriptMap::iterator i = g_decodedScripts->find(hCode);
+	if (i != g_decodedScripts->end())
+		return i->_value;
+
+	DecodedScript *script = new DecodedScript();
+	script->hasWorkarounds = false;
+	for (const WorkaroundEntry *wkEntry = workaroundList; wkEntry->script != NULL; ++wkEntry) {
+		if (IsWorkaroundFor(wkEntry, hCode)) {
+			script->hasWorkarounds = true;
+			break;
+		}
+	}
+
+	(*g_decodedScripts)[hCode] = script;
+	return script;
+}
+
+static void FreeDecodedScripts() {
+	if (g_decodedScripts == nullptr)
+		return;
+
+	for (DecodedScriptMap::iterator i = g_decodedScripts->begin(); i != g_decodedScripts->end(); ++i)
+		delete i->_value;
+
+	delete g_decodedScripts;
+	g_decodedScripts = nullptr;
+}
+
 /**
  * Keeps the code array pointer up to date.
  */
@@ -259,6 +337,9 @@ void LockCode(INT_CONTEXT *ic) {
 			ic->code = (byte *)FindChunk(MASTER_SCNHANDLE, CHUNK_PCODE);
 	} else
 		ic->code = (byte *)_vm->_handle->LockMem(ic->hCode);
+
+	// The master script is always keyed by a null handle
+	ic->decoded = GetDecodedScript(ic->GSort == GS_MASTER ? 0 : ic->hCode);
 }
 
 /**
@@ -486,6 +567,8 @@ void FreeGlobals() {
 
 	free(g_icList);
 	g_icList= nullptr;
+
+	FreeDecodedScripts();
 }
 
 /**
@@ -506,6 +589,7 @@ void INT_CONTEXT::syncWithSerializer(Common::Serializer &s) {
 		pProc= nullptr;
 		code= nullptr;
 		pinvo= nullptr;
+		decoded= nullptr;
 	}
 	// Write out used fields
 	s.syncAsUint32LE(GSort);
@@ -594,6 +678,83 @@ static int32 Fetch(byte opcode, const byte *code, const WorkaroundEntry* &wkEntr
 	return GetBytes(code, wkEntry, ip, 4);
 }
 
+/**
+ * Returns whether the given (masked) opcode is followed by an operand.
+ */
+static bool HasOperand(byte opcode) {
+	switch (opcode) {
+	case OP_IMM:
+	case OP_STR:
+	case OP_FILM:
+	case OP_CDFILM:
+	case OP_FONT:
+	case OP_PAL:
+	case OP_LOAD:
+	case OP_GLOAD:
+	case OP_STORE:
+	case OP_GSTORE:
+	case OP_CALL:
+	case OP_LIBCALL:
+	case OP_ALLOC:
+	case OP_JUMP:
+	case OP_JMPFALSE:
+	case OP_JMPTRUE:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+/**
+ * Fetches the next instruction and its operand from the code stream (or
+ * workaround fragment), adjusting the opcode for the engine version.
+ */
+static byte FetchInstruction(const byte *code, const WorkaroundEntry* &wkEntry, int &ip, int32 &operand) {
+	byte opcode = (byte)GetBytes(code, wkEntry, ip, 0);
+	if ((TinselVersion == 0) && ((opcode & OPMASK) > OP_IMM))
+		opcode += 3;
+
+	if (TinselVersion == 3) {
+		// Discworld Noir adds a NOOP-operation as opcode 0, leaving everything
+		// else 1 higher, so we subtract 1, and add NOOP as the highest opcode instead.
+		opcode -= 1;
+	}
+
+	operand = HasOperand(opcode & OPMASK) ? Fetch(opcode, code, wkEntry, ip) : 0;
+	return opcode;
+}
+
+/**
+ * Returns the pre-decoded instruction at the given ip, decoding it first if
+ * it has not been executed before.
+ */
+static const DecodedInstruction &GetDecodedInstruction(DecodedScript *script, const byte *code, int ip) {
+	if ((uint)ip >= script->instructions.size())
+		script->instructions.resize(ip + 1);
+
+	DecodedInstruction &instr = script->instructions[ip];
+	if (instr.nextIp == 0) {
+		const WorkaroundEntry *wkEntry = nullptr;
+		int nextIp = ip;
+
+		instr.opcode = FetchInstruction(code, wkEntry, nextIp, instr.operand);
+		instr.nextIp = nextIp;
+	} else if (DebugMan.isDebugChannelEnabled(kTinselDebugScripts)) {
+		// Decode the raw PCODE again, and make sure it matches the cached version
+		const WorkaroundEntry *wkEntry = nullptr;
+		int nextIp = ip;
+		int32 operand;
+		byte opcode = FetchInstruction(code, wkEntry, nextIp, operand);
+
+		if (opcode != instr.opcode || operand != instr.operand || nextIp != instr.nextIp)
+			error("Pre-decoded script mismatch at ip=%d: opcode %d/%d, operand %d/%d, next ip %d/%d",
+				ip, instr.opcode, opcode, instr.operand, operand, instr.nextIp, nextIp);
+	}
+
+	return instr;
+}
+
 /**
  * Interprets the PCODE instructions in the code array.
  */
@@ -602,16 +763,13 @@ void Interpret(CORO_PARAM, INT_CONTEXT *ic) {
 		int tmp, tmp2;
 		int ip = ic->ip;
 		const WorkaroundEntry *wkEntry = ic->fragmentPtr;
+		byte opcode;
+		int32 operand;
 
-		if (wkEntry == NULL) {
+		if (wkEntry == NULL && ic->decoded->hasWorkarounds) {
 			// Check to see if a workaround fragment needs to be executed
 			for (wkEntry = workaroundList; wkEntry->script != NULL; ++wkEntry) {
-				if ((wkEntry->version == TinselVersion) &&
-					(wkEntry->hCode == ic->hCode) &&
-					(wkEntry->ip == ip) &&
-					(wkEntry->isDemo == _vm->getIsADGFDemo()) &&
-					((wkEntry->platform == Common::kPlatformUnknown) || (wkEntry->platform == _vm->getPlatform())) &&
-					((TinselVersion != 1) || (wkEntry->scnFlag == ((_vm->getFeatures() & GF_SCNFILES) != 0)))) {
+				if ((wkEntry->ip == ip) && IsWorkaroundFor(wkEntry, ic->hCode)) {
 					// Point to start of workaround fragment
 					ip = 0;
 					break;
@@ -621,14 +779,14 @@ void Interpret(CORO_PARAM, INT_CONTEXT *ic) {
 				wkEntry= nullptr;
 		}
 
-		byte opcode = (byte)GetBytes(ic->code, wkEntry, ip, 0);
-		if ((TinselVersion == 0) && ((opcode & OPMASK) > OP_IMM))
-			opcode += 3;
-
-		if (TinselVersion == 3) {
-			// Discworld Noir adds a NOOP-operation as opcode 0, leaving everything
-			// else 1 higher, so we subtract 1, and add NOOP as the highest opcode instead.
-			opcode -= 1;
+		if (wkEntry == NULL) {
+			// Outside of workaround fragments, run the pre-decoded instructions
+			const DecodedInstruction &instr = GetDecodedInstruction(ic->decoded, ic->code, ip);
+			opcode = instr.opcode;
+			operand = instr.operand;
+			ip = instr.nextIp;
+		} else {
+			opcode = FetchInstruction(ic->code, wkEntry, ip, operand);
 		}
 
 		debug(7, "ip=%d  Opcode %d (-> %d)", ic->ip, opcode, opcode & OPMASK);
@@ -645,7 +803,7 @@ void Interpret(CORO_PARAM, INT_CONTEXT *ic) {
 		case OP_FONT:			// loads font handle onto stack
 		case OP_PAL:			// loads palette handle onto stack
 
-			ic->stack[++ic->sp] = Fetch(opcode, ic->code, wkEntry, ip);
+			ic->stack[++ic->sp] = operand;
 			break;
 
 		case OP_ZERO:			// loads zero onto stack
@@ -662,31 +820,31 @@ void Interpret(CORO_PARAM, INT_CONTEXT *ic) {
 
 		case OP_LOAD:			// loads local variable onto stack
 
-			ic->stack[++ic->sp] = ic->stack[ic->bp + Fetch(opcode, ic->code, wkEntry, ip)];
+			ic->stack[++ic->sp] = ic->stack[ic->bp + operand];
 			break;
 
 		case OP_GLOAD:				// loads global variable onto stack
 
-			tmp = Fetch(opcode, ic->code, wkEntry, ip);
+			tmp = operand;
 			assert(0 <= tmp && tmp < g_numGlobals);
 			ic->stack[++ic->sp] = g_pGlobals[tmp];
 			break;
 
 		case OP_STORE:				// pops stack and stores in local variable
 
-			ic->stack[ic->bp + Fetch(opcode, ic->code, wkEntry, ip)] = ic->stack[ic->sp--];
+			ic->stack[ic->bp + operand] = ic->stack[ic->sp--];
 			break;
 
 		case OP_GSTORE:				// pops stack and stores in global variable
 
-			tmp = Fetch(opcode, ic->code, wkEntry, ip);
+			tmp = operand;
 			assert(0 <= tmp && tmp < g_numGlobals);
 			g_pGlobals[tmp] = ic->stack[ic->sp--];
 			break;
 
 		case OP_CALL:				// procedure call
 
-			tmp = Fetch(opcode, ic->code, wkEntry, ip);
+			tmp = operand;
 			//assert(0 <= tmp && tmp < codeSize);	// TODO: Verify jumps are not out of bounds
 			ic->stack[ic->sp + 1] = 0;	// static link
 			ic->stack[ic->sp + 2] = ic->bp;	// dynamic link
@@ -697,7 +855,7 @@ void Interpret(CORO_PARAM, INT_CONTEXT *ic) {
 
 		case OP_LIBCALL:		// library procedure or function call
 
-			tmp = Fetch(opcode, ic->code, wkEntry, ip);
+			tmp = operand;
 			// NOTE: Interpret() itself is not using the coroutine facilities,
 			// but still accepts a CORO_PARAM, so from the outside it looks
 			// like a coroutine. In fact it may still acts as a kind of "proxy"
@@ -736,18 +894,18 @@ void Interpret(CORO_PARAM, INT_CONTEXT *ic) {
 
 		case OP_ALLOC:			// allocate storage on stack
 
-			ic->sp += (int32)Fetch(opcode, ic->code, wkEntry, ip);
+			ic->sp += (int32)operand;
 			break;
 
 		case OP_JUMP:	// unconditional jump
 
-			ip = Fetch(opcode, ic->code, wkEntry, ip);
+			ip = operand;
 			wkEntry= nullptr;					// In case a jump occurs from a workaround
 			break;
 
 		case OP_JMPFALSE:	// conditional jump
 
-			tmp = Fetch(opcode, ic->code, wkEntry, ip);
+			tmp = operand;
 			if (ic->stack[ic->sp--] == 0) {
 				// condition satisfied - do the jump
 				ip = tmp;
@@ -757,7 +915,7 @@ void Interpret(CORO_PARAM, INT_CONTEXT *ic) {
 
 		case OP_JMPTRUE:	// conditional jump
 
-			tmp = Fetch(opcode, ic->code, wkEntry, ip);
+			tmp = operand;
 			if (ic->stack[ic->sp--] != 0) {
 				// condition satisfied - do the jump
 				ip = tmp;
@@ -50,6 +50,7 @@ enum GSORT {
 enum RESCODE {RES_WAITING, RES_FINISHED, RES_CUTSHORT};
 
 struct WorkaroundEntry;
+struct DecodedScript;
 
 struct INT_CONTEXT {
 
@@ -82,6 +83,9 @@ struct INT_CONTEXT {
 	// Used to store execution state within a script workaround fragment
 	const WorkaroundEntry *fragmentPtr;
 
+	// Pre-decoded instructions of the code being executed
+	DecodedScript *decoded;
+
 	void syncWithSerializer(Common::Serializer &s);
 };
 
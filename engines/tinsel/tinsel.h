@@ -73,7 +73,8 @@ enum {
 	kTinselDebugAnimations = 1 << 0,
 	kTinselDebugActions = 1 << 1,
 	kTinselDebugSound = 1 << 2,
-	kTinselDebugMusic = 2 << 3
+	kTinselDebugMusic = 2 << 3,
+	kTinselDebugScripts = 1 << 5
 };
 
 #define DEBUG_BASIC 1
@@ -20,15 +20,42 @@
  */
 
 #include "toon/console.h"
+#include "toon/path.h"
+#include "toon/picture.h"
 #include "toon/toon.h"
 
 namespace Toon {
 
 ToonConsole::ToonConsole(ToonEngine *vm) : GUI::Debugger(), _vm(vm) {
 	assert(_vm);
+
+#ifndef RELEASE_BUILD
+	registerCmd("pathbench", WRAP_METHOD(ToonConsole, Cmd_PathBench));
+#endif
 }
 
 ToonConsole::~ToonConsole() {
 }
 
+#ifndef RELEASE_BUILD
+bool ToonConsole::Cmd_PathBench(int argc, const char **argv) {
+	uint routes = argc > 1 ? atoi(argv[1]) : 100;
+	if (routes == 0) {
+		debugPrintf("Usage: %s [<routes>]\n", argv[0]);
+		return true;
+	}
+
+	if (!_vm->getMask() || !_vm->getMask()->getDataPtr()) {
+		debugPrintf("No walk mask loaded\n");
+		return true;
+	}
+
+	uint32 time, referenceTime;
+	bool identical = _vm->getPathFinding()->benchmark(routes, time, referenceTime);
+	debugPrintf("%d routes: %d ms, original search %d ms, paths %s\n", routes, time, referenceTime,
+		identical ? "identical" : "DIFFERENT");
+	return true;
+}
+#endif
+
 } // End of namespace Toon
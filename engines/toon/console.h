@@ -35,6 +35,10 @@ public:
 
 private:
 	ToonEngine *_vm;
+
+#ifndef RELEASE_BUILD
+	bool Cmd_PathBench(int argc, const char **argv);
+#endif
 };
 
 } // End of namespace Toon
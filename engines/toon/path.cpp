@@ -27,6 +27,8 @@
  */
 
 #include "common/debug.h"
+#include "common/random.h"
+#include "common/system.h"
 
 #include "toon/path.h"
 
@@ -165,6 +167,11 @@ PathFinding::PathFinding() : _blockingRects{{0}} {
 	_numBlockingRects = 0;
 
 	_currentMask = nullptr;
+
+	_costs = nullptr;
+	_costsValid = false;
+	_costsMaskRevision = 0;
+	_numAppliedBlockingRects = 0;
 }
 
 PathFinding::~PathFinding(void) {
@@ -172,6 +179,7 @@ PathFinding::~PathFinding(void) {
 		_heap->unload();
 	delete _heap;
 	delete[] _sq;
+	delete[] _costs;
 }
 
 void PathFinding::init(Picture *mask) {
@@ -184,6 +192,63 @@ void PathFinding::init(Picture *mask) {
 	_heap->init(500);
 	delete[] _sq;
 	_sq = new uint16[_width * _height];
+	delete[] _costs;
+	_costs = new uint8[_width * _height];
+	_costsValid = false;
+}
+
+void PathFinding::updateCosts() {
+	if (!_costsValid || _costsMaskRevision != _currentMask->getRevision()) {
+		const uint8 *data = _currentMask->getDataPtr();
+		for (int32 i = 0; i < _width * _height; i++)
+			_costs[i] = (data && (data[i] & 0x1f)) ? kCostWalkable : kCostBlocked;
+
+		_costsValid = true;
+		_costsMaskRevision = _currentMask->getRevision();
+		_numAppliedBlockingRects = 0;
+	}
+
+	if (_numAppliedBlockingRects == _numBlockingRects &&
+		!memcmp(_appliedBlockingRects, _blockingRects, sizeof(_blockingRects[0]) * _numBlockingRects))
+		return;
+
+	// Refresh the cells covered by the previous blocking rects, then the new ones
+	for (uint8 i = 0; i < _numAppliedBlockingRects; i++)
+		updateCostsInRect(_appliedBlockingRects[i]);
+	for (uint8 i = 0; i < _numBlockingRects; i++)
+		updateCostsInRect(_blockingRects[i]);
+
+	memcpy(_appliedBlockingRects, _blockingRects, sizeof(_blockingRects[0]) * _numBlockingRects);
+	_numAppliedBlockingRects = _numBlockingRects;
+}
+
+void PathFinding::updateCostsInRect(const int16 *rect) {
+	int16 x1, y1, x2, y2;
+	if (rect[4] == 0) {
+		x1 = rect[0];
+		y1 = rect[1];
+		x2 = rect[2];
+		y2 = rect[3] - 1;
+	} else {
+		// bounding box of the ellipse, see isLikelyWalkable()
+		x1 = rect[2] > 0 ? rect[0] - rect[2] : 0;
+		x2 = rect[2] > 0 ? rect[0] + rect[2] : _width - 1;
+		y1 = rect[3] > 0 ? rect[1] - rect[3] : 0;
+		y2 = rect[3] > 0 ? rect[1] + rect[3] : _height - 1;
+	}
+
+	x1 = MAX<int16>(x1, 0);
+	y1 = MAX<int16>(y1, 0);
+	x2 = MIN<int16>(x2, _width - 1);
+	y2 = MIN<int16>(y2, _height - 1);
+
+	for (int16 y = y1; y <= y2; y++) {
+		uint8 *costs = &_costs[y * _width];
+		for (int16 x = x1; x <= x2; x++) {
+			if (costs[x] != kCostBlocked)
+				costs[x] = isLikelyWalkable(x, y) ? kCostWalkable : kCostBlockingRect;
+		}
+	}
 }
 
 bool PathFinding::isLikelyWalkable(int16 x, int16 y) {
@@ -220,9 +285,11 @@ bool PathFinding::findClosestWalkingPoint(int16 xx, int16 yy, int16 *fxx, int16
 	if (origY == -1)
 		origY = yy;
 
+	updateCosts();
+
 	for (int16 y = 0; y < _height; y++) {
 		for (int16 x = 0; x < _width; x++) {
-			if (isWalkable(x, y) && isLikelyWalkable(x, y)) {
+			if (_costs[y * _width + x] == kCostWalkable) {
 				int32 ndist = (x - xx) * (x - xx) + (y - yy) * (y - yy);
 				int32 ndist2 = (x - origX) * (x - origX) + (y - origY) * (y - origY);
 				if (currentFound < 0 || ndist < dist || (ndist == dist && ndist2 < dist2)) {
@@ -316,6 +383,86 @@ bool PathFinding::findPath(int16 x, int16 y, int16 destx, int16 desty) {
 		return true;
 	}
 
+	// No direct line: compute the walking distances from the start with
+	// Dijkstra's algorithm. All the step costs are small, so the open nodes
+	// are kept in buckets by distance. Unlike the original search, this stops
+	// once every node up to the distance of the destination is known, which
+	// is all that buildPath() looks at.
+	updateCosts();
+	memset(_sq, 0, _width * _height * sizeof(uint16));
+	for (int i = 0; i < kNumBuckets; i++)
+		_buckets[i].clear();
+
+	const int32 destNode = destx + desty * _width;
+	_sq[x + y * _width] = 1;
+	_buckets[1].push_back(x + y * _width);
+	uint32 numPending = 1;
+
+	for (uint32 dist = 1; numPending; dist++) {
+		if (_sq[destNode] && dist > _sq[destNode])
+			break;
+
+		Common::Array<int32> &bucket = _buckets[dist % kNumBuckets];
+		for (uint32 i = 0; i < bucket.size(); i++) {
+			const int32 curNode = bucket[i];
+			if (_sq[curNode] != dist)
+				continue; // found a shorter way since
+
+			const int16 curX = curNode % _width;
+			const int16 curY = curNode / _width;
+			const int16 endX = MIN<int16>(curX + 1, _width - 1);
+			const int16 endY = MIN<int16>(curY + 1, _height - 1);
+			const int16 startX = MAX<int16>(curX - 1, 0);
+			const int16 startY = MAX<int16>(curY - 1, 0);
+
+			for (int16 px = startX; px <= endX; px++) {
+				for (int16 py = startY; py <= endY; py++) {
+					const int32 curPNode = px + py * _width;
+					if (curPNode == curNode || _costs[curPNode] == kCostBlocked)
+						continue;
+
+					uint32 sum = dist + (abs(px - curX) + abs(py - curY)) * _costs[curPNode];
+					if (sum > (uint32)0xFFFF) {
+						warning("PathFinding::findPath sum exceeds maximum representable!");
+						sum = (uint32)0xFFFF;
+					}
+					if (_sq[curPNode] > sum || !_sq[curPNode]) {
+						_sq[curPNode] = sum;
+						_buckets[sum % kNumBuckets].push_back(curPNode);
+						numPending++;
+					}
+				}
+			}
+		}
+
+		numPending -= bucket.size();
+		bucket.clear();
+	}
+
+	return buildPath(x, y, destx, desty);
+}
+
+#ifndef RELEASE_BUILD
+bool PathFinding::findPathReference(int16 x, int16 y, int16 destx, int16 desty) {
+	debugC(1, kDebugPath, "findPathReference(%d, %d, %d, %d)", x, y, destx, desty);
+
+	if (x == destx && y == desty) {
+		_tempPath.clear();
+		return true;
+	}
+
+	// ignore path finding if the character is outside the screen
+	if (x < 0 || x > 1280 || y < 0 || y > 400 || destx < 0 || destx > 1280 || desty < 0 || desty > 400) {
+		_tempPath.clear();
+		return true;
+	}
+
+	// first test direct line
+	if (lineIsWalkable(x, y, destx, desty)) {
+		walkLine(x, y, destx, desty);
+		return true;
+	}
+
 	// no direct line, we use the standard A* algorithm
 	memset(_sq , 0, _width * _height * sizeof(uint16));
 	_heap->clear();
@@ -365,6 +512,11 @@ bool PathFinding::findPath(int16 x, int16 y, int16 destx, int16 desty) {
 		}
 	}
 
+	return buildPath(x, y, destx, desty);
+}
+#endif
+
+bool PathFinding::buildPath(int16 x, int16 y, int16 destx, int16 desty) {
 	// let's see if we found a result !
 	if (!_sq[destx + desty * _width]) {
 		// didn't find anything
@@ -372,8 +524,8 @@ bool PathFinding::findPath(int16 x, int16 y, int16 destx, int16 desty) {
 		return false;
 	}
 
-	curX = destx;
-	curY = desty;
+	int16 curX = destx;
+	int16 curY = desty;
 
 	Common::Array<Common::Point> retPath;
 	retPath.push_back(Common::Point(curX, curY));
@@ -426,6 +578,41 @@ bool PathFinding::findPath(int16 x, int16 y, int16 destx, int16 desty) {
 	return retVal;
 }
 
+#ifndef RELEASE_BUILD
+bool PathFinding::benchmark(uint routes, uint32 &time, uint32 &referenceTime) {
+	Common::Array<Common::Point> points;
+	Common::RandomSource rnd("toonPathBenchmark");
+	while (points.size() < routes * 2) {
+		int16 x = rnd.getRandomNumber(_width - 1);
+		int16 y = rnd.getRandomNumber(_height - 1);
+		if (isWalkable(x, y))
+			points.push_back(Common::Point(x, y));
+	}
+
+	Common::Array<Common::Array<Common::Point> > paths;
+	uint32 start = g_system->getMillis();
+	for (uint i = 0; i < routes; i++) {
+		_tempPath.clear();
+		findPath(points[i * 2].x, points[i * 2].y, points[i * 2 + 1].x, points[i * 2 + 1].y);
+		paths.push_back(_tempPath);
+	}
+	time = g_system->getMillis() - start;
+
+	bool identical = true;
+	start = g_system->getMillis();
+	for (uint i = 0; i < routes; i++) {
+		_tempPath.clear();
+		findPathReference(points[i * 2].x, points[i * 2].y, points[i * 2 + 1].x, points[i * 2 + 1].y);
+		if (paths[i] != _tempPath)
+			identical = false;
+	}
+	referenceTime = g_system->getMillis() - start;
+
+	_tempPath.clear();
+	return identical;
+}
+#endif
+
 void PathFinding::addBlockingRect(int16 x1, int16 y1, int16 x2, int16 y2) {
 	debugC(1, kDebugPath, "addBlockingRect(%d, %d, %d, %d)", x1, y1, x2, y2);
 	if (_numBlockingRects >= kMaxBlockingRects) {
@@ -69,6 +69,13 @@ public:
 	void init(Picture *mask);
 
 	bool findPath(int16 x, int16 y, int16 destX, int16 destY);
+#ifndef RELEASE_BUILD
+	// The original A* search, which explores the whole walkable area.
+	// Only used to check findPath() against it.
+	bool findPathReference(int16 x, int16 y, int16 destX, int16 destY);
+	// Runs random routes through both searches, returns true if all the paths match
+	bool benchmark(uint routes, uint32 &time, uint32 &referenceTime);
+#endif
 	bool findClosestWalkingPoint(int16 xx, int16 yy, int16 *fxx, int16 *fyy, int16 origX = -1, int16 origY = -1);
 	bool isWalkable(int16 x, int16 y);
 	bool isLikelyWalkable(int16 x, int16 y);
@@ -86,6 +93,16 @@ public:
 private:
 	static const uint8 kMaxBlockingRects = 16;
 
+	// Cost of a step onto a cell, multiplied by 2 for diagonal steps.
+	// As in the original game, cells inside a blocking rect are cheaper.
+	enum {
+		kCostBlocked = 0,
+		kCostBlockingRect = 1,
+		kCostWalkable = 6,
+		// one more than the most expensive step
+		kNumBuckets = 2 * kCostWalkable + 1
+	};
+
 	Picture *_currentMask;
 
 	PathFindingHeap *_heap;
@@ -98,6 +115,19 @@ private:
 
 	int16 _blockingRects[kMaxBlockingRects][5];
 	uint8 _numBlockingRects;
+
+	// Step costs of the mask with the blocking rects applied
+	uint8 *_costs;
+	bool _costsValid;
+	uint32 _costsMaskRevision;
+	int16 _appliedBlockingRects[kMaxBlockingRects][5];
+	uint8 _numAppliedBlockingRects;
+	// Nodes to visit, by distance modulo kNumBuckets
+	Common::Array<int32> _buckets[kNumBuckets];
+
+	void updateCosts();
+	void updateCostsInRect(const int16 *rect);
+	bool buildPath(int16 x, int16 y, int16 destX, int16 destY);
 };
 
 } // End of namespace Toon
@@ -44,6 +44,7 @@ bool Picture::loadPicture(const Common::Path &file) {
 	if (!fileData)
 		return false;
 
+	_revision++;
 	uint32 compId = READ_BE_UINT32(fileData);
 
 	switch (compId) {
@@ -149,6 +150,7 @@ Picture::Picture(ToonEngine *vm) : _vm(vm) {
 	_height = 0;
 	_paletteEntries = 0;
 	_useFullPalette = false;
+	_revision = 0;
 }
 
 Picture::~Picture() {
@@ -287,6 +289,7 @@ void Picture::floodFillNotWalkableOnMask(int16 x, int16 y) {
 	debugC(1, kDebugPicture, "floodFillNotWalkableOnMask(%d, %d)", x, y);
 	// Stack-based floodFill algorithm based on
 	// https://web.archive.org/web/20100825020453/http://student.kuleuven.be/~m0216922/CG/files/floodfill.cpp
+	_revision++;
 	Common::Stack<Common::Point> stack;
 	stack.push(Common::Point(x, y));
 	while (!stack.empty()) {
@@ -319,6 +322,7 @@ void Picture::floodFillNotWalkableOnMask(int16 x, int16 y) {
 
 void Picture::drawLineOnMask(int16 x, int16 y, int16 x2, int16 y2, bool walkable) {
 	debugC(1, kDebugPicture, "drawLineOnMask(%d, %d, %d, %d, %d)", x, y, x2, y2, (walkable) ? 1 : 0);
+	_revision++;
 	static int16 lastX = 0;
 	static int16 lastY = 0;
 
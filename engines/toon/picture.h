@@ -56,6 +56,8 @@ public:
 	uint8 *getDataPtr() { return _data; }
 	int16 getWidth() const { return _width; }
 	int16 getHeight() const { return _height; }
+	// Increased every time the picture data changes
+	uint32 getRevision() const { return _revision; }
 
 protected:
 	int16 _width;
@@ -64,6 +66,7 @@ protected:
 	uint8 *_palette; // need to be copied at 3-387
 	int32 _paletteEntries;
 	bool _useFullPalette;
+	uint32 _revision;
 
 	ToonEngine *_vm;
 };
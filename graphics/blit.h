@@ -30,6 +30,7 @@ struct Point;
 }
 
 class BlendBlitUnfilteredTestSuite;
+class CrossFadeTestSuite;
 
 namespace Graphics {
 
@@ -372,6 +373,71 @@ public:
 
 }; // End of class BlendBlit
 
+// This is a class so that we can declare certain things as private
+class CrossFade {
+private:
+	struct Args {
+		byte *dst;
+		const byte *src1, *src2;
+		uint dstPitch, src1Pitch, src2Pitch;
+		uint width, height;
+		uint alpha;
+	};
+
+	// Blend a single RGB565 pixel, all the implementations use this for the remaining pixels of a row
+	static inline uint16 blendPixel565(uint16 p1, uint16 p2, uint alpha) {
+		uint r1 = ColorComponent<5>::expand(p1 >> 11), g1 = ColorComponent<6>::expand(p1 >> 5), b1 = ColorComponent<5>::expand(p1);
+		uint r2 = ColorComponent<5>::expand(p2 >> 11), g2 = ColorComponent<6>::expand(p2 >> 5), b2 = ColorComponent<5>::expand(p2);
+
+		uint r = (r1 * alpha + r2 * (255 - alpha)) / 255;
+		uint g = (g1 * alpha + g2 * (255 - alpha)) / 255;
+		uint b = (b1 * alpha + b2 * (255 - alpha)) / 255;
+
+		return (uint16)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+	}
+
+#ifdef SCUMMVM_NEON
+	static void blend565NEON(const Args &args);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void blend565SSE2(const Args &args);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void blend565AVX2(const Args &args);
+#endif
+	static void blend565Generic(const Args &args);
+	static void blendGeneric(const Args &args, const PixelFormat &format);
+
+	typedef void(*BlendFunc)(const Args &);
+	static BlendFunc blend565Func;
+	friend class ::CrossFadeTestSuite;
+
+public:
+	/**
+	 * Blend two 16bpp images with a constant alpha.
+	 *
+	 * Each color component of the destination is set to
+	 * (src1 * alpha + src2 * (255 - alpha)) / 255.
+	 * RGB565 images use a SIMD implementation when the CPU supports it.
+	 *
+	 * @param dst a pointer to the destination buffer, can be one of the sources
+	 * @param src1 a pointer to the first source buffer
+	 * @param src2 a pointer to the second source buffer
+	 * @param dstPitch destination pitch
+	 * @param src1Pitch first source pitch
+	 * @param src2Pitch second source pitch
+	 * @param width width of the images
+	 * @param height height of the images
+	 * @param alpha weight of the first source, from 0 to 255
+	 * @param format pixel format of the three buffers
+	 */
+	static void blend(byte *dst, const byte *src1, const byte *src2,
+			  const uint dstPitch, const uint src1Pitch, const uint src2Pitch,
+			  const uint width, const uint height,
+			  const uint alpha, const PixelFormat &format);
+
+}; // End of class CrossFade
+
 /** @} */
 } // End of namespace Graphics
 
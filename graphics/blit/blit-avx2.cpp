@@ -305,6 +305,57 @@ void BlendBlit::blitAVX2(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_AVX2>(args, blendMode, alphaType);
 }
 
+void CrossFade::blend565AVX2(const Args &args) {
+	const __m256i alpha1 = _mm256_set1_epi16((int16)args.alpha);
+	const __m256i alpha2 = _mm256_set1_epi16((int16)(255 - args.alpha));
+	const __m256i mask5 = _mm256_set1_epi16(0x1f);
+	const __m256i mask6 = _mm256_set1_epi16(0x3f);
+	const __m256i one = _mm256_set1_epi16(1);
+
+	for (uint y = 0; y < args.height; y++) {
+		const uint16 *src1 = (const uint16 *)(args.src1 + y * args.src1Pitch);
+		const uint16 *src2 = (const uint16 *)(args.src2 + y * args.src2Pitch);
+		uint16 *dst = (uint16 *)(args.dst + y * args.dstPitch);
+
+		uint x = 0;
+		for (; x + 16 <= args.width; x += 16) {
+			__m256i p1 = _mm256_loadu_si256((const __m256i *)(src1 + x));
+			__m256i p2 = _mm256_loadu_si256((const __m256i *)(src2 + x));
+
+			// Split and expand to 8 bits per component
+			__m256i r1 = _mm256_srli_epi16(p1, 11);
+			__m256i g1 = _mm256_and_si256(_mm256_srli_epi16(p1, 5), mask6);
+			__m256i b1 = _mm256_and_si256(p1, mask5);
+			__m256i r2 = _mm256_srli_epi16(p2, 11);
+			__m256i g2 = _mm256_and_si256(_mm256_srli_epi16(p2, 5), mask6);
+			__m256i b2 = _mm256_and_si256(p2, mask5);
+			r1 = _mm256_or_si256(_mm256_slli_epi16(r1, 3), _mm256_srli_epi16(r1, 2));
+			g1 = _mm256_or_si256(_mm256_slli_epi16(g1, 2), _mm256_srli_epi16(g1, 4));
+			b1 = _mm256_or_si256(_mm256_slli_epi16(b1, 3), _mm256_srli_epi16(b1, 2));
+			r2 = _mm256_or_si256(_mm256_slli_epi16(r2, 3), _mm256_srli_epi16(r2, 2));
+			g2 = _mm256_or_si256(_mm256_slli_epi16(g2, 2), _mm256_srli_epi16(g2, 4));
+			b2 = _mm256_or_si256(_mm256_slli_epi16(b2, 3), _mm256_srli_epi16(b2, 2));
+
+			// The weighted sums are at most 255 * 255, which fits in 16 bits
+			__m256i r = _mm256_add_epi16(_mm256_mullo_epi16(r1, alpha1), _mm256_mullo_epi16(r2, alpha2));
+			__m256i g = _mm256_add_epi16(_mm256_mullo_epi16(g1, alpha1), _mm256_mullo_epi16(g2, alpha2));
+			__m256i b = _mm256_add_epi16(_mm256_mullo_epi16(b1, alpha1), _mm256_mullo_epi16(b2, alpha2));
+
+			// Exact division by 255: (v + 1 + (v >> 8)) >> 8
+			r = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(r, one), _mm256_srli_epi16(r, 8)), 8);
+			g = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(g, one), _mm256_srli_epi16(g, 8)), 8);
+			b = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(b, one), _mm256_srli_epi16(b, 8)), 8);
+
+			__m256i out = _mm256_or_si256(_mm256_slli_epi16(_mm256_srli_epi16(r, 3), 11),
+			              _mm256_or_si256(_mm256_slli_epi16(_mm256_srli_epi16(g, 2), 5), _mm256_srli_epi16(b, 3)));
+			_mm256_storeu_si256((__m256i *)(dst + x), out);
+		}
+
+		for (; x < args.width; x++)
+			dst[x] = blendPixel565(src1[x], src2[x], args.alpha);
+	}
+}
+
 } // End of namespace Graphics
 
 #ifdef __GNUC__
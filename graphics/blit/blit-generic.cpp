@@ -22,6 +22,8 @@
 #include "graphics/blit/blit-alpha.h"
 #include "graphics/pixelformat.h"
 
+#include "common/system.h"
+
 namespace Graphics {
 
 class BlendBlitImpl_Default : public BlendBlitImpl_Base {
@@ -181,4 +183,81 @@ void BlendBlit::blitGeneric(Args &args, const TSpriteBlendMode &blendMode, const
 	blitT<BlendBlitImpl_Default>(args, blendMode, alphaType);
 }
 
+void CrossFade::blend565Generic(const Args &args) {
+	for (uint y = 0; y < args.height; y++) {
+		const uint16 *src1 = (const uint16 *)(args.src1 + y * args.src1Pitch);
+		const uint16 *src2 = (const uint16 *)(args.src2 + y * args.src2Pitch);
+		uint16 *dst = (uint16 *)(args.dst + y * args.dstPitch);
+
+		for (uint x = 0; x < args.width; x++)
+			dst[x] = blendPixel565(src1[x], src2[x], args.alpha);
+	}
+}
+
+void CrossFade::blendGeneric(const Args &args, const PixelFormat &format) {
+	for (uint y = 0; y < args.height; y++) {
+		const uint16 *src1 = (const uint16 *)(args.src1 + y * args.src1Pitch);
+		const uint16 *src2 = (const uint16 *)(args.src2 + y * args.src2Pitch);
+		uint16 *dst = (uint16 *)(args.dst + y * args.dstPitch);
+
+		for (uint x = 0; x < args.width; x++) {
+			uint8 r1, g1, b1, r2, g2, b2;
+			format.colorToRGB(src1[x], r1, g1, b1);
+			format.colorToRGB(src2[x], r2, g2, b2);
+
+			uint r = (r1 * args.alpha + r2 * (255 - args.alpha)) / 255;
+			uint g = (g1 * args.alpha + g2 * (255 - args.alpha)) / 255;
+			uint b = (b1 * args.alpha + b2 * (255 - args.alpha)) / 255;
+
+			dst[x] = (uint16)format.RGBToColor(r, g, b);
+		}
+	}
+}
+
+// Initialize this to nullptr at the start
+CrossFade::BlendFunc CrossFade::blend565Func = nullptr;
+
+void CrossFade::blend(byte *dst, const byte *src1, const byte *src2,
+					  const uint dstPitch, const uint src1Pitch, const uint src2Pitch,
+					  const uint width, const uint height,
+					  const uint alpha, const PixelFormat &format) {
+	if (width == 0 || height == 0)
+		return;
+
+	assert(format.bytesPerPixel == 2);
+	assert(alpha <= 255);
+
+	Args args;
+	args.dst = dst;
+	args.src1 = src1;
+	args.src2 = src2;
+	args.dstPitch = dstPitch;
+	args.src1Pitch = src1Pitch;
+	args.src2Pitch = src2Pitch;
+	args.width = width;
+	args.height = height;
+	args.alpha = alpha;
+
+	if (format != PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0)) {
+		blendGeneric(args, format);
+		return;
+	}
+
+	// If no function has been selected yet, detect and select
+	if (!blend565Func) {
+		blend565Func = blend565Generic;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) blend565Func = blend565NEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) blend565Func = blend565SSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) blend565Func = blend565AVX2;
+#endif
+	}
+
+	blend565Func(args);
+}
+
 } // End of namespace Graphics
@@ -308,6 +308,57 @@ void BlendBlit::blitNEON(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_NEON>(args, blendMode, alphaType);
 }
 
+void CrossFade::blend565NEON(const Args &args) {
+	const uint16x8_t alpha1 = vdupq_n_u16(args.alpha);
+	const uint16x8_t alpha2 = vdupq_n_u16(255 - args.alpha);
+	const uint16x8_t mask5 = vdupq_n_u16(0x1f);
+	const uint16x8_t mask6 = vdupq_n_u16(0x3f);
+	const uint16x8_t one = vdupq_n_u16(1);
+
+	for (uint y = 0; y < args.height; y++) {
+		const uint16 *src1 = (const uint16 *)(args.src1 + y * args.src1Pitch);
+		const uint16 *src2 = (const uint16 *)(args.src2 + y * args.src2Pitch);
+		uint16 *dst = (uint16 *)(args.dst + y * args.dstPitch);
+
+		uint x = 0;
+		for (; x + 8 <= args.width; x += 8) {
+			uint16x8_t p1 = vld1q_u16(src1 + x);
+			uint16x8_t p2 = vld1q_u16(src2 + x);
+
+			// Split and expand to 8 bits per component
+			uint16x8_t r1 = vshrq_n_u16(p1, 11);
+			uint16x8_t g1 = vandq_u16(vshrq_n_u16(p1, 5), mask6);
+			uint16x8_t b1 = vandq_u16(p1, mask5);
+			uint16x8_t r2 = vshrq_n_u16(p2, 11);
+			uint16x8_t g2 = vandq_u16(vshrq_n_u16(p2, 5), mask6);
+			uint16x8_t b2 = vandq_u16(p2, mask5);
+			r1 = vorrq_u16(vshlq_n_u16(r1, 3), vshrq_n_u16(r1, 2));
+			g1 = vorrq_u16(vshlq_n_u16(g1, 2), vshrq_n_u16(g1, 4));
+			b1 = vorrq_u16(vshlq_n_u16(b1, 3), vshrq_n_u16(b1, 2));
+			r2 = vorrq_u16(vshlq_n_u16(r2, 3), vshrq_n_u16(r2, 2));
+			g2 = vorrq_u16(vshlq_n_u16(g2, 2), vshrq_n_u16(g2, 4));
+			b2 = vorrq_u16(vshlq_n_u16(b2, 3), vshrq_n_u16(b2, 2));
+
+			// The weighted sums are at most 255 * 255, which fits in 16 bits
+			uint16x8_t r = vaddq_u16(vmulq_u16(r1, alpha1), vmulq_u16(r2, alpha2));
+			uint16x8_t g = vaddq_u16(vmulq_u16(g1, alpha1), vmulq_u16(g2, alpha2));
+			uint16x8_t b = vaddq_u16(vmulq_u16(b1, alpha1), vmulq_u16(b2, alpha2));
+
+			// Exact division by 255: (v + 1 + (v >> 8)) >> 8
+			r = vshrq_n_u16(vaddq_u16(vaddq_u16(r, one), vshrq_n_u16(r, 8)), 8);
+			g = vshrq_n_u16(vaddq_u16(vaddq_u16(g, one), vshrq_n_u16(g, 8)), 8);
+			b = vshrq_n_u16(vaddq_u16(vaddq_u16(b, one), vshrq_n_u16(b, 8)), 8);
+
+			uint16x8_t out = vorrq_u16(vshlq_n_u16(vshrq_n_u16(r, 3), 11),
+			                 vorrq_u16(vshlq_n_u16(vshrq_n_u16(g, 2), 5), vshrq_n_u16(b, 3)));
+			vst1q_u16(dst + x, out);
+		}
+
+		for (; x < args.width; x++)
+			dst[x] = blendPixel565(src1[x], src2[x], args.alpha);
+	}
+}
+
 } // end of namespace Graphics
 
 #ifdef __GNUC__
@@ -311,6 +311,57 @@ void BlendBlit::blitSSE2(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_SSE2>(args, blendMode, alphaType);
 }
 
+void CrossFade::blend565SSE2(const Args &args) {
+	const __m128i alpha1 = _mm_set1_epi16((int16)args.alpha);
+	const __m128i alpha2 = _mm_set1_epi16((int16)(255 - args.alpha));
+	const __m128i mask5 = _mm_set1_epi16(0x1f);
+	const __m128i mask6 = _mm_set1_epi16(0x3f);
+	const __m128i one = _mm_set1_epi16(1);
+
+	for (uint y = 0; y < args.height; y++) {
+		const uint16 *src1 = (const uint16 *)(args.src1 + y * args.src1Pitch);
+		const uint16 *src2 = (const uint16 *)(args.src2 + y * args.src2Pitch);
+		uint16 *dst = (uint16 *)(args.dst + y * args.dstPitch);
+
+		uint x = 0;
+		for (; x + 8 <= args.width; x += 8) {
+			__m128i p1 = _mm_loadu_si128((const __m128i *)(src1 + x));
+			__m128i p2 = _mm_loadu_si128((const __m128i *)(src2 + x));
+
+			// Split and expand to 8 bits per component
+			__m128i r1 = _mm_srli_epi16(p1, 11);
+			__m128i g1 = _mm_and_si128(_mm_srli_epi16(p1, 5), mask6);
+			__m128i b1 = _mm_and_si128(p1, mask5);
+			__m128i r2 = _mm_srli_epi16(p2, 11);
+			__m128i g2 = _mm_and_si128(_mm_srli_epi16(p2, 5), mask6);
+			__m128i b2 = _mm_and_si128(p2, mask5);
+			r1 = _mm_or_si128(_mm_slli_epi16(r1, 3), _mm_srli_epi16(r1, 2));
+			g1 = _mm_or_si128(_mm_slli_epi16(g1, 2), _mm_srli_epi16(g1, 4));
+			b1 = _mm_or_si128(_mm_slli_epi16(b1, 3), _mm_srli_epi16(b1, 2));
+			r2 = _mm_or_si128(_mm_slli_epi16(r2, 3), _mm_srli_epi16(r2, 2));
+			g2 = _mm_or_si128(_mm_slli_epi16(g2, 2), _mm_srli_epi16(g2, 4));
+			b2 = _mm_or_si128(_mm_slli_epi16(b2, 3), _mm_srli_epi16(b2, 2));
+
+			// The weighted sums are at most 255 * 255, which fits in 16 bits
+			__m128i r = _mm_add_epi16(_mm_mullo_epi16(r1, alpha1), _mm_mullo_epi16(r2, alpha2));
+			__m128i g = _mm_add_epi16(_mm_mullo_epi16(g1, alpha1), _mm_mullo_epi16(g2, alpha2));
+			__m128i b = _mm_add_epi16(_mm_mullo_epi16(b1, alpha1), _mm_mullo_epi16(b2, alpha2));
+
+			// Exact division by 255: (v + 1 + (v >> 8)) >> 8
+			r = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(r, one), _mm_srli_epi16(r, 8)), 8);
+			g = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(g, one), _mm_srli_epi16(g, 8)), 8);
+			b = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(b, one), _mm_srli_epi16(b, 8)), 8);
+
+			__m128i out = _mm_or_si128(_mm_slli_epi16(_mm_srli_epi16(r, 3), 11),
+			              _mm_or_si128(_mm_slli_epi16(_mm_srli_epi16(g, 2), 5), _mm_srli_epi16(b, 3)));
+			_mm_storeu_si128((__m128i *)(dst + x), out);
+		}
+
+		for (; x < args.width; x++)
+			dst[x] = blendPixel565(src1[x], src2[x], args.alpha);
+	}
+}
+
 } // End of namespace Graphics
 
 #ifdef __GNUC__
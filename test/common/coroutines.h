@@ -0,0 +1,244 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/coroutines.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+/**
+ * Stress test for the coroutine scheduler.
+ *
+ * A deterministic workload of a few thousand short-lived processes and
+ * events is run through the scheduler, and every step taken by every
+ * process is folded into a hash. The expected hash was recorded with the
+ * original list based scheduler, so any change to the dispatch order,
+ * event wake-up order or process kill order makes this test fail.
+ */
+namespace CoroutineStress {
+
+enum {
+	NUM_TICKS = 3000,
+	MAX_LIVE = 90,
+	NUM_STATIC_EVENTS = 8,
+	NUM_TRANSIENT_EVENTS = 64,
+	FIXED_PID_BASE = 0x10000,
+	FIXED_PID_RANGE = 48
+};
+
+struct WorkerParam {
+	uint32 seed;
+	int loops;
+};
+
+static uint32 s_hash;
+static uint32 s_steps;
+static uint32 s_tick;
+static uint32 s_rnd;
+static int s_live;
+static int s_spawned;
+static uint32 s_staticEvents[NUM_STATIC_EVENTS];
+static uint32 s_transientEvents[NUM_TRANSIENT_EVENTS];
+
+static uint32 nextRandom(uint32 &state) {
+	state = state * 1103515245 + 12345;
+	return (state >> 8) & 0xFFFF;
+}
+
+static void record(uint32 value) {
+	// FNV-1a over the individual bytes
+	for (int i = 0; i < 4; ++i) {
+		s_hash ^= (value >> (i * 8)) & 0xFF;
+		s_hash *= 16777619;
+	}
+}
+
+static void recordStep(int step, int action) {
+	record(s_tick);
+	record(CoroScheduler.getCurrentPID());
+	record(step);
+	record(action);
+	s_steps++;
+}
+
+static void processKilled(Common::PROCESS *) {
+	s_live--;
+}
+
+static void workerProc(CORO_PARAM, const void *param);
+
+static void spawnWorker(uint32 &state, bool fixedPid) {
+	if (s_live >= MAX_LIVE)
+		return;
+
+	WorkerParam param;
+	param.seed = nextRandom(state) * 65536 + nextRandom(state);
+	param.loops = 1 + nextRandom(state) % 12;
+
+	if (fixedPid) {
+		uint32 pid = FIXED_PID_BASE + nextRandom(state) % FIXED_PID_RANGE;
+		CoroScheduler.createProcess(pid, &workerProc, &param, sizeof(param));
+	} else {
+		CoroScheduler.createProcess(&workerProc, &param, sizeof(param));
+	}
+
+	s_live++;
+	s_spawned++;
+}
+
+static void waitForEvents(CORO_PARAM, uint32 rnd) {
+	CORO_BEGIN_CONTEXT;
+		uint32 pids[2];
+	CORO_END_CONTEXT(_ctx);
+
+	CORO_BEGIN_CODE(_ctx);
+
+	_ctx->pids[0] = s_staticEvents[rnd % NUM_STATIC_EVENTS];
+	_ctx->pids[1] = s_staticEvents[(rnd / NUM_STATIC_EVENTS) % NUM_STATIC_EVENTS];
+	CORO_INVOKE_ARGS(CoroScheduler.waitForMultipleObjects, (CORO_SUBCTX, 2, _ctx->pids, false, CORO_INFINITE));
+
+	CORO_END_CODE;
+}
+
+static void workerProc(CORO_PARAM, const void *param) {
+	CORO_BEGIN_CONTEXT;
+		uint32 state;
+		uint32 rnd;
+		int step;
+	CORO_END_CONTEXT(_ctx);
+
+	const WorkerParam *p = (const WorkerParam *)param;
+
+	CORO_BEGIN_CODE(_ctx);
+
+	_ctx->state = p->seed;
+
+	for (_ctx->step = 0; _ctx->step < p->loops; ++_ctx->step) {
+		_ctx->rnd = nextRandom(_ctx->state);
+		recordStep(_ctx->step, _ctx->rnd % 10);
+
+		switch (_ctx->rnd % 10) {
+		case 0:
+			CORO_SLEEP(1 + (_ctx->rnd >> 4) % 3);
+			break;
+		case 1:
+			CORO_INVOKE_ARGS(CoroScheduler.waitForSingleObject, (CORO_SUBCTX,
+				s_transientEvents[(_ctx->rnd >> 4) % NUM_TRANSIENT_EVENTS], CORO_INFINITE));
+			break;
+		case 2:
+			CORO_INVOKE_ARGS(CoroScheduler.waitForSingleObject, (CORO_SUBCTX,
+				FIXED_PID_BASE + (_ctx->rnd >> 4) % FIXED_PID_RANGE, CORO_INFINITE));
+			break;
+		case 3:
+			CORO_INVOKE_1(waitForEvents, _ctx->rnd >> 4);
+			break;
+		case 4:
+			CORO_GIVE_WAY;
+			break;
+		case 5:
+			CORO_RESCHEDULE;
+			break;
+		case 6:
+			spawnWorker(_ctx->state, (_ctx->rnd & 0x10) != 0);
+			break;
+		case 7:
+			record(CoroScheduler.killMatchingProcess(FIXED_PID_BASE + (_ctx->rnd >> 4) % FIXED_PID_RANGE));
+			break;
+		case 8:
+			CoroScheduler.setEvent(s_staticEvents[(_ctx->rnd >> 4) % NUM_STATIC_EVENTS]);
+			break;
+		default:
+			CORO_SLEEP(1);
+			break;
+		}
+	}
+
+	CORO_END_CODE;
+}
+
+static void driveTick() {
+	uint32 r = nextRandom(s_rnd);
+
+	// Keep the process table busy
+	for (int i = 0; i < 3; ++i)
+		spawnWorker(s_rnd, (nextRandom(s_rnd) & 1) != 0);
+
+	// Churn the transient events
+	int idx = r % NUM_TRANSIENT_EVENTS;
+	switch ((r >> 6) % 8) {
+	case 0:
+		CoroScheduler.closeEvent(s_transientEvents[idx]);
+		s_transientEvents[idx] = CoroScheduler.createEvent((r & 0x100) != 0, false);
+		break;
+	case 1:
+	case 2:
+		CoroScheduler.setEvent(s_transientEvents[idx]);
+		break;
+	case 3:
+		CoroScheduler.resetEvent(s_transientEvents[idx]);
+		break;
+	case 4:
+		CoroScheduler.pulseEvent(s_transientEvents[idx]);
+		break;
+	case 5:
+		CoroScheduler.setEvent(s_staticEvents[idx % NUM_STATIC_EVENTS]);
+		break;
+	case 6:
+		record(CoroScheduler.killMatchingProcess((FIXED_PID_BASE + idx) & 0x7FFFFFF0, 0x7FFFFFF0));
+		break;
+	default:
+		break;
+	}
+
+	CoroScheduler.schedule();
+	s_tick++;
+}
+
+} // End of namespace CoroutineStress
+
+class CoroutineTestSuite : public CxxTest::TestSuite {
+public:
+	void test_stress_schedule_order() {
+		using namespace CoroutineStress;
+
+		if (!g_system) {
+#if NULL_OSYSTEM_IS_AVAILABLE
+			Common::install_null_g_system();
+#else
+			return;
+#endif
+		}
+
+		s_hash = 2166136261U;
+		s_steps = 0;
+		s_tick = 0;
+		s_rnd = 12345;
+		s_live = 0;
+		s_spawned = 0;
+
+		CoroScheduler.reset();
+		CoroScheduler.setResourceCallback(&processKilled);
+
+		for (int i = 0; i < NUM_STATIC_EVENTS; ++i)
+			s_staticEvents[i] = CoroScheduler.createEvent(i & 1, false);
+		for (int i = 0; i < NUM_TRANSIENT_EVENTS; ++i)
+			s_transientEvents[i] = CoroScheduler.createEvent(i & 1, false);
+
+		for (int i = 0; i < NUM_TICKS; ++i)
+			driveTick();
+
+		record(s_live);
+		record(s_spawned);
+
+		CoroScheduler.setResourceCallback(nullptr);
+		CoroScheduler.reset();
+
+		for (int i = 0; i < NUM_STATIC_EVENTS; ++i)
+			CoroScheduler.closeEvent(s_staticEvents[i]);
+		for (int i = 0; i < NUM_TRANSIENT_EVENTS; ++i)
+			CoroScheduler.closeEvent(s_transientEvents[i]);
+
+		TS_ASSERT_LESS_THAN(1000, s_spawned);
+		TS_ASSERT_LESS_THAN(10000U, s_steps);
+		TS_ASSERT_EQUALS(s_hash, 3299137362U);
+	}
+};
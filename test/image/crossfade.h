@@ -0,0 +1,160 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "graphics/blit.h"
+#include "graphics/surface.h"
+
+class CrossFadeTestSuite : public CxxTest::TestSuite {
+	Graphics::Surface _src1, _src2, _expected, _result;
+
+	// Odd width so that every implementation has to deal with the end of the rows
+	enum {
+		kWidth = 45,
+		kHeight = 7
+	};
+
+	void fillRandom(Graphics::Surface &surf, uint32 &seed) {
+		for (int y = 0; y < surf.h; y++) {
+			uint16 *row = (uint16 *)surf.getBasePtr(0, y);
+			for (int x = 0; x < surf.w; x++) {
+				seed = seed * 1103515245 + 12345;
+				row[x] = (uint16)(seed >> 12);
+			}
+		}
+
+		// Make sure the extreme values are covered
+		*(uint16 *)surf.getBasePtr(0, 0) = 0x0000;
+		*(uint16 *)surf.getBasePtr(1, 0) = 0xFFFF;
+	}
+
+	void setup(const Graphics::PixelFormat &format) {
+		uint32 seed = 1;
+		_src1.create(kWidth, kHeight, format);
+		_src2.create(kWidth, kHeight, format);
+		_expected.create(kWidth, kHeight, format);
+		_result.create(kWidth, kHeight, format);
+		fillRandom(_src1, seed);
+		fillRandom(_src2, seed);
+	}
+
+	void teardown() {
+		_src1.free();
+		_src2.free();
+		_expected.free();
+		_result.free();
+	}
+
+	// The formula used by the Riven blend transition before it was moved to the graphics code
+	void blendReference(uint alpha) {
+		const Graphics::PixelFormat &format = _expected.format;
+		for (int y = 0; y < kHeight; y++) {
+			for (int x = 0; x < kWidth; x++) {
+				uint8 r1, g1, b1, r2, g2, b2;
+				format.colorToRGB(*(const uint16 *)_src1.getBasePtr(x, y), r1, g1, b1);
+				format.colorToRGB(*(const uint16 *)_src2.getBasePtr(x, y), r2, g2, b2);
+
+				uint r = (r1 * alpha + r2 * (255 - alpha)) / 255;
+				uint g = (g1 * alpha + g2 * (255 - alpha)) / 255;
+				uint b = (b1 * alpha + b2 * (255 - alpha)) / 255;
+
+				*(uint16 *)_expected.getBasePtr(x, y) = (uint16)format.RGBToColor(r, g, b);
+			}
+		}
+	}
+
+	bool checkAllAlphas(const char *name) {
+		for (uint alpha = 0; alpha <= 255; alpha++) {
+			blendReference(alpha);
+			Graphics::CrossFade::blend((byte *)_result.getPixels(), (const byte *)_src1.getPixels(), (const byte *)_src2.getPixels(),
+			                           _result.pitch, _src1.pitch, _src2.pitch, kWidth, kHeight, alpha, _result.format);
+
+			for (int y = 0; y < kHeight; y++) {
+				if (memcmp(_expected.getBasePtr(0, y), _result.getBasePtr(0, y), kWidth * 2) != 0) {
+					warning("%s: mismatch with alpha %d on row %d", name, alpha, y);
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	// The destination is allowed to be one of the sources
+	bool checkInPlace(const char *name) {
+		const uint alpha = 100;
+		blendReference(alpha);
+		_result.copyFrom(_src2);
+		Graphics::CrossFade::blend((byte *)_result.getPixels(), (const byte *)_src1.getPixels(), (const byte *)_result.getPixels(),
+		                           _result.pitch, _src1.pitch, _result.pitch, kWidth, kHeight, alpha, _result.format);
+
+		for (int y = 0; y < kHeight; y++) {
+			if (memcmp(_expected.getBasePtr(0, y), _result.getBasePtr(0, y), kWidth * 2) != 0) {
+				warning("%s: in place mismatch on row %d", name, y);
+				return false;
+			}
+		}
+		return true;
+	}
+
+public:
+	void test_blend_rgb565() {
+		setup(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+		Graphics::CrossFade::BlendFunc oldFunc = Graphics::CrossFade::blend565Func;
+
+		Graphics::CrossFade::blend565Func = Graphics::CrossFade::blend565Generic;
+		TS_ASSERT(checkAllAlphas("generic"));
+		TS_ASSERT(checkInPlace("generic"));
+#ifdef SCUMMVM_NEON
+		Graphics::CrossFade::blend565Func = Graphics::CrossFade::blend565NEON;
+		TS_ASSERT(checkAllAlphas("NEON"));
+		TS_ASSERT(checkInPlace("NEON"));
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			Graphics::CrossFade::blend565Func = Graphics::CrossFade::blend565SSE2;
+			TS_ASSERT(checkAllAlphas("SSE2"));
+			TS_ASSERT(checkInPlace("SSE2"));
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			Graphics::CrossFade::blend565Func = Graphics::CrossFade::blend565AVX2;
+			TS_ASSERT(checkAllAlphas("AVX2"));
+			TS_ASSERT(checkInPlace("AVX2"));
+		}
+#endif
+
+		Graphics::CrossFade::blend565Func = oldFunc;
+		teardown();
+	}
+
+	void test_blend_other_format() {
+		setup(Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0));
+		TS_ASSERT(checkAllAlphas("RGB555"));
+		teardown();
+	}
+};